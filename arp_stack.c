@@ -5,8 +5,10 @@
 #include "arp_stack.h"
 #include "router.h"
 #include "global.h"
+#include "log.h"
 #include "ipv4_stack.h"
 #include "ethernet_stack.h"
+#include "neigh.h"
 
 
 /**********************************
@@ -21,8 +23,10 @@ static int chk_valid_handle(const void *hdr, uint16_t len, intf_cfg_t *cfg);
  * \brief Handle an incoming ARP packet.
  * 
  * This function handles incoming ARP packets.
- * Currently on ARP Requests from IPv4 to ethernet are possible.
+ * Currently only ARP packets from IPv4 to ethernet are possible.
  * We do packet sanitization and answer the request if everything is okay.
+ * Both requests and replies update the MAC of a known neighbor.
+ * Called by the slow path. See slow_path.h.
  * 
  * \param cfg The configuration of the interface this packet was received on.
  * \param mbuf The receiver buffer. We need this parameter to reuse the buffer
@@ -30,9 +34,9 @@ static int chk_valid_handle(const void *hdr, uint16_t len, intf_cfg_t *cfg);
  * \param pkt The ARP packet contained in the buffer.
  * \param len The length of the ARP packet.
  * 
- * \return 0 If reply was sent.
+ * \return 0 If reply was sent or the reply was consumed.
  *          Errors: ERR_INV_PKT: Invalid ARP packet received.
- *                  ERR_NOT_IMPL: We do not support this type of requests.
+ *                  ERR_NOT_IMPL: Neither a request nor a reply.
  *                  ERR_NOTFORME: Wrong destination IP address.
  */
 int handle_arp(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
@@ -45,6 +49,12 @@ int handle_arp(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
     if((err = chk_valid_handle(pkt, len, cfg)) < 0)
         return err;
 
+    learn_neigh(cfg, hdr, cfg->intf);
+    if(hdr->arp_op == rte_cpu_to_be_16(ARP_OP_REPLY)) {
+        rte_pktmbuf_free(mbuf);
+        return 0;
+    }
+
     // Handle the packet (We know that this is an ARP request from IPv4 to ETH)
     // hdr is valid and we can use it after this check
 
@@ -54,11 +64,9 @@ int handle_arp(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
     hdr->arp_data.arp_sip = cfg->ip_addr_be;
     hdr->arp_op = rte_cpu_to_be_16(ARP_OP_REPLY);
 
-    #ifdef VERBOSE
-    printf("Sent ARP reply on interface: %d to target with IP: %x\n", 
-            cfg->intf, hdr->arp_data.arp_tip
-    );
-    #endif
+    TRACE_DEBUG(TRC_ARP_REPLY, cfg->intf,
+                rte_be_to_cpu_32(hdr->arp_data.arp_tip), 0);
+    lcore_stats[cfg->lcore].arp_replies++;
 
     // We handled our part -> Ethernet stack has to handle the source and
     // destination MAC
@@ -71,83 +79,63 @@ int handle_arp(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
 /**
  * /brief Check if we can handle this ARP packet and if it is valid.
  * 
- * The function tests if this ARP packet is a request for a ethernet address
- * for a given IPv4 address and if the data is long enough to contain an
- * ARP packet.
+ * The function tests if this ARP packet is a request or reply for a ethernet
+ * address for a given IPv4 address and if the data is long enough to contain
+ * an ARP packet.
  * In addition, we test if the HW address and protocol address lengths are
  * valid for those type of addresses.
  * 
  * \param hdr The header of the ARP packet.
- * \param len The length of the data we have received.
+ * \param len The length of the data we have received. It may include the
+ *              padding of the frame.
  * \param cfg The configuration of the interface this packet was received on.
  * 
  * \return 0 if everything is okay.
  *          Errors: ERR_INV_PKT: Not from IPv4 to ether, invalid
- *                                  address lengths or packet to short/long.
- *                  ERR_NOT_IMPL: ARP operation is not a request.
+ *                                  address lengths or packet to short.
+ *                  ERR_NOT_IMPL: ARP operation is neither a request nor a
+ *                                reply.
  *                  ERR_NOTFORME: IP address does not match the one on
  *                                  this interface.
  */
 static int chk_valid_handle(const void *pkt, uint16_t len, intf_cfg_t *cfg) {
     struct arp_hdr *hdr = (struct arp_hdr *)pkt;
 
-    if(len != ARP_PKT_LEN) {
-        #ifdef VERBOSE
-        printf("ARP packet with an invalid length: 0x%x\n", len);
-        #endif
-
+    // Frames are padded to the Ethernet minimum -> Trailing bytes are fine
+    if(len < ARP_PKT_LEN) {
+        TRACE_DEBUG(TRC_ARP_INV_LEN, len, 0, 0);
         return ERR_INV_PKT;
     }
 
-    if(!(rte_be_to_cpu_16(hdr->arp_op) == ARP_OP_REQUEST)) {
+    if(rte_be_to_cpu_16(hdr->arp_op) != ARP_OP_REQUEST
+        && rte_be_to_cpu_16(hdr->arp_op) != ARP_OP_REPLY) {
         // Can not handle such packets
-        #ifdef VERBOSE
-        printf("Not able to handle this ARP packet. Operation: 0x%x\n", 
-                    rte_be_to_cpu_16(hdr->arp_op)
-                );
-        #endif
+        TRACE_DEBUG(TRC_ARP_NOT_IMPL, rte_be_to_cpu_16(hdr->arp_op), 0, 0);
         return ERR_NOT_IMPL;
     }
 
     if(hdr->arp_data.arp_tip != cfg->ip_addr_be) {
-        #ifdef VERBOSE
-        printf("ARP packet was not sent to this hosts IP: TIP: 0x%x\n", 
-                    hdr->arp_data.arp_tip
-                );
-        #endif
+        TRACE_DEBUG(TRC_ARP_NOTFORME, rte_be_to_cpu_32(hdr->arp_data.arp_tip),
+                    0, 0);
         return ERR_NOTFORME;
     }
 
     if(!(rte_be_to_cpu_16(hdr->arp_hrd) == ARP_HRD_ETHER)) {
         // Can not resolve to this type of address
-        #ifdef VERBOSE
-        printf("Not able to handle this ARP packet."
-                    "Unknown HW address type: 0x%x\n", 
-                    rte_be_to_cpu_16(hdr->arp_hrd)
-                );
-        #endif
+        TRACE_DEBUG(TRC_ARP_INV_HRD, rte_be_to_cpu_16(hdr->arp_hrd), 0, 0);
         return ERR_INV_PKT;
     }
 
     if(!(rte_be_to_cpu_16(hdr->arp_pro) == ETHER_TYPE_IPv4)) {
         // Can not resolve this type of address
-        #ifdef VERBOSE
-        printf("Not able to handle this ARP packet."
-                    "Unknown protocol address type: 0x%x\n", 
-                    rte_be_to_cpu_16(hdr->arp_pro)
-                );
-        #endif
+        TRACE_DEBUG(TRC_ARP_INV_PRO, rte_be_to_cpu_16(hdr->arp_pro), 0, 0);
         return ERR_INV_PKT;
     }
 
     // Okay we are able to resolve this kind of address
     // Quick packet sanitizing
     if(!(hdr->arp_hln == ETHER_ADDR_LEN) || !(hdr->arp_pln == IPv4_ADDR_LEN)) {
-        #ifdef VERBOSE
-        printf("Not able to handle this ARP packet."
-                    "Invalid protocol or HW address length\n"
-                );
-        #endif
+        TRACE_DEBUG(TRC_ARP_INV_ADDR_LEN, hdr->arp_hln, hdr->arp_pln, 0);
         return ERR_INV_PKT;
     }
 
@@ -0,0 +1,800 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_arp.h>
+#include <rte_cycles.h>
+#include <rte_eth_ring.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_ring.h>
+#include <rte_udp.h>
+
+#include "bench.h"
+#include "dpdk_init.h"
+#include "ethernet_stack.h"
+#include "routing_table_additional.h"
+#include "stats.h"
+#include "global.h"
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static int parse_bench_value(const char *key, const char *val);
+static int build_flows(void);
+static void build_ipv4(bench_gen_t *gen, struct rte_mbuf *mbuf, uint64_t r,
+                        bool invalid);
+static void build_arp(bench_gen_t *gen, struct rte_mbuf *mbuf);
+static int generator_thread(void *arg);
+static int sink_thread(void *arg);
+static uint16_t drain_tx_rings(uint8_t intf, const struct ether_addr *own,
+                                bench_stats_t *stats);
+static void sum_bench(bench_stats_t *sum);
+static void report_workers(FILE *out, double secs);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+bench_stats_t bench_stats[RTE_MAX_LCORE];
+
+// The benchmark definition
+static bool enabled = false;
+static bench_dst_t dst_mode = BENCH_DST_ROUTES;
+static uint32_t no_flows = BENCH_DEF_FLOWS;
+static uint16_t frame_size = BENCH_DEF_SIZE; // 0: IMIX
+static uint8_t invalid_pct = 0, arp_pct = 0;
+static uint32_t duration_s = 0; // 0: Until the router is stopped
+
+// Rings of every port: The RX rings followed by the TX rings
+static struct rte_ring **port_rings[RTE_MAX_ETHPORTS];
+static uint16_t no_port_rx[RTE_MAX_ETHPORTS], no_port_tx[RTE_MAX_ETHPORTS];
+static uint no_ports = 0;
+
+// Destinations of the generated packets in big endian format
+static uint32_t *flows = NULL;
+
+// One generator and one sink per interface
+static bench_gen_t gens[RTE_MAX_ETHPORTS];
+static uint16_t gen_lcores[RTE_MAX_ETHPORTS], sink_lcores[RTE_MAX_ETHPORTS];
+static uint no_gens = 0;
+static volatile bool gens_running = false, sinks_running = false;
+
+// The workers whose rates are reported
+static uint16_t workers[RTE_MAX_LCORE];
+static uint no_workers = 0;
+
+// State of the last report
+static bench_stats_t last_sum;
+static uint64_t last_rx[RTE_MAX_LCORE];
+static uint64_t last_drops[RTE_MAX_LCORE][NO_DROP_REASONS];
+static uint64_t start_tsc = 0, stop_tsc = 0, end_tsc = 0, last_report = 0;
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Get the next number of a xorshift generator.
+ */
+static inline uint64_t bench_rand(uint64_t *state)
+{
+    uint64_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Parse the benchmark definition and enable the benchmark mode.
+ *
+ * Format: default|<key>=<value>[,<key>=<value>]*
+ * dst=routes|uniform, flows=<n>, size=<bytes>|imix, invalid=<percent>,
+ * arp=<percent>, time=<seconds>
+ *
+ * \param def The definition. It is modified.
+ *
+ * \return 0 if we could parse the definition.
+ *          Errors: ERR_FORMAT
+ */
+int parse_bench(char *def)
+{
+    char *key = NULL, *val = NULL, *save = NULL;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+    if(strcmp(def, "default") == 0) {
+        enabled = true;
+        return 0;
+    }
+
+    for(key = strtok_r(def, ",", &save); key != NULL;
+            key = strtok_r(NULL, ",", &save)) {
+        if((val = strchr(key, '=')) == NULL)
+            return ERR_FORMAT;
+        *val++ = '\0';
+        if(parse_bench_value(key, val) < 0)
+            return ERR_FORMAT;
+    }
+
+    if(invalid_pct + arp_pct > 100)
+        return ERR_FORMAT;
+    enabled = true;
+    return 0;
+}
+
+/**
+ * \brief Check if the router runs a benchmark.
+ */
+bool bench_enabled(void)
+{
+    return enabled;
+}
+
+/**
+ * \brief Get the number of lcores the benchmark needs besides the router.
+ */
+uint get_bench_lcores(uint no_intf)
+{
+    return enabled ? 2 * no_intf : 0;
+}
+
+/**
+ * \brief Create the ring ports of the benchmark.
+ *
+ * The ports get the IDs 0..no_ports - 1. Every queue is a single producer,
+ * single consumer ring: An RX ring is filled by the generator and read by
+ * one worker, a TX ring is filled by one lcore of the router and drained
+ * by the sink.
+ *
+ * \param no_ports Number of ports.
+ * \param no_rx RX queues per port.
+ * \param no_tx TX queues per port.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_CFG: Another device already took a port ID.
+ */
+int create_bench_ports(uint no_ports_, uint16_t no_rx, uint16_t no_tx)
+{
+    char name[RTE_RING_NAMESIZE];
+    const int socket = (int)rte_socket_id();
+    struct rte_ring **rings = NULL;
+    struct ether_addr mac = {{ 0x02, 0, 0, 0, 0, 0 }};
+
+    for(uint port = 0; port < no_ports_; ++port) {
+        if((rings = calloc(no_rx + no_tx, sizeof(*rings))) == NULL)
+            return ERR_MEM;
+        port_rings[port] = rings;
+        no_port_rx[port] = no_rx;
+        no_port_tx[port] = no_tx;
+        no_ports = port + 1;
+
+        for(uint q = 0; q < (uint)no_rx + no_tx; ++q) {
+            snprintf(name, sizeof(name), "bench_%s%u_%u",
+                        q < no_rx ? "rx" : "tx", port,
+                        q < no_rx ? q : q - no_rx);
+            if((rings[q] = rte_ring_create(name, BENCH_RING_SIZE, socket,
+                                        RING_F_SP_ENQ | RING_F_SC_DEQ)) == NULL)
+                return ERR_MEM;
+        }
+
+        snprintf(name, sizeof(name), "bench%u", port);
+        if(rte_eth_from_rings(name, rings, no_rx, rings + no_rx, no_tx,
+                                socket) != (int)port) {
+            printf("Cannot create ring port %u!\n", port);
+            return ERR_CFG;
+        }
+        // The ring PMD cannot set its MAC and leaves it 0 -> Distinct MACs
+        mac.addr_bytes[5] = (uint8_t)port;
+        ether_addr_copy(&mac, rte_eth_devices[port].data->mac_addrs);
+    }
+    return 0;
+}
+
+/**
+ * \brief Take the frames the router sent on a ring port.
+ *
+ * The TX rings are drained in the order of their queues. Must not be used
+ * while the sink of the port runs.
+ *
+ * \param port The port.
+ * \param mbufs Buffer for the frames.
+ * \param n Size of the buffer.
+ *
+ * \return Number of frames taken.
+ */
+uint16_t drain_bench_port(uint8_t port, struct rte_mbuf **mbufs, uint16_t n)
+{
+    struct rte_ring **rings = NULL;
+    uint16_t sum = 0;
+
+    if(port >= no_ports)
+        return 0;
+    rings = port_rings[port] + no_port_rx[port];
+    for(uint16_t q = 0; q < no_port_tx[port] && sum < n; ++q)
+        sum += rte_ring_sc_dequeue_burst(rings[q], (void **)(mbufs + sum),
+                                            n - sum, NULL);
+    return sum;
+}
+
+/**
+ * \brief Launch a generator and a sink for every interface.
+ *
+ * \param lcores Free lcores: Two per interface.
+ * \param no_lcores Number of lcores.
+ * \param worker_lcores The lcores of the workers. Their rates are reported.
+ * \param no_workers_ Number of workers.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_CFG: Not enough lcores.
+ *                  ERR_MEM: Not enough memory.
+ *                  ERR_START: Cannot launch an lcore.
+ */
+int start_bench(const uint16_t *lcores, uint no_lcores,
+                const uint16_t *worker_lcores, uint no_workers_)
+{
+    intf_cfg_t *intf = NULL;
+    int err = 0;
+
+    no_workers = RTE_MIN(no_workers_, (uint)RTE_MAX_LCORE);
+    memcpy(workers, worker_lcores, no_workers * sizeof(uint16_t));
+    sinks_running = gens_running = true;
+
+    for(intf = intf_cfgs; intf != NULL; intf = intf->nxt, ++no_gens) {
+        if(2 * no_gens + 1 >= no_lcores) {
+            printf("Not enough lcores for the benchmark!\n");
+            return ERR_CFG;
+        }
+        if((err = init_bench_gen(&gens[no_gens], intf->intf,
+                                    no_gens + 1)) < 0)
+            return err;
+
+        gen_lcores[no_gens] = lcores[2 * no_gens];
+        sink_lcores[no_gens] = lcores[2 * no_gens + 1];
+        if(
+            rte_eal_remote_launch(sink_thread, &gens[no_gens],
+                                    sink_lcores[no_gens]) < 0
+            || rte_eal_remote_launch(generator_thread, &gens[no_gens],
+                                        gen_lcores[no_gens]) < 0
+        ) {
+            printf("Cannot launch the benchmark lcores of interface %u\n",
+                    intf->intf);
+            return ERR_START;
+        }
+        printf("Starting the benchmark generator of interface %u on lcore %u "
+                "and its sink on lcore %u\n", intf->intf, gen_lcores[no_gens],
+                sink_lcores[no_gens]);
+    }
+
+    start_tsc = rte_rdtsc();
+    end_tsc = duration_s > 0 ? start_tsc + duration_s * rte_get_tsc_hz() : 0;
+    report_bench(NULL); // Start of the first interval
+    return 0;
+}
+
+/**
+ * \brief Get the TSC at which the benchmark ends.
+ *
+ * \return The TSC or 0 if the benchmark runs until the router is stopped.
+ */
+uint64_t get_bench_end(void)
+{
+    return end_tsc;
+}
+
+/**
+ * \brief Print the rates of the generators, the sinks and every worker.
+ *
+ * \param out The stream of the report. NULL to only remember the counters.
+ */
+void report_bench(FILE *out)
+{
+    const uint64_t now = rte_rdtsc();
+    bench_stats_t sum;
+    double secs = 0;
+
+    sum_bench(&sum);
+    if(out != NULL && last_report != 0 && now > last_report) {
+        secs = (double)(now - last_report) / rte_get_tsc_hz();
+        fprintf(out, "Bench: offered %.3f Mpps, RX rings full %.0f/s, "
+                        "sent %.3f Mpps %.2f Gbit/s, valid %.3f Mpps, "
+                        "corrupt %.0f/s, router-originated %.0f/s\n",
+                    (sum.gen_pkts - last_sum.gen_pkts) / secs / 1e6,
+                    (sum.gen_full - last_sum.gen_full) / secs,
+                    (sum.sink_pkts - last_sum.sink_pkts) / secs / 1e6,
+                    (sum.sink_bytes - last_sum.sink_bytes) * 8 / secs / 1e9,
+                    (sum.sink_valid - last_sum.sink_valid) / secs / 1e6,
+                    (sum.sink_corrupt - last_sum.sink_corrupt) / secs,
+                    (sum.sink_other - last_sum.sink_other) / secs);
+    }
+    report_workers(out, secs);
+    last_sum = sum;
+    last_report = now;
+}
+
+/**
+ * \brief Stop all generators and wait until they returned.
+ */
+void stop_generators(void)
+{
+    gens_running = false;
+    for(uint i = 0; i < no_gens; ++i)
+        rte_eal_wait_lcore(gen_lcores[i]);
+    stop_tsc = rte_rdtsc();
+}
+
+/**
+ * \brief Stop the sinks and print the result of the benchmark.
+ *
+ * The router must not send frames anymore -> The sinks count all of them.
+ *
+ * \return 0 if all forwarded frames passed the checks.
+ *          Errors: ERR_MISMATCH: The router forwarded corrupt frames.
+ */
+int stop_bench(void)
+{
+    bench_stats_t sum;
+    double secs = 0;
+
+    sinks_running = false;
+    for(uint i = 0; i < no_gens; ++i)
+        rte_eal_wait_lcore(sink_lcores[i]);
+
+    sum_bench(&sum);
+    secs = (double)(stop_tsc - start_tsc) / rte_get_tsc_hz();
+    printf("Bench result: %.1f s, offered %.3f Mpps, sent %.3f Mpps, "
+            "valid %.3f Mpps, %"PRIu64" corrupt frames\n", secs,
+            secs > 0 ? sum.gen_pkts / secs / 1e6 : 0.0,
+            secs > 0 ? sum.sink_pkts / secs / 1e6 : 0.0,
+            secs > 0 ? sum.sink_valid / secs / 1e6 : 0.0, sum.sink_corrupt);
+    return sum.sink_corrupt > 0 ? ERR_MISMATCH : 0;
+}
+
+/**
+ * \brief Close the ring ports and free all memory of the benchmark.
+ *
+ * No lcore may use the ports anymore.
+ */
+void free_bench(void)
+{
+    for(uint port = 0; port < no_ports; ++port) {
+        rte_eth_dev_stop(port);
+        rte_eth_dev_close(port);
+        for(uint q = 0; port_rings[port] != NULL
+                        && q < (uint)no_port_rx[port] + no_port_tx[port]; ++q)
+            rte_ring_free(port_rings[port][q]);
+        free(port_rings[port]);
+        port_rings[port] = NULL;
+    }
+    no_ports = 0;
+    free(flows);
+    flows = NULL;
+}
+
+/**
+ * \brief Initialize the generator of an interface.
+ *
+ * The destinations of all generators are drawn once from the routes.
+ *
+ * \param gen The generator.
+ * \param intf The interface. Must have an interface configuration.
+ * \param seed Seed of the random numbers. Not 0.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_CFG: The interface is not configured.
+ *                  ERR_MEM: Not enough memory.
+ */
+int init_bench_gen(bench_gen_t *gen, uint8_t intf, uint64_t seed)
+{
+    const intf_cfg_t *cfg = intf_cfgs;
+
+    while(cfg != NULL && cfg->intf != intf)
+        cfg = cfg->nxt;
+    if(cfg == NULL)
+        return ERR_CFG;
+    if(flows == NULL && build_flows() < 0)
+        return ERR_MEM;
+
+    memset(gen, 0, sizeof(bench_gen_t));
+    gen->intf = intf;
+    gen->s_ether.addr_bytes[0] = 0x02;
+    gen->s_ether.addr_bytes[4] = 0x01;
+    gen->s_ether.addr_bytes[5] = intf;
+    rte_eth_macaddr_get(intf, &gen->d_ether);
+    gen->src_ip = BENCH_SRC_NET | (uint32_t)intf << 8 | 1;
+    gen->router_ip_be = cfg->ip_addr_be;
+    gen->pool = get_socket_mempool(rte_eth_dev_socket_id(intf), true);
+    gen->rings = port_rings[intf];
+    gen->no_rings = no_port_rx[intf];
+    gen->seed = seed;
+    return 0;
+}
+
+/**
+ * \brief Synthesize a burst of frames to the router.
+ *
+ * \param gen The generator.
+ * \param mbufs Buffer for the frames.
+ * \param n Number of frames.
+ *
+ * \return n or 0 if the mempool is exhausted.
+ */
+uint16_t generate_frames(bench_gen_t *gen, struct rte_mbuf **mbufs,
+                            uint16_t n)
+{
+    uint64_t r = 0;
+    uint32_t pct = 0;
+
+    if(rte_pktmbuf_alloc_bulk(gen->pool, mbufs, n) != 0)
+        return 0;
+
+    for(uint16_t i = 0; i < n; ++i) {
+        r = bench_rand(&gen->seed);
+        pct = (uint32_t)(r >> 32) % 100;
+        if(pct < arp_pct)
+            build_arp(gen, mbufs[i]);
+        else
+            build_ipv4(gen, mbufs[i], r, pct < arp_pct + invalid_pct);
+    }
+    return n;
+}
+
+/**
+ * \brief Count and verify frames the router sent on an interface.
+ *
+ * A generated frame passed the checks if it left with the MAC of the
+ * interface, a decremented TTL and a valid header checksum.
+ *
+ * \param own The MAC of the interface.
+ * \param mbufs The frames.
+ * \param n Number of frames.
+ * \param stats The counters of the sink.
+ */
+void check_frames(const struct ether_addr *own, struct rte_mbuf **mbufs,
+                    uint16_t n, bench_stats_t *stats)
+{
+    const uint16_t min_len = ETHER_HDR_LEN + sizeof(struct ipv4_hdr)
+                                + sizeof(struct udp_hdr) + sizeof(bench_tag_t);
+    const struct ether_hdr *eth = NULL;
+    const struct ipv4_hdr *ip = NULL;
+    const bench_tag_t *tag = NULL;
+    uint16_t len = 0;
+
+    for(uint16_t i = 0; i < n; ++i) {
+        len = rte_pktmbuf_data_len(mbufs[i]);
+        eth = rte_pktmbuf_mtod(mbufs[i], const struct ether_hdr *);
+        ip = (const struct ipv4_hdr *)(eth + 1);
+        tag = (const bench_tag_t *)((const uint8_t *)(ip + 1)
+                                    + sizeof(struct udp_hdr));
+        stats->sink_pkts++;
+        stats->sink_bytes += len + ETHER_CRC_LEN;
+
+        if(len < min_len || eth->ether_type != rte_cpu_to_be_16(ETHER_TYPE_IPv4)
+            || ip->next_proto_id != IPPROTO_UDP || tag->magic != BENCH_MAGIC) {
+            stats->sink_other++;
+            continue;
+        }
+        if(!is_same_ether_addr(&eth->s_addr, own) || ip->version_ihl != 0x45
+            || ip->time_to_live != BENCH_TTL - 1
+            || rte_raw_cksum(ip, sizeof(struct ipv4_hdr)) != 0xFFFF)
+            stats->sink_corrupt++;
+        else
+            stats->sink_valid++;
+    }
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Parse a single <key>=<value> pair of the benchmark definition.
+ *
+ * \return 0 if we could parse the pair.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_bench_value(const char *key, const char *val)
+{
+    char *tmp = NULL;
+    long ltmp = 0;
+
+    if(strcmp(key, "dst") == 0) {
+        if(strcmp(val, "routes") == 0)
+            dst_mode = BENCH_DST_ROUTES;
+        else if(strcmp(val, "uniform") == 0)
+            dst_mode = BENCH_DST_UNIFORM;
+        else
+            return ERR_FORMAT;
+        return 0;
+    }
+    if(strcmp(key, "size") == 0 && strcmp(val, "imix") == 0) {
+        frame_size = 0;
+        return 0;
+    }
+
+    ltmp = strtol(val, &tmp, 10);
+    if(*tmp != '\0' || val == tmp || ltmp < 0)
+        return ERR_FORMAT;
+
+    if(strcmp(key, "flows") == 0 && ltmp >= 1 && ltmp <= BENCH_MAX_FLOWS)
+        no_flows = (uint32_t)ltmp;
+    else if(strcmp(key, "size") == 0 && ltmp >= ETHER_MIN_LEN
+            && ltmp <= ETHER_MAX_LEN)
+        frame_size = (uint16_t)ltmp;
+    else if(strcmp(key, "invalid") == 0 && ltmp <= 100)
+        invalid_pct = (uint8_t)ltmp;
+    else if(strcmp(key, "arp") == 0 && ltmp <= 100)
+        arp_pct = (uint8_t)ltmp;
+    else if(strcmp(key, "time") == 0 && ltmp <= INT32_MAX)
+        duration_s = (uint32_t)ltmp;
+    else
+        return ERR_FORMAT;
+    return 0;
+}
+
+/**
+ * \brief Draw the destinations of the generated packets.
+ *
+ * dst=routes: A random host in the network of a random route. Without
+ * routes, the destinations are uniformly random.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int build_flows(void)
+{
+    uint32_t *nets = NULL, mask = 0;
+    uint8_t *prfs = NULL;
+    uint no_nets = 0, net = 0;
+    uint64_t state = 42, r = 0;
+
+    if((flows = malloc(no_flows * sizeof(uint32_t))) == NULL)
+        return ERR_MEM;
+
+    if(dst_mode == BENCH_DST_ROUTES && (no_nets = get_no_routes()) > 0) {
+        if(
+            (nets = malloc(no_nets * sizeof(uint32_t))) == NULL
+            || (prfs = malloc(no_nets)) == NULL
+        ) {
+            free(nets);
+            free(flows);
+            flows = NULL;
+            return ERR_MEM;
+        }
+        no_nets = get_route_nets(nets, prfs, no_nets);
+    }
+
+    for(uint32_t i = 0; i < no_flows; ++i) {
+        r = bench_rand(&state);
+        if(no_nets == 0) {
+            flows[i] = rte_cpu_to_be_32((uint32_t)r);
+            continue;
+        }
+        net = (uint)(r % no_nets);
+        mask = prfs[net] > 0 ? ~UINT32_C(0) << (32 - prfs[net]) : 0;
+        flows[i] = rte_cpu_to_be_32(nets[net] | ((uint32_t)(r >> 32) & ~mask));
+    }
+
+    free(nets);
+    free(prfs);
+    return 0;
+}
+
+/**
+ * \brief Write a UDP packet to a flow into a buffer.
+ *
+ * Invalid packets have a wrong checksum, IHL or total length.
+ *
+ * \param r A random number choosing the flow, the size and the defect.
+ */
+static void build_ipv4(bench_gen_t *gen, struct rte_mbuf *mbuf, uint64_t r,
+                        bool invalid)
+{
+    uint16_t size = frame_size, len = 0;
+    struct ether_hdr *eth = NULL;
+    struct ipv4_hdr *ip = NULL;
+    struct udp_hdr *udp = NULL;
+    bench_tag_t *tag = NULL;
+
+    if(size == 0) { // IMIX: 7 small, 4 medium and 1 large frame
+        size = (r >> 8) % 12;
+        size = size < 7 ? BENCH_IMIX_SMALL :
+                size < 11 ? BENCH_IMIX_MEDIUM : BENCH_IMIX_LARGE;
+    }
+    len = size - ETHER_CRC_LEN;
+
+    // The buffer is fresh from the pool -> Its data room is empty
+    mbuf->data_len = mbuf->pkt_len = len;
+    eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    ip = (struct ipv4_hdr *)(eth + 1);
+    udp = (struct udp_hdr *)(ip + 1);
+    tag = (bench_tag_t *)(udp + 1);
+
+    ether_addr_copy(&gen->d_ether, &eth->d_addr);
+    ether_addr_copy(&gen->s_ether, &eth->s_addr);
+    eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+
+    ip->version_ihl = 0x45;
+    ip->type_of_service = 0;
+    ip->total_length = rte_cpu_to_be_16(len - ETHER_HDR_LEN);
+    ip->packet_id = 0;
+    ip->fragment_offset = 0;
+    ip->time_to_live = BENCH_TTL;
+    ip->next_proto_id = IPPROTO_UDP;
+    ip->hdr_checksum = 0;
+    ip->src_addr = rte_cpu_to_be_32(gen->src_ip);
+    ip->dst_addr = flows[(r >> 16) % no_flows];
+
+    udp->src_port = rte_cpu_to_be_16(BENCH_UDP_PORT + (r & 0xFF));
+    udp->dst_port = rte_cpu_to_be_16(BENCH_UDP_PORT);
+    udp->dgram_len = rte_cpu_to_be_16(len - ETHER_HDR_LEN
+                                        - sizeof(struct ipv4_hdr));
+    udp->dgram_cksum = 0;
+    tag->magic = BENCH_MAGIC;
+    tag->intf = gen->intf;
+
+    if(invalid && (r & 3) == 1)
+        ip->version_ihl = 0x44;
+    else if(invalid && (r & 3) == 2)
+        ip->total_length = rte_cpu_to_be_16(len);
+    ip->hdr_checksum = rte_ipv4_cksum(ip);
+    if(invalid && (r & 3) != 1 && (r & 3) != 2)
+        ip->hdr_checksum ^= 0xFFFF;
+}
+
+/**
+ * \brief Write an ARP request for the router's address into a buffer.
+ */
+static void build_arp(bench_gen_t *gen, struct rte_mbuf *mbuf)
+{
+    struct ether_hdr *eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    struct arp_hdr *arp = (struct arp_hdr *)(eth + 1);
+
+    // Padded to the minimum frame size as a host sends it
+    mbuf->data_len = mbuf->pkt_len = ETHER_MIN_LEN - ETHER_CRC_LEN;
+    memset(eth, 0, ETHER_MIN_LEN - ETHER_CRC_LEN);
+    memset(&eth->d_addr, 0xFF, ETHER_ADDR_LEN);
+    ether_addr_copy(&gen->s_ether, &eth->s_addr);
+    eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_ARP);
+
+    arp->arp_hrd = rte_cpu_to_be_16(ARP_HRD_ETHER);
+    arp->arp_pro = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+    arp->arp_hln = ETHER_ADDR_LEN;
+    arp->arp_pln = sizeof(uint32_t);
+    arp->arp_op = rte_cpu_to_be_16(ARP_OP_REQUEST);
+    ether_addr_copy(&gen->s_ether, &arp->arp_data.arp_sha);
+    arp->arp_data.arp_sip = rte_cpu_to_be_32(gen->src_ip);
+    arp->arp_data.arp_tip = gen->router_ip_be;
+}
+
+/**
+ * \brief Main loop of a generator lcore.
+ *
+ * Frames that find the RX ring full are dropped like a NIC drops them.
+ *
+ * \param arg The bench_gen_t of the interface.
+ */
+static int generator_thread(void *arg)
+{
+    bench_gen_t *gen = (bench_gen_t *)arg;
+    bench_stats_t *stats = &bench_stats[rte_lcore_id()];
+    struct rte_mbuf *mbufs[BENCH_BURST];
+    uint16_t n = 0, sent = 0, ring = 0;
+
+    while(gens_running && gen->no_rings > 0) {
+        // An exhausted pool is refilled by the router and the sinks
+        if((n = generate_frames(gen, mbufs, BENCH_BURST)) == 0)
+            continue;
+
+        sent = rte_ring_sp_enqueue_burst(gen->rings[ring], (void **)mbufs,
+                                            n, NULL);
+        if(++ring == gen->no_rings)
+            ring = 0;
+        stats->gen_pkts += sent;
+        stats->gen_full += n - sent;
+        drop_frames(mbufs + sent, n - sent);
+    }
+    return 0;
+}
+
+/**
+ * \brief Main loop of a sink lcore.
+ *
+ * Drains the TX rings of the interface until the sinks are stopped and once
+ * more afterwards -> Every frame the router sent is counted.
+ *
+ * \param arg The bench_gen_t of the interface.
+ */
+static int sink_thread(void *arg)
+{
+    const uint8_t intf = ((const bench_gen_t *)arg)->intf;
+    bench_stats_t *stats = &bench_stats[rte_lcore_id()];
+    struct ether_addr own;
+
+    rte_eth_macaddr_get(intf, &own);
+    while(sinks_running)
+        drain_tx_rings(intf, &own, stats);
+    while(drain_tx_rings(intf, &own, stats) > 0)
+        ;
+    return 0;
+}
+
+/**
+ * \brief Take one burst from every TX ring of an interface.
+ *
+ * \return Number of frames taken.
+ */
+static uint16_t drain_tx_rings(uint8_t intf, const struct ether_addr *own,
+                                bench_stats_t *stats)
+{
+    struct rte_ring **rings = port_rings[intf] + no_port_rx[intf];
+    struct rte_mbuf *mbufs[BENCH_BURST];
+    uint16_t n = 0, sum = 0;
+
+    for(uint16_t q = 0; q < no_port_tx[intf]; ++q) {
+        n = rte_ring_sc_dequeue_burst(rings[q], (void **)mbufs, BENCH_BURST,
+                                        NULL);
+        check_frames(own, mbufs, n, stats);
+        drop_frames(mbufs, n);
+        sum += n;
+    }
+    return sum;
+}
+
+/**
+ * \brief Sum up the counters of all generators and sinks.
+ */
+static void sum_bench(bench_stats_t *sum)
+{
+    memset(sum, 0, sizeof(bench_stats_t));
+    for(uint lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        sum->gen_pkts += bench_stats[lcore].gen_pkts;
+        sum->gen_full += bench_stats[lcore].gen_full;
+        sum->sink_pkts += bench_stats[lcore].sink_pkts;
+        sum->sink_bytes += bench_stats[lcore].sink_bytes;
+        sum->sink_valid += bench_stats[lcore].sink_valid;
+        sum->sink_corrupt += bench_stats[lcore].sink_corrupt;
+        sum->sink_other += bench_stats[lcore].sink_other;
+    }
+}
+
+/**
+ * \brief Print the receive rate and the drop reasons of every worker.
+ *
+ * \param out The stream of the report. NULL to only remember the counters.
+ * \param secs Seconds since the last report.
+ */
+static void report_workers(FILE *out, double secs)
+{
+    const lcore_stats_t *stats = NULL;
+    uint64_t rx = 0, drops = 0;
+    uint16_t lcore = 0;
+
+    for(uint i = 0; i < no_workers; ++i) {
+        lcore = workers[i];
+        stats = &lcore_stats[lcore];
+        rx = 0;
+        for(uint port = 0; port < no_ports; ++port)
+            rx += stats->ports[port].rx_pkts;
+
+        if(out != NULL && secs > 0)
+            fprintf(out, "Worker lcore %u: %.3f Mpps", lcore,
+                    (rx - last_rx[lcore]) / secs / 1e6);
+        last_rx[lcore] = rx;
+
+        for(unsigned reason = 0; reason < NO_DROP_REASONS; ++reason) {
+            drops = stats->drops[reason];
+            if(out != NULL && secs > 0 && drops != last_drops[lcore][reason])
+                fprintf(out, ", %s %.0f/s", get_drop_name(reason),
+                        (drops - last_drops[lcore][reason]) / secs);
+            last_drops[lcore][reason] = drops;
+        }
+        if(out != NULL && secs > 0)
+            fputc('\n', out);
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * This file contains the benchmark mode: The router forwards synthetic
+ * traffic without NICs.
+ *
+ * Every interface of the router is a ring port (net_ring) whose queues are
+ * rings in memory. A generator lcore per interface synthesizes IPv4 and ARP
+ * frames into the RX rings of the interface. A sink lcore per interface
+ * drains its TX rings, counts the frames and verifies the forwarded ones.
+ * The master reports the rates of the generators, the sinks and every
+ * worker. A benchmark with a duration stops the router at its end.
+ */
+#ifndef BENCH_H__
+#define BENCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <rte_config.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+
+#include "router.h"
+
+// Frames a generator or sink moves per ring operation
+#define BENCH_BURST THREAD_BUFSIZE
+// Slots of the rings of the ports. As many as the descriptors of a NIC.
+#define BENCH_RING_SIZE 256
+// Defaults of the benchmark definition
+#define BENCH_DEF_FLOWS 1024
+#define BENCH_DEF_SIZE 64
+#define BENCH_MAX_FLOWS (1 << 20)
+// Memory of DPDK without huge pages
+#define BENCH_MEM_MB "1024"
+// Time the workers get to forward the last generated frames
+#define BENCH_DRAIN_MS 100
+// Marks the payload of generated frames
+#define BENCH_MAGIC 0x42454e43
+// Sources of the generated packets: 198.18.0.0/15 (RFC 2544)
+#define BENCH_SRC_NET IPv4(198, 18, 0, 0)
+// TTL and UDP destination port of the generated packets
+#define BENCH_TTL 64
+#define BENCH_UDP_PORT 9
+// Frame sizes of IMIX (with FCS). Weighted 7:4:1.
+#define BENCH_IMIX_SMALL 64
+#define BENCH_IMIX_MEDIUM 570
+#define BENCH_IMIX_LARGE 1518
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+typedef enum bench_dst {
+    BENCH_DST_ROUTES, // Hosts in the networks of the routes
+    BENCH_DST_UNIFORM // Uniformly random addresses
+} bench_dst_t;
+
+/*
+ * The payload of the generated packets right behind the UDP header.
+ */
+typedef struct bench_tag {
+    uint32_t magic;
+    uint8_t intf; // Ingress interface
+    uint8_t pad[3];
+} bench_tag_t;
+
+typedef struct bench_gen {
+    uint8_t intf;
+    struct ether_addr s_ether; // MAC of the emulated host
+    struct ether_addr d_ether; // MAC of the router's interface
+    uint32_t src_ip; // Of the emulated host, little endian format
+    uint32_t router_ip_be;
+    struct rte_mempool *pool;
+    struct rte_ring **rings; // RX rings of the interface
+    uint16_t no_rings;
+    uint64_t seed;
+} bench_gen_t;
+
+typedef struct bench_stats {
+    uint64_t gen_pkts; // Frames handed to the router
+    uint64_t gen_full; // Frames dropped because the RX rings were full
+    uint64_t sink_pkts; // Frames sent by the router
+    uint64_t sink_bytes;
+    uint64_t sink_valid; // Forwarded generated frames that passed the checks
+    uint64_t sink_corrupt; // Generated frames forwarded with wrong headers
+    uint64_t sink_other; // Frames the router originated: ARP, ICMP
+} __rte_cache_aligned bench_stats_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int parse_bench(char *def);
+bool bench_enabled(void);
+uint get_bench_lcores(uint no_intf);
+int create_bench_ports(uint no_ports, uint16_t no_rx, uint16_t no_tx);
+uint16_t drain_bench_port(uint8_t port, struct rte_mbuf **mbufs, uint16_t n);
+int start_bench(const uint16_t *lcores, uint no_lcores,
+                const uint16_t *worker_lcores, uint no_workers);
+uint64_t get_bench_end(void);
+void report_bench(FILE *out);
+void stop_generators(void);
+int stop_bench(void);
+void free_bench(void);
+int init_bench_gen(bench_gen_t *gen, uint8_t intf, uint64_t seed);
+uint16_t generate_frames(bench_gen_t *gen, struct rte_mbuf **mbufs,
+                            uint16_t n);
+void check_frames(const struct ether_addr *own, struct rte_mbuf **mbufs,
+                    uint16_t n, bench_stats_t *stats);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern bench_stats_t bench_stats[RTE_MAX_LCORE];
+
+#endif
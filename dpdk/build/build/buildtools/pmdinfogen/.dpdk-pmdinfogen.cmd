@@ -0,0 +1 @@
+cmd_dpdk-pmdinfogen = gcc    -o dpdk-pmdinfogen pmdinfogen.o  
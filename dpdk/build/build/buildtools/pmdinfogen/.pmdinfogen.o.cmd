@@ -0,0 +1 @@
+cmd_pmdinfogen.o = gcc -Wp,-MD,./.pmdinfogen.o.d.tmp  -W -Wall -Wstrict-prototypes -Wmissing-prototypes -Wmissing-declarations -Wold-style-definition -Wpointer-arith -Wcast-align -Wnested-externs -Wcast-qual -Wformat-nonliteral -Wformat-security -Wundef -Wwrite-strings -Wimplicit-fallthrough=2 -Wno-format-truncation -g -I/root/repo/dpdk/build/include    -o pmdinfogen.o -c /root/repo/dpdk/buildtools/pmdinfogen/pmdinfogen.c 
@@ -0,0 +1 @@
+cmd_librte_pmd_null_crypto.a = ar crDs librte_pmd_null_crypto.a null_crypto_pmd.o null_crypto_pmd_ops.o 
@@ -0,0 +1 @@
+const char crypto_null_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"crypto_null\", \"params\" : \"max_nb_queue_pairs=<int> max_nb_sessions=<int> socket_id=<int>\", \"pci_ids\" : []}";
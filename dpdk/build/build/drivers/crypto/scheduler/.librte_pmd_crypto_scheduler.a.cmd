@@ -0,0 +1 @@
+cmd_librte_pmd_crypto_scheduler.a = ar crDs librte_pmd_crypto_scheduler.a scheduler_pmd.o scheduler_pmd_ops.o rte_cryptodev_scheduler.o scheduler_roundrobin.o scheduler_pkt_size_distr.o scheduler_failover.o scheduler_multicore.o 
@@ -0,0 +1 @@
+cmd_librte_pmd_octeontx_ssovf.a = ar crDs librte_pmd_octeontx_ssovf.a ssovf_worker.o ssovf_evdev.o ssovf_probe.o ssovf_mbox.o 
@@ -0,0 +1 @@
+const char event_octeontx_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"event_octeontx\", \"pci_ids\" : []}";
@@ -0,0 +1,2 @@
+const char octeontx_ssovf_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"octeontx_ssovf\", \"pci_ids\" : []}";
+const char octeontx_ssowvf_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"octeontx_ssowvf\", \"pci_ids\" : []}";
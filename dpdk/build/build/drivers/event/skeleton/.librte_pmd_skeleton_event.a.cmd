@@ -0,0 +1 @@
+cmd_librte_pmd_skeleton_event.a = ar crDs librte_pmd_skeleton_event.a skeleton_eventdev.o 
@@ -0,0 +1,2 @@
+const char event_skeleton_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"event_skeleton\", \"pci_ids\" : []}";
+const char event_skeleton_pci_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"event_skeleton_pci\", \"pci_ids\" : [[6013, 1, 65535, 65535] ]}";
@@ -0,0 +1 @@
+cmd_librte_pmd_sw_event.a = ar crDs librte_pmd_sw_event.a sw_evdev.o sw_evdev_worker.o sw_evdev_scheduler.o sw_evdev_xstats.o 
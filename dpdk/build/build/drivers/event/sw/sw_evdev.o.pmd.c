@@ -0,0 +1 @@
+const char event_sw_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"event_sw\", \"params\" : \"numa_node=<int> sched_quanta=<int>credit_quanta=<int>\", \"pci_ids\" : []}";
@@ -0,0 +1 @@
+cmd_librte_mempool_ring.a = ar crDs librte_mempool_ring.a rte_mempool_ring.o 
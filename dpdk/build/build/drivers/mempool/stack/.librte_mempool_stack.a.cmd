@@ -0,0 +1 @@
+cmd_librte_mempool_stack.a = ar crDs librte_mempool_stack.a rte_mempool_stack.o 
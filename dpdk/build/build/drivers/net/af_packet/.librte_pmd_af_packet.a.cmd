@@ -0,0 +1 @@
+cmd_librte_pmd_af_packet.a = ar crDs librte_pmd_af_packet.a rte_eth_af_packet.o 
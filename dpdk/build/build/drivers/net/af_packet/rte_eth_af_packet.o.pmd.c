@@ -0,0 +1 @@
+const char net_af_packet_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_af_packet\", \"params\" : \"iface=<string> qpairs=<int> blocksz=<int> framesz=<int> framecnt=<int>\", \"pci_ids\" : []}";
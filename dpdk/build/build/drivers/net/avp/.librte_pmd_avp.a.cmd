@@ -0,0 +1 @@
+cmd_librte_pmd_avp.a = ar crDs librte_pmd_avp.a avp_ethdev.o 
@@ -0,0 +1 @@
+const char net_avp_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_avp\", \"pci_ids\" : [[6900, 4368, 6900, 4356] ]}";
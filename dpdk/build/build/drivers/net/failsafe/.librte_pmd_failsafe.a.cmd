@@ -0,0 +1 @@
+cmd_librte_pmd_failsafe.a = ar crDs librte_pmd_failsafe.a failsafe.o failsafe_args.o failsafe_eal.o failsafe_ops.o failsafe_rxtx.o failsafe_ether.o failsafe_flow.o 
@@ -0,0 +1 @@
+const char net_failsafe_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_failsafe\", \"params\" : \"dev(<ifc>),exec(<shell command>),mac=mac_addr,hotplug_poll=u64\", \"pci_ids\" : []}";
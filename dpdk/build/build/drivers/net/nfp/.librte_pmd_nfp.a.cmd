@@ -0,0 +1 @@
+cmd_librte_pmd_nfp.a = ar crDs librte_pmd_nfp.a nfp_net.o 
@@ -0,0 +1 @@
+const char net_nfp_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_nfp\", \"kmod\" : \"* igb_uio | uio_pci_generic | vfio-pci\", \"pci_ids\" : [[6638, 24576, 65535, 65535],[6638, 24579, 65535, 65535] ]}";
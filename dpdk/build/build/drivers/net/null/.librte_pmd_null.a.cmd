@@ -0,0 +1 @@
+cmd_librte_pmd_null.a = ar crDs librte_pmd_null.a rte_eth_null.o 
@@ -0,0 +1 @@
+const char net_null_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_null\", \"params\" : \"size=<int> copy=<int>\", \"pci_ids\" : []}";
@@ -0,0 +1 @@
+cmd_librte_pmd_ring.a = ar crDs librte_pmd_ring.a rte_eth_ring.o 
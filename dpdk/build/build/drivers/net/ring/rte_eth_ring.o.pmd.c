@@ -0,0 +1 @@
+const char net_ring_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_ring\", \"params\" : \"nodeaction=name:node:action(ATTACH|CREATE)\", \"pci_ids\" : []}";
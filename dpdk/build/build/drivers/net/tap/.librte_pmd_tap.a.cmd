@@ -0,0 +1 @@
+cmd_librte_pmd_tap.a = ar crDs librte_pmd_tap.a rte_eth_tap.o tap_flow.o tap_netlink.o tap_tcmsgs.o 
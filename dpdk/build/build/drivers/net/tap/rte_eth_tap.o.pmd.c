@@ -0,0 +1 @@
+const char net_tap_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_tap\", \"params\" : \"iface=<string> speed=<int> mac=fixed remote=<string>\", \"pci_ids\" : []}";
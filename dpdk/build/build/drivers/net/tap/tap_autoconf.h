@@ -0,0 +1,8 @@
+#ifndef HAVE_TC_FLOWER
+#define HAVE_TC_FLOWER 1
+#endif /* HAVE_TC_FLOWER */
+
+#ifndef HAVE_TC_VLAN_ID
+#define HAVE_TC_VLAN_ID 1
+#endif /* HAVE_TC_VLAN_ID */
+
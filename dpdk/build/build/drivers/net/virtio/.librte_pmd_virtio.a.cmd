@@ -0,0 +1 @@
+cmd_librte_pmd_virtio.a = ar crDs librte_pmd_virtio.a virtqueue.o virtio_pci.o virtio_rxtx.o virtio_ethdev.o virtio_rxtx_simple.o virtio_rxtx_simple_sse.o virtio_user/vhost_user.o virtio_user/vhost_kernel.o virtio_user/vhost_kernel_tap.o virtio_user/virtio_user_dev.o virtio_user_ethdev.o 
@@ -0,0 +1 @@
+const char net_virtio_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_virtio\", \"kmod\" : \"* igb_uio | uio_pci_generic | vfio-pci\", \"pci_ids\" : [[6900, 4096, 65535, 65535],[6900, 4161, 65535, 65535] ]}";
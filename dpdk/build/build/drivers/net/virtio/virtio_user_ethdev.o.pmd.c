@@ -0,0 +1 @@
+const char net_virtio_user_pmd_info[] __attribute__((used)) = "PMD_INFO_STRING= {\"name\" : \"net_virtio_user\", \"params\" : \"path=<path> mac=<mac addr> cq=<int> queue_size=<int> queues=<int> iface=<string>\", \"pci_ids\" : []}";
@@ -0,0 +1 @@
+cmd_librte_bitratestats.a = ar crDs librte_bitratestats.a rte_bitrate.o 
@@ -0,0 +1 @@
+cmd_librte_cfgfile.a = ar crDs librte_cfgfile.a rte_cfgfile.o 
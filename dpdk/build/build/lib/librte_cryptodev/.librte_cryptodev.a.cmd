@@ -0,0 +1 @@
+cmd_librte_cryptodev.a = ar crDs librte_cryptodev.a rte_cryptodev.o rte_cryptodev_pmd.o 
@@ -0,0 +1 @@
+cmd_librte_distributor.a = ar crDs librte_distributor.a rte_distributor_v20.o rte_distributor.o rte_distributor_match_sse.o 
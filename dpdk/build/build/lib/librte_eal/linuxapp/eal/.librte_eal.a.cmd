@@ -0,0 +1 @@
+cmd_librte_eal.a = ar crDs librte_eal.a eal.o eal_hugepage_info.o eal_memory.o eal_thread.o eal_log.o eal_vfio.o eal_vfio_mp_sync.o eal_pci.o eal_pci_uio.o eal_pci_vfio.o eal_debug.o eal_lcore.o eal_timer.o eal_interrupts.o eal_alarm.o eal_common_lcore.o eal_common_timer.o eal_common_memzone.o eal_common_log.o eal_common_launch.o eal_common_vdev.o eal_common_pci.o eal_common_pci_uio.o eal_common_memory.o eal_common_tailqs.o eal_common_errno.o eal_common_cpuflags.o eal_common_string_fns.o eal_common_hexdump.o eal_common_devargs.o eal_common_bus.o eal_common_dev.o eal_common_options.o eal_common_thread.o eal_common_proc.o rte_malloc.o malloc_elem.o malloc_heap.o rte_keepalive.o rte_service.o rte_cpuflags.o rte_spinlock.o 
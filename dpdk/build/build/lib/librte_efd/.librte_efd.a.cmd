@@ -0,0 +1 @@
+cmd_librte_efd.a = ar crDs librte_efd.a rte_efd.o 
@@ -0,0 +1 @@
+cmd_librte_ethdev.a = ar crDs librte_ethdev.a rte_ethdev.o rte_flow.o rte_tm.o 
@@ -0,0 +1 @@
+cmd_librte_eventdev.a = ar crDs librte_eventdev.a rte_eventdev.o rte_event_ring.o 
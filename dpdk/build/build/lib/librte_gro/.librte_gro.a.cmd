@@ -0,0 +1 @@
+cmd_librte_gro.a = ar crDs librte_gro.a rte_gro.o gro_tcp4.o 
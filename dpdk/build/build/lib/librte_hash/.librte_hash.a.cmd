@@ -0,0 +1 @@
+cmd_librte_hash.a = ar crDs librte_hash.a rte_cuckoo_hash.o rte_fbk_hash.o 
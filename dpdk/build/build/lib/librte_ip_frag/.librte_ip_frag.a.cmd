@@ -0,0 +1 @@
+cmd_librte_ip_frag.a = ar crDs librte_ip_frag.a rte_ipv4_fragmentation.o rte_ipv6_fragmentation.o rte_ipv4_reassembly.o rte_ipv6_reassembly.o rte_ip_frag_common.o ip_frag_internal.o 
@@ -0,0 +1 @@
+cmd_librte_jobstats.a = ar crDs librte_jobstats.a rte_jobstats.o 
@@ -0,0 +1 @@
+cmd_librte_kvargs.a = ar crDs librte_kvargs.a rte_kvargs.o 
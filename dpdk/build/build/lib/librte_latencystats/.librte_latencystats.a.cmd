@@ -0,0 +1 @@
+cmd_librte_latencystats.a = ar crDs librte_latencystats.a rte_latencystats.o 
@@ -0,0 +1 @@
+cmd_librte_lpm.a = ar crDs librte_lpm.a rte_lpm.o rte_lpm6.o 
@@ -0,0 +1 @@
+cmd_librte_mbuf.a = ar crDs librte_mbuf.a rte_mbuf.o rte_mbuf_ptype.o 
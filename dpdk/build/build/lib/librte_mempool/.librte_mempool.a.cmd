@@ -0,0 +1 @@
+cmd_librte_mempool.a = ar crDs librte_mempool.a rte_mempool.o rte_mempool_ops.o 
@@ -0,0 +1 @@
+cmd_librte_meter.a = ar crDs librte_meter.a rte_meter.o 
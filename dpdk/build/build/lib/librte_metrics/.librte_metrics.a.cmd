@@ -0,0 +1 @@
+cmd_librte_metrics.a = ar crDs librte_metrics.a rte_metrics.o 
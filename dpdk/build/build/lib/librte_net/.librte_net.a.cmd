@@ -0,0 +1 @@
+cmd_librte_net.a = ar crDs librte_net.a rte_net.o rte_net_crc.o 
@@ -0,0 +1 @@
+cmd_librte_pdump.a = ar crDs librte_pdump.a rte_pdump.o 
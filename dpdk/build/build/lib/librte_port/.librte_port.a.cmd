@@ -0,0 +1 @@
+cmd_librte_port.a = ar crDs librte_port.a rte_port_ethdev.o rte_port_ring.o rte_port_frag.o rte_port_ras.o rte_port_sched.o rte_port_fd.o rte_port_source_sink.o 
@@ -0,0 +1 @@
+cmd_librte_power.a = ar crDs librte_power.a rte_power.o rte_power_acpi_cpufreq.o rte_power_kvm_vm.o guest_channel.o 
@@ -0,0 +1 @@
+cmd_librte_reorder.a = ar crDs librte_reorder.a rte_reorder.o 
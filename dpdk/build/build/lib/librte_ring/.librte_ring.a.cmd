@@ -0,0 +1 @@
+cmd_librte_ring.a = ar crDs librte_ring.a rte_ring.o 
@@ -0,0 +1 @@
+cmd_librte_sched.a = ar crDs librte_sched.a rte_sched.o rte_red.o rte_approx.o rte_reciprocal.o 
@@ -0,0 +1 @@
+cmd_librte_timer.a = ar crDs librte_timer.a rte_timer.o 
@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline.h
\ No newline at end of file
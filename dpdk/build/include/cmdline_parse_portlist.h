@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline_parse_portlist.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline_parse_string.h
\ No newline at end of file
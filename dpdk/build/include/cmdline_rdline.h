@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline_rdline.h
\ No newline at end of file
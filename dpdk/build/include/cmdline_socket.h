@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline_socket.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_cmdline/cmdline_vt100.h
\ No newline at end of file
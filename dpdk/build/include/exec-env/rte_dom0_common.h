@@ -0,0 +1 @@
+../../../lib/librte_eal/linuxapp/eal/include/exec-env/rte_dom0_common.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../lib/librte_eal/linuxapp/eal/include/exec-env/rte_kni_common.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../lib/librte_eal/common/include/generic/rte_byteorder.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../lib/librte_eal/common/include/generic/rte_cpuflags.h
\ No newline at end of file
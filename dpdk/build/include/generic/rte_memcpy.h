@@ -0,0 +1 @@
+../../../lib/librte_eal/common/include/generic/rte_memcpy.h
\ No newline at end of file
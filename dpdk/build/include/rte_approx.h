@@ -0,0 +1 @@
+../../lib/librte_sched/rte_approx.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../drivers/net/avp/rte_avp_common.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../drivers/net/avp/rte_avp_fifo.h
\ No newline at end of file
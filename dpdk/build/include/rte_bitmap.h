@@ -0,0 +1 @@
+../../lib/librte_sched/rte_bitmap.h
\ No newline at end of file
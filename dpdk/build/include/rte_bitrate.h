@@ -0,0 +1 @@
+../../lib/librte_bitratestats/rte_bitrate.h
\ No newline at end of file
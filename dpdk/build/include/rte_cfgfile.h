@@ -0,0 +1 @@
+../../lib/librte_cfgfile/rte_cfgfile.h
\ No newline at end of file
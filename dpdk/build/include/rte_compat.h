@@ -0,0 +1 @@
+../../lib/librte_compat/rte_compat.h
\ No newline at end of file
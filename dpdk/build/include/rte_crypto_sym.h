@@ -0,0 +1 @@
+../../lib/librte_cryptodev/rte_crypto_sym.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../drivers/crypto/scheduler/rte_cryptodev_scheduler_operations.h
\ No newline at end of file
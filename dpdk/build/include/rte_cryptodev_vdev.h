@@ -0,0 +1 @@
+../../lib/librte_cryptodev/rte_cryptodev_vdev.h
\ No newline at end of file
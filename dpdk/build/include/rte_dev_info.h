@@ -0,0 +1 @@
+../../lib/librte_ether/rte_dev_info.h
\ No newline at end of file
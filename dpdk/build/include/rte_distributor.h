@@ -0,0 +1 @@
+../../lib/librte_distributor/rte_distributor.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_efd/rte_efd.h
\ No newline at end of file
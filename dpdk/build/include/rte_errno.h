@@ -0,0 +1 @@
+../../lib/librte_eal/common/include/rte_errno.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_ether/rte_eth_ctrl.h
\ No newline at end of file
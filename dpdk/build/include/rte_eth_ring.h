@@ -0,0 +1 @@
+../../drivers/net/ring/rte_eth_ring.h
\ No newline at end of file
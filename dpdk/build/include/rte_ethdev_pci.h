@@ -0,0 +1 @@
+../../lib/librte_ether/rte_ethdev_pci.h
\ No newline at end of file
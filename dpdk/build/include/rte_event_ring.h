@@ -0,0 +1 @@
+../../lib/librte_eventdev/rte_event_ring.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_eventdev/rte_eventdev.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_eventdev/rte_eventdev_pmd.h
\ No newline at end of file
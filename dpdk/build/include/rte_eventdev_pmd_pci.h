@@ -0,0 +1 @@
+../../lib/librte_eventdev/rte_eventdev_pmd_pci.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_ether/rte_flow_driver.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_gro/rte_gro.h
\ No newline at end of file
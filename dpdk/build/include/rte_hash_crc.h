@@ -0,0 +1 @@
+../../lib/librte_hash/rte_hash_crc.h
\ No newline at end of file
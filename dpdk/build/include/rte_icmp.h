@@ -0,0 +1 @@
+../../lib/librte_net/rte_icmp.h
\ No newline at end of file
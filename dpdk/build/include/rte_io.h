@@ -0,0 +1 @@
+../../lib/librte_eal/common/include/arch/x86/rte_io.h
\ No newline at end of file
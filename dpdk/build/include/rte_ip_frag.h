@@ -0,0 +1 @@
+../../lib/librte_ip_frag/rte_ip_frag.h
\ No newline at end of file
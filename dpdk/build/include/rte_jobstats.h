@@ -0,0 +1 @@
+../../lib/librte_jobstats/rte_jobstats.h
\ No newline at end of file
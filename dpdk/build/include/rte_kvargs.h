@@ -0,0 +1 @@
+../../lib/librte_kvargs/rte_kvargs.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_latencystats/rte_latencystats.h
\ No newline at end of file
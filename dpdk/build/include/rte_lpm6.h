@@ -0,0 +1 @@
+../../lib/librte_lpm/rte_lpm6.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_lpm/rte_lpm_sse.h
\ No newline at end of file
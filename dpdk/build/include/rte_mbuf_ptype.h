@@ -0,0 +1 @@
+../../lib/librte_mbuf/rte_mbuf_ptype.h
\ No newline at end of file
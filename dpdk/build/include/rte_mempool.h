@@ -0,0 +1 @@
+../../lib/librte_mempool/rte_mempool.h
\ No newline at end of file
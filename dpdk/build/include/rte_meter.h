@@ -0,0 +1 @@
+../../lib/librte_meter/rte_meter.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_metrics/rte_metrics.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_eal/common/include/rte_pci_dev_feature_defs.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_pdump/rte_pdump.h
\ No newline at end of file
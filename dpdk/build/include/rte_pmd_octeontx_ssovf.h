@@ -0,0 +1 @@
+../../drivers/event/octeontx/rte_pmd_octeontx_ssovf.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_port/rte_port_ras.h
\ No newline at end of file
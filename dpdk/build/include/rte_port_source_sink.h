@@ -0,0 +1 @@
+../../lib/librte_port/rte_port_source_sink.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_power/rte_power.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_eal/common/include/rte_random.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_sched/rte_reciprocal.h
\ No newline at end of file
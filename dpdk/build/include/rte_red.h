@@ -0,0 +1 @@
+../../lib/librte_sched/rte_red.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_reorder/rte_reorder.h
\ No newline at end of file
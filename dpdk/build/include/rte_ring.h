@@ -0,0 +1 @@
+../../lib/librte_ring/rte_ring.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_sched/rte_sched.h
\ No newline at end of file
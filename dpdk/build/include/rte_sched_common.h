@@ -0,0 +1 @@
+../../lib/librte_sched/rte_sched_common.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_net/rte_sctp.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../lib/librte_timer/rte_timer.h
\ No newline at end of file
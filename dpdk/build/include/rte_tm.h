@@ -0,0 +1 @@
+../../lib/librte_ether/rte_tm.h
\ No newline at end of file
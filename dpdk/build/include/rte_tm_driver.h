@@ -0,0 +1 @@
+../../lib/librte_ether/rte_tm_driver.h
\ No newline at end of file
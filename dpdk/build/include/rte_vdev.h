@@ -0,0 +1 @@
+../../lib/librte_eal/common/include/rte_vdev.h
\ No newline at end of file
@@ -3,7 +3,9 @@
  */
 #include "dpdk_init.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <rte_config.h>
 #include <rte_common.h>
@@ -23,41 +25,188 @@ static void check_dpdk_error(uint32_t rc, const char* operation) {
 static const uint32_t RX_DESCS = 256;
 static const uint32_t TX_DESCS = 256;
 static const uint32_t MEMPOOL_CACHE_SIZE = 256;
-static const uint32_t MEMPOOL_SIZE = 2047;
+// Smallest pool. DPDK sizes the ring of a pool to a power of 2 -> Sizes of
+// 2^n - 1 waste no memory.
+static const uint32_t MEMPOOL_MIN_SIZE = 2047;
 static const uint32_t MBUF_SIZE = 1600;
 
-static struct rte_mempool* create_mempool() {
-	static volatile int pool_id = 0;
-	char pool_name[32];
-	sprintf(pool_name, "pool%d", __sync_fetch_and_add(&pool_id, 1));
-	struct rte_mempool* pool = rte_pktmbuf_pool_create(pool_name, MEMPOOL_SIZE, MEMPOOL_CACHE_SIZE,
-			0, MBUF_SIZE + RTE_PKTMBUF_HEADROOM,
-			rte_socket_id()
+// One pool per socket, shared by all queues of the ports on that socket
+static struct rte_mempool* socket_pools[RTE_MAX_NUMA_NODES];
+// Mbufs reserved by the ports of a socket and by every lcore
+static uint32_t socket_mbufs[RTE_MAX_NUMA_NODES];
+static uint32_t lcore_mbufs = 0;
+// Set by set_mempool_config(). 0/NULL: Sized by the reservations/default handler
+static uint32_t mempool_size = 0;
+static const char* mempool_ops = NULL;
+
+static int get_port_socket(uint8_t port_id) {
+	int socket = rte_eth_dev_socket_id(port_id);
+	return socket < 0 ? (int)rte_socket_id() : socket;
+}
+
+static struct rte_mempool* create_mempool(int socket, uint32_t size) {
+	char pool_name[RTE_MEMPOOL_NAMESIZE];
+	const char* ops = mempool_ops ? mempool_ops : RTE_MBUF_DEFAULT_MEMPOOL_OPS;
+	snprintf(pool_name, sizeof(pool_name), "pool%d", socket);
+	// rte_pktmbuf_pool_create() with a selectable mempool handler
+	struct rte_mempool* pool = rte_mempool_create_empty(pool_name, size,
+			sizeof(struct rte_mbuf) + MBUF_SIZE + RTE_PKTMBUF_HEADROOM, MEMPOOL_CACHE_SIZE,
+			sizeof(struct rte_pktmbuf_pool_private), socket, 0
 			);
-	if (!pool) {
+	if (!pool || rte_mempool_set_ops_byname(pool, ops, NULL)) {
 		printf("could not allocate mempool\n");
 		exit(1);
 	}
+	rte_pktmbuf_pool_init(pool, NULL);
+	if (rte_mempool_populate_default(pool) < 0) {
+		printf("could not allocate %u mbufs on socket %d\n", size, socket);
+		exit(1);
+	}
+	rte_mempool_obj_iter(pool, rte_pktmbuf_init, NULL);
+	printf("Info: Mempool of socket %d: %u mbufs, handler %s\n", socket, size, ops);
 	return pool;
 }
 
+/**
+ * Set the size and the handler of the mempools.
+ * size: Mbufs per pool, 0 sizes the pools by the reservations.
+ * ops: Name of a mempool handler of DPDK (e.g. ring_mp_mc or stack), NULL
+ * for the default handler.
+ * Returns 0 on success, -1 for an unknown handler.
+ */
+int set_mempool_config(uint32_t size, const char* ops) {
+	bool known = ops == NULL;
+	for (uint32_t i = 0; !known && i < rte_mempool_ops_table.num_ops; ++i)
+		known = strcmp(ops, rte_mempool_ops_table.ops[i].name) == 0;
+	if (!known)
+		return -1;
+	mempool_size = size;
+	mempool_ops = ops;
+	return 0;
+}
+
+/**
+ * Reserve mbufs in the pool of the port's socket for its descriptor rings.
+ * Must be called for all ports before the first device is configured.
+ */
+void reserve_port_mbufs(uint8_t port_id, uint16_t num_rx_queues, uint16_t num_tx_queues) {
+	socket_mbufs[get_port_socket(port_id)] += num_rx_queues * RX_DESCS + num_tx_queues * TX_DESCS;
+}
+
+/**
+ * Reserve mbufs in every pool for an lcore: Its mempool cache and the
+ * in_flight mbufs it holds in bursts, buffers or rings.
+ */
+void reserve_lcore_mbufs(uint32_t in_flight) {
+	// A cache grows up to 1.5 times its size before it is flushed
+	lcore_mbufs += MEMPOOL_CACHE_SIZE * 3 / 2 + in_flight;
+}
+
+/**
+ * Get the mempool of a socket.
+ * If create is set, a missing pool is created. Its size is the configured
+ * one or the sum of all reservations, at least MEMPOOL_MIN_SIZE.
+ * Returns NULL if the pool does not exist.
+ */
+struct rte_mempool* get_socket_mempool(int socket, bool create) {
+	if (socket < 0 || socket >= RTE_MAX_NUMA_NODES)
+		socket = 0;
+	if (!socket_pools[socket] && create) {
+		uint32_t size = mempool_size ? mempool_size : socket_mbufs[socket] + lcore_mbufs;
+		size = RTE_MAX(size, MEMPOOL_MIN_SIZE);
+		socket_pools[socket] = create_mempool(socket, rte_align32pow2(size + 1) - 1);
+	}
+	return socket_pools[socket];
+}
+
+/**
+ * Free all mempools and reservations. No mbuf of the pools may be in use.
+ */
+void free_mempools(void) {
+	for (int socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket) {
+		rte_mempool_free(socket_pools[socket]);
+		socket_pools[socket] = NULL;
+		socket_mbufs[socket] = 0;
+	}
+	lcore_mbufs = 0;
+}
+
+/**
+ * Check if the PMD of a device sets the packet type of received IPv4 packets.
+ * The packet types are always set if supported.
+ */
+static bool supports_ipv4_ptype(uint8_t port_id) {
+	int num = rte_eth_dev_get_supported_ptypes(port_id, RTE_PTYPE_L3_MASK, NULL, 0);
+	if (num <= 0)
+		return false;
+	uint32_t ptypes[num];
+	num = rte_eth_dev_get_supported_ptypes(port_id, RTE_PTYPE_L3_MASK, ptypes, num);
+	for (int i = 0; i < num; ++i) {
+		if (RTE_ETH_IS_IPV4_HDR(ptypes[i]))
+			return true;
+	}
+	return false;
+}
+
 /**
  * Initialize a device by configuring hardware queues.
  *
  * Number of allocated queues for device with port_id:
- * - 1 RX queue
- * - num_queues rx/tx queues
+ * - num_rx_queues RX queues. With more than one, RSS spreads the packets
+ *   over the queues by their IPv4 source and destination addresses.
+ * - num_tx_queues TX queues
+ * If rx_intr is set, the RX queues can signal received packets with an
+ * interrupt. Without the support of the device, the queues are polled only.
+ * The device validates IPv4 header checksums if it is able to.
+ * All RX queues of the ports on one socket share the mempool of the socket.
  */
-void configure_device(uint8_t port_id, uint16_t num_queues) {
+void configure_device(uint8_t port_id, uint16_t num_rx_queues, uint16_t num_tx_queues, bool rx_intr) {
 	struct rte_eth_conf port_conf = { 0 };
-	check_dpdk_error(rte_eth_dev_configure(port_id, num_queues, num_queues, &port_conf), "configure device");
 	struct rte_eth_dev_info dev_info;
+	// Descriptor rings and buffers in the memory of the NIC's NUMA node
+	int socket = get_port_socket(port_id);
+	struct rte_mempool* pool = get_socket_mempool(socket, true);
 	rte_eth_dev_info_get(port_id, &dev_info);
-	for (uint16_t queue = 0; queue < num_queues; ++queue) {
-		check_dpdk_error(rte_eth_tx_queue_setup(port_id, queue, TX_DESCS, rte_socket_id(), &dev_info.default_txconf), "configure tx queue");
-		check_dpdk_error(rte_eth_rx_queue_setup(port_id, queue, RX_DESCS, rte_socket_id(), &dev_info.default_rxconf, create_mempool()), "configure rx queue");
+	if (num_rx_queues > 1) {
+		port_conf.rxmode.mq_mode = ETH_MQ_RX_RSS;
+		port_conf.rx_adv_conf.rss_conf.rss_key = NULL; // Default key of the driver
+		port_conf.rx_adv_conf.rss_conf.rss_hf = ETH_RSS_IP & dev_info.flow_type_rss_offloads;
+		// Without the plain IPv4 type, the NIC hashes only the IPv4 flow types it offers,
+		// e.g. TCP -> Hash TCP and UDP at least, everything else reaches RX queue 0
+		if (!(port_conf.rx_adv_conf.rss_conf.rss_hf & ETH_RSS_IPV4)) {
+			port_conf.rx_adv_conf.rss_conf.rss_hf |= (ETH_RSS_TCP | ETH_RSS_UDP) & dev_info.flow_type_rss_offloads;
+			if (port_conf.rx_adv_conf.rss_conf.rss_hf != 0)
+				printf("Warning: Interface %u cannot hash all IPv4 packets. RSS types 0x%"PRIx64", the other packets reach RX queue 0 only\n",
+					port_id, port_conf.rx_adv_conf.rss_conf.rss_hf);
+		}
+		if (port_conf.rx_adv_conf.rss_conf.rss_hf == 0) {
+			printf("Warning: Interface %u does not support RSS. Only RX queue 0 receives packets\n", port_id);
+			port_conf.rxmode.mq_mode = ETH_MQ_RX_NONE;
+		}
+	}
+	// Let the NIC validate IPv4 header checksums. The datapath checks
+	// packets without a verdict of the NIC in software.
+	if (dev_info.rx_offload_capa & DEV_RX_OFFLOAD_IPV4_CKSUM)
+		port_conf.rxmode.hw_ip_checksum = 1;
+	else
+		printf("Info: Interface %u does not check IPv4 checksums, the datapath does\n", port_id);
+	if (!supports_ipv4_ptype(port_id))
+		printf("Info: Interface %u does not classify IPv4 packets, the datapath does\n", port_id);
+	port_conf.intr_conf.rxq = rx_intr;
+	int rc = rte_eth_dev_configure(port_id, num_rx_queues, num_tx_queues, &port_conf);
+	if (rc && rx_intr) {
+		printf("Warning: Interface %u does not support RX interrupts\n", port_id);
+		port_conf.intr_conf.rxq = 0;
+		rc = rte_eth_dev_configure(port_id, num_rx_queues, num_tx_queues, &port_conf);
 	}
+	check_dpdk_error(rc, "configure device");
+	for (uint16_t queue = 0; queue < num_tx_queues; ++queue)
+		check_dpdk_error(rte_eth_tx_queue_setup(port_id, queue, TX_DESCS, socket, &dev_info.default_txconf), "configure tx queue");
+	for (uint16_t queue = 0; queue < num_rx_queues; ++queue)
+		check_dpdk_error(rte_eth_rx_queue_setup(port_id, queue, RX_DESCS, socket, &dev_info.default_rxconf, pool), "configure rx queue");
 	check_dpdk_error(rte_eth_dev_start(port_id), "starting device");
+	// IPv6 neighbor solicitations are sent to multicast MACs
+	rte_eth_allmulticast_enable(port_id);
 }
 
 
@@ -1,20 +1,26 @@
 #ifndef DPDK_INIT_H__
 #define DPDK_INIT_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
 #include <rte_mbuf.h>
+#include <rte_mempool.h>
 #include <rte_ethdev.h>
 
 void init_dpdk();
-void configure_device(uint8_t port_id, uint16_t num_tx_queues);
+void configure_device(uint8_t port_id, uint16_t num_rx_queues, uint16_t num_tx_queues, bool rx_intr);
+int set_mempool_config(uint32_t size, const char* ops);
+void reserve_port_mbufs(uint8_t port_id, uint16_t num_rx_queues, uint16_t num_tx_queues);
+void reserve_lcore_mbufs(uint32_t in_flight);
+struct rte_mempool* get_socket_mempool(int socket, bool create);
+void free_mempools(void);
 
 static inline uint32_t recv_from_device(uint8_t port_id, uint16_t num_rx_queues, struct rte_mbuf* bufs[], uint32_t num_bufs) {
 	uint32_t rx = 0;
 	for (uint16_t i = 0; i < num_rx_queues && rx < num_bufs; ++i) {
 		rx += rte_eth_rx_burst(port_id, i, bufs + rx, num_bufs - rx);
 	}
-	if (!rx) usleep(100);
 	return rx;
 }
 
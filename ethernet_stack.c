@@ -1,74 +1,113 @@
 #include <rte_mbuf.h>
 #include <rte_ether.h>
 #include <rte_ethdev.h>
+#include <rte_prefetch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
 
 #include "ethernet_stack.h"
 #include "router.h"
 #include "arp_stack.h"
 #include "ipv4_stack.h"
+#include "ipv6_stack.h"
+#include "ndp_stack.h"
+#include "slow_path.h"
 #include "global.h"
+#include "log.h"
 
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static void tx_retry_or_drop(struct rte_mbuf **unsent, uint16_t n,
+                                void *userdata);
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
 /**
- * \brief Handle an ethernet frame.
+ * \brief Handle a burst of ethernet frames.
  * 
  * This method is the starting point of packet handling.
- * It checks the ethernet frame and distributes the frame/packet to the
- * responsible L3 stack or ARP stack.
+ * It checks the ethernet frames of a whole RX burst and classifies them by
+ * their ethertype. All IPv4 and all IPv6 packets of the burst are handed to
+ * their stack together, ARP packets are handed to the slow path. Frames the
+ * NIC already classified as IPv4 skip the ethertype.
  * 
- * If an unknown L3 protocol is used we return ERR_NOT_IMPL.
+ * Frames that are too short, not addressed to us or use an unknown L3
+ * protocol are collected and dropped in bulk at the end of the burst.
  * 
  * \param cfg The interface configuration of the interface this thread is 
  *              responsible for.
- * \param mbuf Pointer to the buffer that contains the currently handled packet.
- * 
- * \return 0 if the frame was handled successfully.
- *          Errors: ERR_NOT_IMPL: No stack for the given ethertype.
- *                  ERR_INV_PKT: If the received frame was currupted or the 
- *                               ARP/L3 stack was not able to handle
- *                               the packet or the packet is too short
+ * \param mbufs The buffers of the received burst. We take ownership of all
+ *              buffers.
+ * \param n Number of buffers in mbufs. Must not exceed THREAD_BUFSIZE.
  */
-int handle_frame(intf_cfg_t *cfg, struct rte_mbuf *mbuf)
+void handle_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n)
 {
+    struct rte_mbuf *ipv4_pkts[THREAD_BUFSIZE], *drops[THREAD_BUFSIZE];
+    struct rte_mbuf *ipv6_pkts[THREAD_BUFSIZE];
+    lcore_stats_t *stats = &lcore_stats[cfg->lcore];
+    uint16_t no_ipv4 = 0, no_ipv6 = 0, no_drops = 0;
     struct ether_hdr *hdr = NULL;
+    uint64_t bytes = 0;
 
-    if(rte_pktmbuf_data_len(mbuf) < ETHER_HDR_LEN)
-        return ERR_INV_PKT;
+    for(uint16_t i = 0; i < n; ++i) {
+        if(i + 1 < n) // Header of the next frame is required soon
+            rte_prefetch0(rte_pktmbuf_mtod(mbufs[i + 1], void *));
 
-    hdr = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+        bytes += rte_pktmbuf_pkt_len(mbufs[i]);
+        if(rte_pktmbuf_data_len(mbufs[i]) < ETHER_HDR_LEN) {
+            stats->drops[DROP_ETH_SHORT]++;
+            drops[no_drops++] = mbufs[i];
+            continue;
+        }
 
-    // Check if this packet was sent to my interface or broadcast
-    if(!is_broadcast_ether_addr(&hdr->d_addr)
-        && !is_same_ether_addr(&hdr->d_addr, &cfg->ether_addr)) {
-        return 0;
-    }
+        hdr = rte_pktmbuf_mtod(mbufs[i], struct ether_hdr *);
+
+        // Check if this packet was sent to my interface, broadcast or to
+        // the solicited-node multicast group of my link-local address
+        if(!is_broadcast_ether_addr(&hdr->d_addr)
+            && !is_same_ether_addr(&hdr->d_addr, &cfg->ether_addr)
+            && !is_solicited_node_mac(&hdr->d_addr, &cfg->ether_addr)) {
+            stats->drops[DROP_ETH_NOTFORME]++;
+            drops[no_drops++] = mbufs[i];
+            continue;
+        }
 
-    switch(rte_be_to_cpu_16(hdr->ether_type)) {
-        case ETHER_TYPE_IPv4:
-            if(handle_ipv4(
-                            cfg,
-                            mbuf,
-                            ((char *)hdr) + ETHER_HDR_LEN,
-                            rte_pktmbuf_data_len(mbuf) - ETHER_HDR_LEN
-            ) == ERR_INV_PKT) { // Do not care about the other errors
-                                // as the callee cannot handle them
-                                // anyway
-                return ERR_INV_PKT;
-            }
-            break;
-        case ETHER_TYPE_ARP:
-            // We do not check if an ARP packet is addressed to MAC_BROADCAST
-            // This is an efficiency problem of the sender not our router!
-            handle_arp(
-                        cfg,
-                        mbuf,
-                        ((char *)hdr) + ETHER_HDR_LEN,
-                        rte_pktmbuf_data_len(mbuf) - ETHER_HDR_LEN
-            ); // Not aware of VLANs!
-            break;
-        default:
-            return ERR_NOT_IMPL; 
+        // The NIC already classified the frame as untagged IPv4
+        if(is_ipv4_ptype(mbufs[i]->packet_type)) {
+            ipv4_pkts[no_ipv4++] = mbufs[i];
+            continue;
+        }
+
+        switch(rte_be_to_cpu_16(hdr->ether_type)) {
+            case ETHER_TYPE_IPv4:
+                ipv4_pkts[no_ipv4++] = mbufs[i];
+                break;
+            case ETHER_TYPE_IPv6:
+                ipv6_pkts[no_ipv6++] = mbufs[i];
+                break;
+            case ETHER_TYPE_ARP:
+                // We do not check if an ARP packet is addressed to
+                // MAC_BROADCAST. This is an efficiency problem of the sender
+                // not our router! Not aware of VLANs!
+                defer_to_slow(cfg, mbufs[i], SLOW_ARP, cfg->intf, 0);
+                break;
+            default: // No stack for the given ethertype
+                stats->drops[DROP_ETH_TYPE]++;
+                drops[no_drops++] = mbufs[i];
+                break;
+        }
     }
-    return 0;
+    stats->ports[cfg->intf].rx_pkts += n;
+    stats->ports[cfg->intf].rx_bytes += bytes;
+
+    if(no_ipv4 > 0)
+        handle_ipv4(cfg, ipv4_pkts, no_ipv4);
+    if(no_ipv6 > 0)
+        handle_ipv6(cfg, ipv6_pkts, no_ipv6);
+
+    drop_frames(drops, no_drops);
 }
 
 /**
@@ -76,6 +115,7 @@ int handle_frame(intf_cfg_t *cfg, struct rte_mbuf *mbuf)
  * 
  * This function send a frame and sets the destination and source IP address
  * according to the given information.
+ * The frame is added to the TX buffer of this lcore for the given interface.
  * 
  * \param cfg The configuration of the interface the packet
  *              was received on/this core
@@ -91,9 +131,201 @@ int send_frame(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
     struct ether_hdr *hdr = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
 
     ether_addr_copy(d_ether, &hdr->d_addr);
-    rte_eth_macaddr_get(intf, &hdr->s_addr);
+    return send_frames(cfg, &mbuf, 1, intf);
+}
 
-    while (!rte_eth_tx_burst(intf, cfg->lcore - 1, &mbuf, 1));
+/**
+ * /brief Send out a vector of frames on one interface.
+ * 
+ * This function sends all frames in the vector out on the given interface.
+ * The destination MAC addresses must already be set by the caller, we only
+ * set the source MAC address of the egress interface.
+ * See send_l2_frames() for the buffering.
+ * 
+ * \param cfg The configuration of the interface the packets
+ *              were received on/this core
+ * \param mbufs The buffers containing the frames we shall send.
+ * \param n Number of buffers in mbufs.
+ * \param intf The interface we shall send the frames out on.
+ * 
+ * \return 0 on success. Currently the only possible value.
+ */
+int send_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n,
+                uint8_t intf)
+{
+    const tx_port_t *port = cfg->tx_ports[intf];
+
+    for(uint16_t i = 0; port != NULL && i < n; ++i)
+        ether_addr_copy(
+                    &port->s_ether,
+                    &rte_pktmbuf_mtod(mbufs[i], struct ether_hdr *)->s_addr
+        );
+    return send_l2_frames(cfg, mbufs, n, intf);
+}
+
+/**
+ * /brief Send out a vector of complete frames on one interface.
+ * 
+ * Both MAC addresses must already be set by the caller. See the adjacencies
+ * of the routing table.
+ * The frames are added to the TX buffer of this lcore for the interface.
+ * A full buffer is sent out immediately, the router_thread flushes all
+ * remaining frames using flush_frames().
+ * 
+ * If this lcore has no TX state for the interface, the frames are dropped.
+ * 
+ * \param cfg The configuration of the interface the packets
+ *              were received on/this core
+ * \param mbufs The buffers containing the frames we shall send.
+ * \param n Number of buffers in mbufs.
+ * \param intf The interface we shall send the frames out on.
+ * 
+ * \return 0 on success. Currently the only possible value.
+ */
+int send_l2_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n,
+                    uint8_t intf)
+{
+    tx_port_t *port = cfg->tx_ports[intf];
+    uint64_t bytes = 0;
+
+    if(port == NULL) { // Interface is not handled by this router
+        TRACE_WARN(TRC_TX_NO_INTF, intf, 0, 0);
+        lcore_stats[cfg->lcore].drops[DROP_TX_NO_INTF] += n;
+        drop_frames(mbufs, n);
+        return 0;
+    }
+
+    for(uint16_t i = 0; i < n; ++i) {
+        bytes += rte_pktmbuf_pkt_len(mbufs[i]);
+        rte_eth_tx_buffer(intf, port->queue, port->buf, mbufs[i]);
+    }
+    // Frames the TX queue does not accept are subtracted again on drop
+    port->stats->ports[intf].tx_pkts += n;
+    port->stats->ports[intf].tx_bytes += bytes;
 
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * /brief Send out all frames buffered by this lcore.
+ * 
+ * \param cfg The configuration of the interface this core is responsible for.
+ */
+void flush_frames(intf_cfg_t *cfg)
+{
+    tx_port_t *port = NULL;
+
+    for(uint8_t i = 0; i < cfg->no_tx_ports; ++i) {
+        port = cfg->tx_ports[cfg->tx_port_ids[i]];
+        rte_eth_tx_buffer_flush(port->intf, port->queue, port->buf);
+    }
+}
+
+/**
+ * /brief Create the TX state of an lcore for one egress interface.
+ * 
+ * Allocates the TX buffer on the socket of the lcore and installs the
+ * retry/drop policy for frames the TX queue does not accept.
+ * 
+ * \param cfg The configuration of the lcore that shall use the TX state.
+ * \param intf The egress interface.
+ * \param queue The TX queue of the interface this lcore uses.
+ * \param retries Number of retries on a full TX queue before frames are
+ *              dropped. TX_RETRY_BLOCK to retry until all frames are sent.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Cannot allocate the TX state.
+ *                  ERR_CFG: Interface ID not supported by DPDK.
+ */
+int setup_tx_port(intf_cfg_t *cfg, uint8_t intf, uint16_t queue, int retries)
+{
+    int socket = rte_lcore_to_socket_id(cfg->lcore);
+    tx_port_t *port = NULL;
+
+    if(intf >= RTE_MAX_ETHPORTS)
+        return ERR_CFG;
+
+    if((port = rte_zmalloc_socket("tx_port", sizeof(tx_port_t),
+                                    RTE_CACHE_LINE_SIZE, socket)) == NULL)
+        return ERR_MEM;
+
+    if((port->buf = rte_zmalloc_socket("tx_buffer",
+                                RTE_ETH_TX_BUFFER_SIZE(THREAD_BUFSIZE),
+                                RTE_CACHE_LINE_SIZE, socket)) == NULL) {
+        rte_free(port);
+        return ERR_MEM;
+    }
+
+    port->intf = intf;
+    port->queue = queue;
+    rte_eth_macaddr_get(intf, &port->s_ether);
+    port->retries = retries;
+    port->stats = &lcore_stats[cfg->lcore];
+    rte_eth_tx_buffer_init(port->buf, THREAD_BUFSIZE);
+    rte_eth_tx_buffer_set_err_callback(port->buf, tx_retry_or_drop, port);
+
+    cfg->tx_ports[intf] = port;
+    cfg->tx_port_ids[cfg->no_tx_ports++] = intf;
+    return 0;
+}
+
+/**
+ * /brief Free the TX state of an lcore.
+ * 
+ * Frames still buffered are dropped.
+ * 
+ * \param cfg The configuration of the lcore.
+ */
+void free_tx_ports(intf_cfg_t *cfg)
+{
+    tx_port_t *port = NULL;
+
+    for(uint8_t i = 0; i < cfg->no_tx_ports; ++i) {
+        port = cfg->tx_ports[cfg->tx_port_ids[i]];
+        drop_frames(port->buf->pkts, port->buf->length);
+        rte_free(port->buf);
+        rte_free(port);
+        cfg->tx_ports[cfg->tx_port_ids[i]] = NULL;
+    }
+    cfg->no_tx_ports = 0;
+}
+
+/*********************************
+ *  Static function definitions  *
+ *********************************/
+/**
+ * /brief Handle frames the TX queue did not accept.
+ * 
+ * Called by DPDK if flushing a TX buffer did not send out all frames.
+ * We retry sending as often as configured for the interface and drop the
+ * remaining frames afterwards. Thus, a congested egress interface can not
+ * stall the lcore and all other interfaces it serves.
+ * 
+ * \param unsent The frames that were not sent.
+ * \param n Number of frames in unsent.
+ * \param userdata The tx_port_t of the TX buffer.
+ */
+static void tx_retry_or_drop(struct rte_mbuf **unsent, uint16_t n,
+                                void *userdata)
+{
+    tx_port_t *port = (tx_port_t *)userdata;
+    port_stats_t *stats = &port->stats->ports[port->intf];
+    uint16_t sent = 0;
+
+    for(
+        int retry = 0;
+        sent < n && (port->retries == TX_RETRY_BLOCK || retry < port->retries);
+        ++retry
+    ) {
+        sent += rte_eth_tx_burst(port->intf, port->queue,
+                                    unsent + sent, n - sent);
+    }
+
+    if(sent < n) {
+        port->stats->drops[DROP_TX_FULL] += n - sent;
+        stats->tx_pkts -= n - sent;
+        for(uint16_t i = sent; i < n; ++i)
+            stats->tx_bytes -= rte_pktmbuf_pkt_len(unsent[i]);
+        drop_frames(unsent + sent, n - sent);
+    }
+}
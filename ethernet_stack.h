@@ -4,12 +4,80 @@
 #ifndef ETHERNET_STACK_H__
 #define ETHERNET_STACK_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <rte_mbuf.h>
+#include <rte_mempool.h>
 
 #include "router.h"
 
-int handle_frame(intf_cfg_t *cfg, struct rte_mbuf *mbuf);
+void handle_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n);
 int send_frame(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
                 uint8_t intf, struct ether_addr *d_ether);
+int send_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n,
+                uint8_t intf);
+int send_l2_frames(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n,
+                    uint8_t intf);
+void flush_frames(intf_cfg_t *cfg);
+int setup_tx_port(intf_cfg_t *cfg, uint8_t intf, uint16_t queue, int retries);
+void free_tx_ports(intf_cfg_t *cfg);
+
+/*********************************
+ *  Inline function definitions  *
+ *********************************/
+/**
+ * \brief Check if the NIC classified a frame as IPv4 in untagged ethernet.
+ *
+ * PMDs without packet type support leave the type 0 -> The caller falls back
+ * to the ethertype.
+ *
+ * \param ptype The packet type of the buffer.
+ *
+ * \return true if the frame contains IPv4 right behind the ethernet header.
+ */
+static inline bool is_ipv4_ptype(uint32_t ptype)
+{
+    return (ptype & RTE_PTYPE_L2_MASK) == RTE_PTYPE_L2_ETHER
+            && RTE_ETH_IS_IPV4_HDR(ptype);
+}
+
+/**
+ * \brief Drop a vector of frames.
+ *
+ * Recycles all buffers in the vector. Consecutive single segment buffers
+ * of the same mempool are returned with one rte_mempool_put_bulk() call
+ * instead of one mempool operation per frame.
+ *
+ * \param mbufs The buffers we shall drop.
+ * \param n Number of buffers in mbufs.
+ */
+static inline void drop_frames(struct rte_mbuf **mbufs, uint16_t n)
+{
+    void *pending[THREAD_BUFSIZE];
+    struct rte_mempool *pool = NULL;
+    struct rte_mbuf *m = NULL;
+    uint16_t no_pending = 0;
+
+    for(uint16_t i = 0; i < n; ++i) {
+        if(mbufs[i]->nb_segs != 1) { // Chained buffers take the slow way
+            rte_pktmbuf_free(mbufs[i]);
+            continue;
+        }
+        if((m = rte_pktmbuf_prefree_seg(mbufs[i])) == NULL)
+            continue; // Still referenced by someone else
+
+        if(m->pool != pool || no_pending == THREAD_BUFSIZE) {
+            if(no_pending > 0)
+                rte_mempool_put_bulk(pool, pending, no_pending);
+            pool = m->pool;
+            no_pending = 0;
+        }
+        pending[no_pending++] = m;
+    }
+
+    if(no_pending > 0)
+        rte_mempool_put_bulk(pool, pending, no_pending);
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,271 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_lpm6.h>
+#include <rte_malloc.h>
+
+#include "fib6.h"
+#include "routing_table.h"
+#include "global.h"
+#include "log.h"
+
+// Bits resolved by the first level of LPM6 and by every further level
+#define LPM6_TBL24_BITS 24
+#define LPM6_TBL8_BITS 8
+#define INIT_NO_ROUTES6 1024
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static int get_hop_id6(const struct ether_addr *mac, uint8_t intf);
+static uint32_t count_tbl8s(void);
+static int cmp_tbl8_keys(const void *a, const void *b);
+static int add_default6(uint32_t hop_id);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+struct rte_lpm6 *lpm6 = NULL;
+adj_t *adjs6 = NULL;
+
+// The routes and next hops the table is built from
+static route6_t *routes6 = NULL;
+static uint no_routes6 = 0, routes6_size = 0;
+static rt_entry_t *hops6 = NULL;
+static uint no_hops6 = 0, hops6_size = 0;
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Add a route to the routes the IPv6 table is built from.
+ *
+ * \param net The network address. Bits behind the prefix are ignored.
+ * \param prf The prefix length.
+ * \param mac The MAC of the next hop.
+ * \param intf The egress interface.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_FORMAT: Prefix longer than 128 bit or multicast MAC.
+ *                  ERR_MEM: Not enough memory.
+ *                  ERR_GEN: The table was built already.
+ */
+int fib6_add_route(const uint8_t *net, uint8_t prf,
+                    const struct ether_addr *mac, uint8_t intf)
+{
+    route6_t *tmp = NULL;
+    int hop_id = 0;
+
+    if(prf > RTE_LPM6_MAX_DEPTH || is_multicast_ether_addr(mac))
+        return ERR_FORMAT;
+    if(lpm6 != NULL)
+        return ERR_GEN;
+
+    if(no_routes6 == routes6_size) {
+        routes6_size = routes6_size == 0 ? INIT_NO_ROUTES6 : 2 * routes6_size;
+        if((tmp = realloc(routes6, routes6_size * sizeof(route6_t))) == NULL)
+            return ERR_MEM;
+        routes6 = tmp;
+    }
+    if((hop_id = get_hop_id6(mac, intf)) < 0)
+        return hop_id;
+
+    memset(&routes6[no_routes6], 0, sizeof(route6_t));
+    // Zero the bits behind the prefix -> Equal networks compare equal
+    for(uint8_t bit = 0; bit < prf; bit += 8)
+        routes6[no_routes6].net[bit / 8] = net[bit / 8]
+                        & (prf - bit >= 8 ? 0xFF : 0xFF << (8 - (prf - bit)));
+    routes6[no_routes6].prf = prf;
+    routes6[no_routes6].hop_id = hop_id;
+    no_routes6++;
+    return 0;
+}
+
+/**
+ * \brief Build the IPv6 routing table from all added routes.
+ *
+ * Nothing is built if there are no routes: Every lookup misses.
+ *
+ * \param socket The socket the table is allocated on.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+int build_fib6(int socket)
+{
+    struct rte_lpm6_config config = {
+        .max_rules = no_routes6 + 1,
+        .number_tbl8s = count_tbl8s(),
+        .flags = 0
+    };
+
+    if(no_routes6 == 0)
+        return 0;
+
+    if(
+        (lpm6 = rte_lpm6_create("fib6", socket, &config)) == NULL
+        || (adjs6 = alloc_fib_mem("adjs6", no_hops6 * sizeof(adj_t), socket))
+            == NULL
+    ) {
+        printf("Not enough memory for the IPv6 routing table!\n");
+        clean_fib6();
+        return ERR_MEM;
+    }
+
+    for(uint i = 0; i < no_hops6; ++i)
+        set_adj(&adjs6[i], &hops6[i]);
+
+    // LPM6 has no prefix length 0 -> The default route is added as ::/1 and
+    // 8000::/1 before all others. Added /1 routes replace its halves.
+    for(uint i = 0; i < no_routes6; ++i) {
+        if(routes6[i].prf == 0 && add_default6(routes6[i].hop_id) < 0)
+            return ERR_MEM;
+    }
+    for(uint i = 0; i < no_routes6; ++i) {
+        if(routes6[i].prf > 0 && rte_lpm6_add(lpm6, routes6[i].net,
+                                routes6[i].prf, routes6[i].hop_id) < 0) {
+            printf("Cannot add an IPv6 route!\n");
+            clean_fib6();
+            return ERR_MEM;
+        }
+    }
+
+    LOG_INFO("Built the IPv6 routing table: %u routes, %u next hops\n",
+                no_routes6, no_hops6);
+    return 0;
+}
+
+/**
+ * \brief Free the IPv6 routing table and all routes.
+ *
+ * No lcore may use the table anymore.
+ */
+void clean_fib6(void)
+{
+    rte_lpm6_free(lpm6);
+    lpm6 = NULL;
+    rte_free(adjs6);
+    adjs6 = NULL;
+    free(routes6);
+    routes6 = NULL;
+    no_routes6 = routes6_size = 0;
+    free(hops6);
+    hops6 = NULL;
+    no_hops6 = hops6_size = 0;
+}
+
+/**
+ * \brief Get the number of IPv6 routes.
+ */
+uint get_no_routes6(void)
+{
+    return no_routes6;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Get the ID of a next hop. Unknown next hops get a new ID.
+ *
+ * Routes have few distinct next hops -> A linear search is fast enough.
+ *
+ * \return The next hop ID.
+ *          Errors: ERR_MEM: Not enough memory or too many next hops.
+ */
+static int get_hop_id6(const struct ether_addr *mac, uint8_t intf)
+{
+    rt_entry_t *tmp = NULL;
+
+    for(uint i = 0; i < no_hops6; ++i) {
+        if(hops6[i].dst_port == intf
+            && is_same_ether_addr(&hops6[i].dst_mac, mac))
+            return i;
+    }
+
+    if(no_hops6 == FIB6_MAX_NXT_HOPS)
+        return ERR_MEM;
+    if(no_hops6 == hops6_size) {
+        hops6_size = hops6_size == 0 ? INIT_NO_NXT_HOPS : 2 * hops6_size;
+        if((tmp = realloc(hops6, hops6_size * sizeof(rt_entry_t))) == NULL)
+            return ERR_MEM;
+        hops6 = tmp;
+    }
+
+    ether_addr_copy(mac, &hops6[no_hops6].dst_mac);
+    hops6[no_hops6].dst_port = intf;
+    return no_hops6++;
+}
+
+/**
+ * \brief Count the second level tables LPM6 needs for all routes.
+ *
+ * A route of prefix length p needs one table for every 8 bit level below
+ * p, starting after the first 24 bit. Routes share the table of a level if
+ * they agree in all bits above it -> We count the distinct (level, bits
+ * above the level) pairs.
+ *
+ * \return The number of tables. At least 1.
+ */
+static uint32_t count_tbl8s(void)
+{
+    uint8_t (*keys)[IPV6_ADDR_LEN + 1] = NULL;
+    uint32_t no_keys = 0, no_tbl8s = 1;
+    uint8_t *key = NULL;
+
+    for(uint i = 0; i < no_routes6; ++i) {
+        if(routes6[i].prf > LPM6_TBL24_BITS)
+            no_keys += (routes6[i].prf - LPM6_TBL24_BITS + LPM6_TBL8_BITS - 1)
+                        / LPM6_TBL8_BITS;
+    }
+    // Without the memory to count, we reserve a table for every level
+    if(no_keys == 0 || (keys = malloc(no_keys * sizeof(*keys))) == NULL)
+        return RTE_MAX(no_keys, no_tbl8s);
+
+    no_keys = 0;
+    for(uint i = 0; i < no_routes6; ++i) {
+        for(uint level = LPM6_TBL24_BITS; level < routes6[i].prf;
+                level += LPM6_TBL8_BITS) {
+            key = keys[no_keys++];
+            memset(key, 0, IPV6_ADDR_LEN + 1);
+            memcpy(key, routes6[i].net, level / 8);
+            key[IPV6_ADDR_LEN] = level;
+        }
+    }
+
+    qsort(keys, no_keys, sizeof(*keys), cmp_tbl8_keys);
+    for(uint32_t i = 1; i < no_keys; ++i)
+        no_tbl8s += cmp_tbl8_keys(keys[i - 1], keys[i]) != 0;
+
+    free(keys);
+    return no_tbl8s;
+}
+
+/**
+ * \brief Compare two keys of count_tbl8s() for qsort().
+ */
+static int cmp_tbl8_keys(const void *a, const void *b)
+{
+    return memcmp(a, b, IPV6_ADDR_LEN + 1);
+}
+
+/**
+ * \brief Add the default route to the built table as its two halves.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory. The table is freed.
+ */
+static int add_default6(uint32_t hop_id)
+{
+    uint8_t half[IPV6_ADDR_LEN] = { 0 };
+
+    if(rte_lpm6_add(lpm6, half, 1, hop_id) == 0) {
+        half[0] = 0x80;
+        if(rte_lpm6_add(lpm6, half, 1, hop_id) == 0)
+            return 0;
+    }
+    printf("Cannot add the IPv6 default route!\n");
+    clean_fib6();
+    return ERR_MEM;
+}
@@ -0,0 +1,84 @@
+/**
+ * This file contains the IPv6 routing table.
+ *
+ * The routes are collected while the arguments are parsed and the table is
+ * built once by build_fib6() before the workers start. The lookups use the
+ * LPM6 library of DPDK. Every route names the MAC of its next hop. The
+ * next hops share the adjacencies of the IPv4 routing table -> The workers
+ * rewrite IPv4 and IPv6 frames the same way.
+ * The table does not change while the workers run -> The workers are no
+ * readers in the sense of register_fib_reader().
+ */
+#ifndef FIB6_H__
+#define FIB6_H__
+
+#include <stdint.h>
+
+#include <rte_config.h>
+#include <rte_ether.h>
+#include <rte_lpm6.h>
+
+#include "routing_table_additional.h"
+
+#define IPV6_ADDR_LEN RTE_LPM6_IPV6_ADDR_SIZE
+// Next hop IDs are stored in 21 bit of the LPM6 entries
+#define FIB6_MAX_NXT_HOPS (1 << 21)
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+typedef struct route6 {
+    uint8_t net[IPV6_ADDR_LEN];
+    uint8_t prf;
+    uint32_t hop_id;
+} route6_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int fib6_add_route(const uint8_t *net, uint8_t prf,
+                    const struct ether_addr *mac, uint8_t intf);
+int build_fib6(int socket);
+void clean_fib6(void);
+uint get_no_routes6(void);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern struct rte_lpm6 *lpm6;
+extern adj_t *adjs6;
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Look up the next hops of a vector of IPv6 addresses.
+ *
+ * \param ips The destination addresses.
+ * \param hop_ids The next hop IDs. -1 if there is no route to the address.
+ * \param n Number of addresses.
+ */
+static inline void fib6_lookup_bulk(uint8_t ips[][IPV6_ADDR_LEN],
+                                    int32_t *hop_ids, uint32_t n)
+{
+    if(lpm6 == NULL) {
+        for(uint32_t i = 0; i < n; ++i)
+            hop_ids[i] = -1;
+        return;
+    }
+    rte_lpm6_lookup_bulk_func(lpm6, ips, hop_ids, n);
+}
+
+/**
+ * \brief Get the adjacency of an IPv6 next hop ID.
+ *
+ * \return The adjacency or NULL if the ID is the 'no route to host' ID.
+ */
+static inline const adj_t *get_adj6(int32_t hop_id)
+{
+    if(hop_id < 0)
+        return NULL;
+    return adjs6 + hop_id;
+}
+
+#endif
@@ -0,0 +1,811 @@
+/*
+ * This file contains the lookup engines that can replace the Dir-24-8 tables.
+ *
+ * TBL24 alone has 64MB. Thus, nearly every lookup of mixed destinations is a
+ * cache miss. DXR and Poptrie compress the routes to a few MB that stay
+ * in the caches of the lcores:
+ *  - DXR splits the address space into ranges of addresses with the same
+ *    next hop. A direct table indexed by the upper 16 bits of an address
+ *    either holds the next hop or the ranges of this /16 chunk. The ranges
+ *    are searched with a binary search.
+ *  - Poptrie uses the same direct table and a multiway trie with 64 slots per
+ *    node below. The children and leaves of a node are stored consecutively
+ *    and found by counting the bits set in the bitmaps of the node.
+ * Both engines are built from the ranges of the routes.
+ *
+ * The LPM library of DPDK is offered as reference.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_lpm.h>
+
+#include "fib_engines.h"
+#include "global.h"
+#include "log.h"
+
+// DXR and Poptrie use 16 bit next hop IDs as proposed in the papers
+#define MAX_COMPRESSED_NXT_HOPS (1 << 16)
+// Number of bits of an address indexing the direct tables
+#define DIRECT_BITS 16
+#define NO_DIRECT_ENTRIES (1 << DIRECT_BITS)
+// Distance of the address whose direct entry we prefetch in bulk lookups
+#define PREFETCH_OFFSET 4
+
+#define POPTRIE_STRIDE 6
+#define POPTRIE_LEAF (UINT32_C(1) << 31) // Direct entry is a next hop ID
+#define INIT_POPTRIE_SIZE 1024
+
+// rte_lpm stores 24 bit next hops
+#define LPM_MAX_NXT_HOPS (1 << 24)
+#define LPM_NXT_HOP_MASK 0x00FFFFFF
+#define LPM_BULK_SIZE 64
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+/*
+ * A range of addresses with the same next hop. It ends before the start of
+ * the next range.
+ */
+typedef struct fib_range {
+    uint32_t start;
+    uint32_t hop_id;
+} fib_range_t;
+
+typedef struct dxr_direct {
+    uint32_t base; // First range of the chunk or next hop ID if count is 0
+    uint32_t count; // Number of ranges in the chunk
+} dxr_direct_t;
+
+typedef struct dxr_range {
+    uint16_t start; // Lower 16 bits of the first address
+    uint16_t hop_id;
+} dxr_range_t;
+
+typedef struct dxr {
+    dxr_direct_t direct[NO_DIRECT_ENTRIES];
+    dxr_range_t *ranges;
+    uint32_t no_ranges;
+} dxr_t;
+
+typedef struct poptrie_node {
+    uint64_t vector; // Slots with a child node
+    uint64_t leafvec; // Slots starting a run of leaves with the same next hop
+    uint32_t base0; // First leaf
+    uint32_t base1; // First child node
+} poptrie_node_t;
+
+typedef struct poptrie {
+    uint32_t direct[NO_DIRECT_ENTRIES]; // POPTRIE_LEAF | next hop ID or node
+    poptrie_node_t *nodes;
+    uint16_t *leaves;
+    uint32_t no_nodes;
+    uint32_t no_leaves;
+} poptrie_t;
+
+/*
+ * Growing arrays of a Poptrie while we build it.
+ */
+typedef struct poptrie_builder {
+    fib_range_t *ranges;
+    uint32_t no_ranges;
+    poptrie_node_t *nodes;
+    uint32_t no_nodes;
+    uint32_t size_nodes;
+    uint16_t *leaves;
+    uint32_t no_leaves;
+    uint32_t size_leaves;
+} poptrie_builder_t;
+
+/*
+ * rte_lpm does not store routes with a prefix length of 0.
+ */
+typedef struct lpm {
+    struct rte_lpm *lpm;
+    uint32_t default_hop_id;
+    size_t size;
+} lpm_t;
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static int cmp_routes(const void *a, const void *b);
+static uint32_t build_ranges(tmp_route_t *const *routes, uint n,
+                                fib_range_t **out);
+static bool get_uniform_hop(const fib_range_t *ranges, uint32_t n,
+                            uint32_t first, uint32_t last, uint32_t *hop_id);
+static int dxr_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n);
+static void dxr_free(void *tbl);
+static uint32_t dxr_lookup(const void *tbl, uint32_t dst_ip_cpu_bo);
+static void dxr_lookup_bulk(const void *tbl, const uint32_t *ips,
+                            uint32_t *hop_ids, uint32_t n);
+static size_t dxr_memory(const void *tbl);
+static int poptrie_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n);
+static int poptrie_fill_node(poptrie_builder_t *b, uint32_t node,
+                                uint64_t base, uint off);
+static int poptrie_alloc_nodes(poptrie_builder_t *b, uint32_t n);
+static int poptrie_add_leaf(poptrie_builder_t *b, uint32_t hop_id);
+static void poptrie_free(void *tbl);
+static uint32_t poptrie_lookup(const void *tbl, uint32_t dst_ip_cpu_bo);
+static void poptrie_lookup_bulk(const void *tbl, const uint32_t *ips,
+                                uint32_t *hop_ids, uint32_t n);
+static size_t poptrie_memory(const void *tbl);
+static int lpm_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n);
+static void lpm_free(void *tbl);
+static uint32_t lpm_lookup(const void *tbl, uint32_t dst_ip_cpu_bo);
+static void lpm_lookup_bulk(const void *tbl, const uint32_t *ips,
+                            uint32_t *hop_ids, uint32_t n);
+static size_t lpm_memory(const void *tbl);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+const fib_engine_t dxr_engine = {
+    .name = "dxr",
+    .build = dxr_build,
+    .free = dxr_free,
+    .lookup = dxr_lookup,
+    .lookup_bulk = dxr_lookup_bulk,
+    .memory = dxr_memory
+};
+
+const fib_engine_t poptrie_engine = {
+    .name = "poptrie",
+    .build = poptrie_build,
+    .free = poptrie_free,
+    .lookup = poptrie_lookup,
+    .lookup_bulk = poptrie_lookup_bulk,
+    .memory = poptrie_memory
+};
+
+const fib_engine_t lpm_engine = {
+    .name = "lpm",
+    .build = lpm_build,
+    .free = lpm_free,
+    .lookup = lpm_lookup,
+    .lookup_bulk = lpm_lookup_bulk,
+    .memory = lpm_memory
+};
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Order routes by their first address, shorter prefixes first.
+ */
+static int cmp_routes(const void *a, const void *b)
+{
+    const tmp_route_t *r1 = *(tmp_route_t *const *)a;
+    const tmp_route_t *r2 = *(tmp_route_t *const *)b;
+    uint32_t net1 = r1->dst_net_cpu_bo & r1->netmask_cpu_bo;
+    uint32_t net2 = r2->dst_net_cpu_bo & r2->netmask_cpu_bo;
+
+    if(net1 != net2)
+        return net1 < net2 ? -1 : 1;
+    return (int)r1->prf - (int)r2->prf;
+}
+
+/**
+ * \brief Append a range to a list of ranges.
+ *
+ * A range with the same next hop as the last one extends the last range.
+ */
+static inline void add_range(fib_range_t *ranges, uint32_t *n,
+                                uint32_t start, uint32_t hop_id)
+{
+    if(*n > 0 && ranges[*n - 1].hop_id == hop_id)
+        return;
+    ranges[*n].start = start;
+    ranges[*n].hop_id = hop_id;
+    ++*n;
+}
+
+/**
+ * \brief Split the address space into ranges with the same next hop.
+ *
+ * We walk through the routes ordered by their first address and keep a
+ * stack of the routes containing the current address. The top of the stack
+ * is the longest matching route.
+ * Addresses without a route get the next hop ID 0.
+ *
+ * \param routes The routes with their next hop IDs.
+ * \param n Number of routes.
+ * \param out The ranges ordered by their start. The first range starts
+ *              at 0. Must be freed by the caller.
+ *
+ * \return The number of ranges. 0 if there is not enough memory.
+ */
+static uint32_t build_ranges(tmp_route_t *const *routes, uint n,
+                                fib_range_t **out)
+{
+    // The bottom of the stack is the whole address space without a route
+    struct {
+        uint64_t end; // First address after the route
+        uint32_t hop_id;
+    } stack[RTE_LPM_MAX_DEPTH + 2];
+    tmp_route_t **sorted = NULL;
+    fib_range_t *ranges = NULL;
+    uint64_t cur = 0, start = 0;
+    uint32_t no_ranges = 0;
+    int top = 0;
+    uint i = 0;
+
+    // Every route starts at most two ranges
+    if(
+        (sorted = malloc((n + 1) * sizeof(tmp_route_t *))) == NULL
+        || (ranges = malloc((2 * n + 1) * sizeof(fib_range_t))) == NULL
+    ) {
+        free(sorted);
+        return 0;
+    }
+    memcpy(sorted, routes, n * sizeof(tmp_route_t *));
+    qsort(sorted, n, sizeof(tmp_route_t *), cmp_routes);
+
+    stack[0].end = UINT64_C(1) << 32;
+    stack[0].hop_id = 0;
+    for(i = 0; i <= n; ++i) {
+        // After the last route we close all routes
+        start = i < n ?
+                    sorted[i]->dst_net_cpu_bo & sorted[i]->netmask_cpu_bo :
+                    UINT64_C(1) << 32;
+
+        // Close the routes ending before this one
+        while(top >= 0 && stack[top].end <= start) {
+            if(cur < stack[top].end) {
+                add_range(ranges, &no_ranges, cur, stack[top].hop_id);
+                cur = stack[top].end;
+            }
+            --top;
+        }
+        if(i == n)
+            break;
+
+        if(cur < start) {
+            add_range(ranges, &no_ranges, cur, stack[top].hop_id);
+            cur = start;
+        }
+        ++top;
+        stack[top].end = start + (UINT64_C(1) << (32 - sorted[i]->prf));
+        stack[top].hop_id = sorted[i]->hop_id;
+    }
+
+    free(sorted);
+    *out = ranges;
+    return no_ranges;
+}
+
+/**
+ * \brief Check if all addresses of an interval share the same next hop.
+ *
+ * \param ranges The ranges returned by build_ranges().
+ * \param n Number of ranges.
+ * \param first The first address of the interval.
+ * \param last The last address of the interval.
+ * \param hop_id The next hop ID of the first address.
+ *
+ * \return If the interval is covered by a single range.
+ */
+static bool get_uniform_hop(const fib_range_t *ranges, uint32_t n,
+                            uint32_t first, uint32_t last, uint32_t *hop_id)
+{
+    uint32_t lo = 0, hi = n, mid = 0;
+
+    // ranges[lo].start <= first < ranges[hi].start
+    while(hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if(ranges[mid].start <= first)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    *hop_id = ranges[lo].hop_id;
+    return lo + 1 == n || ranges[lo + 1].start > last;
+}
+
+/*********************************
+ *              DXR              *
+ *********************************/
+/**
+ * \brief Build the DXR structure of a set of routes.
+ *
+ * \param fib The structure the engine belongs to. Its next hop IDs are
+ *              assigned.
+ * \param routes The routes in any order.
+ * \param n The number of routes.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_GEN: Too many next hops.
+ */
+static int dxr_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n)
+{
+    fib_range_t *ranges = NULL;
+    dxr_range_t *chunk_ranges = NULL;
+    dxr_t *dxr = NULL;
+    uint32_t no_ranges = 0, no_chunk_ranges = 0, chunk = 0, r = 0, e = 0;
+    uint64_t chunk_start = 0, chunk_end = 0;
+    int ret = ERR_MEM;
+
+    if(fib->no_nxt_hops > MAX_COMPRESSED_NXT_HOPS) {
+        printf("DXR supports at most %d next hops!\n",
+                MAX_COMPRESSED_NXT_HOPS);
+        return ERR_GEN;
+    }
+
+    // Every range starts in one chunk. Additionally, every chunk repeats the
+    // range containing its first address
+    if(
+        (no_ranges = build_ranges(routes, n, &ranges)) == 0
+        || (chunk_ranges = malloc((no_ranges + NO_DIRECT_ENTRIES)
+                                    * sizeof(dxr_range_t))) == NULL
+        || (dxr = alloc_fib_mem("dxr", sizeof(dxr_t), fib->socket)) == NULL
+    )
+        goto out;
+
+    for(chunk = 0; chunk < NO_DIRECT_ENTRIES; ++chunk) {
+        chunk_start = (uint64_t)chunk << 16;
+        chunk_end = chunk_start + (1 << 16);
+
+        // ranges[r] contains the first address of the chunk
+        while(r + 1 < no_ranges && ranges[r + 1].start <= chunk_start)
+            ++r;
+        for(e = r + 1; e < no_ranges && ranges[e].start < chunk_end; ++e)
+            ;
+
+        if(e == r + 1) { // The whole chunk uses one next hop
+            dxr->direct[chunk].base = ranges[r].hop_id;
+            continue;
+        }
+
+        dxr->direct[chunk].base = no_chunk_ranges;
+        dxr->direct[chunk].count = e - r;
+        chunk_ranges[no_chunk_ranges].start = 0;
+        chunk_ranges[no_chunk_ranges++].hop_id = ranges[r].hop_id;
+        for(++r; r < e; ++r) {
+            chunk_ranges[no_chunk_ranges].start = (uint16_t)ranges[r].start;
+            chunk_ranges[no_chunk_ranges++].hop_id = ranges[r].hop_id;
+        }
+        r = e - 1;
+    }
+
+    if((dxr->ranges = alloc_fib_mem("dxr_ranges",
+                        RTE_MAX(no_chunk_ranges, 1U) * sizeof(dxr_range_t),
+                        fib->socket)) == NULL)
+        goto out;
+    memcpy(dxr->ranges, chunk_ranges, no_chunk_ranges * sizeof(dxr_range_t));
+    dxr->no_ranges = no_chunk_ranges;
+
+    fib->engine_tbl = dxr;
+    dxr = NULL;
+    ret = 0;
+
+    LOG_INFO("DXR: %u ranges in %u routes\n", no_chunk_ranges, n);
+
+out:
+    if(ret < 0)
+        printf("Not enough memory for the DXR structure!\n");
+    dxr_free(dxr);
+    free(chunk_ranges);
+    free(ranges);
+    return ret;
+}
+
+static void dxr_free(void *tbl)
+{
+    dxr_t *dxr = tbl;
+
+    if(dxr == NULL)
+        return;
+    rte_free(dxr->ranges);
+    rte_free(dxr);
+}
+
+/**
+ * \brief Get the next hop ID of an IPv4 address from a DXR structure.
+ *
+ * \param tbl The DXR structure.
+ * \param dst_ip_cpu_bo The destination IP in CPU byte order (little endian)
+ *
+ * \return The next hop ID. 0 if there is no route to this address.
+ */
+static uint32_t dxr_lookup(const void *tbl, uint32_t dst_ip_cpu_bo)
+{
+    const dxr_t *dxr = tbl;
+    const dxr_direct_t *direct = &dxr->direct[dst_ip_cpu_bo >> 16];
+    const dxr_range_t *ranges = NULL;
+    const uint16_t key = (uint16_t)dst_ip_cpu_bo;
+    uint32_t lo = 0, hi = direct->count, mid = 0;
+
+    if(hi == 0)
+        return direct->base;
+
+    // ranges[lo].start <= key < ranges[hi].start
+    ranges = dxr->ranges + direct->base;
+    while(hi - lo > 1) {
+        mid = (lo + hi) / 2;
+        if(ranges[mid].start <= key)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return ranges[lo].hop_id;
+}
+
+static void dxr_lookup_bulk(const void *tbl, const uint32_t *ips,
+                            uint32_t *hop_ids, uint32_t n)
+{
+    const dxr_t *dxr = tbl;
+    uint32_t i = 0;
+
+    for(i = 0; i < n; ++i) {
+        if(i + PREFETCH_OFFSET < n)
+            rte_prefetch0(&dxr->direct[ips[i + PREFETCH_OFFSET] >> 16]);
+        hop_ids[i] = dxr_lookup(dxr, ips[i]);
+    }
+}
+
+static size_t dxr_memory(const void *tbl)
+{
+    const dxr_t *dxr = tbl;
+
+    return sizeof(dxr_t) + dxr->no_ranges * sizeof(dxr_range_t);
+}
+
+/*********************************
+ *            Poptrie            *
+ *********************************/
+/**
+ * \brief Build the Poptrie structure of a set of routes.
+ *
+ * See dxr_build().
+ */
+static int poptrie_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n)
+{
+    poptrie_builder_t b;
+    poptrie_t *poptrie = NULL;
+    uint32_t chunk = 0, first = 0, hop_id = 0;
+    int node = 0, ret = ERR_MEM;
+
+    if(fib->no_nxt_hops > MAX_COMPRESSED_NXT_HOPS) {
+        printf("Poptrie supports at most %d next hops!\n",
+                MAX_COMPRESSED_NXT_HOPS);
+        return ERR_GEN;
+    }
+
+    memset(&b, 0, sizeof(b));
+    if(
+        (b.no_ranges = build_ranges(routes, n, &b.ranges)) == 0
+        || (poptrie = alloc_fib_mem("poptrie", sizeof(poptrie_t),
+                                    fib->socket)) == NULL
+    )
+        goto out;
+
+    for(chunk = 0; chunk < NO_DIRECT_ENTRIES; ++chunk) {
+        first = chunk << 16;
+        if(get_uniform_hop(b.ranges, b.no_ranges, first, first + 0xFFFF,
+                            &hop_id)) {
+            poptrie->direct[chunk] = POPTRIE_LEAF | hop_id;
+            continue;
+        }
+
+        if(
+            (node = poptrie_alloc_nodes(&b, 1)) < 0
+            || poptrie_fill_node(&b, node, (uint64_t)first << 32,
+                                    DIRECT_BITS) < 0
+        )
+            goto out;
+        poptrie->direct[chunk] = node;
+    }
+
+    if(
+        (poptrie->nodes = alloc_fib_mem("poptrie_nodes",
+                            RTE_MAX(b.no_nodes, 1U) * sizeof(poptrie_node_t),
+                            fib->socket)) == NULL
+        || (poptrie->leaves = alloc_fib_mem("poptrie_leaves",
+                            RTE_MAX(b.no_leaves, 1U) * sizeof(uint16_t),
+                            fib->socket)) == NULL
+    )
+        goto out;
+    memcpy(poptrie->nodes, b.nodes, b.no_nodes * sizeof(poptrie_node_t));
+    memcpy(poptrie->leaves, b.leaves, b.no_leaves * sizeof(uint16_t));
+    poptrie->no_nodes = b.no_nodes;
+    poptrie->no_leaves = b.no_leaves;
+
+    fib->engine_tbl = poptrie;
+    poptrie = NULL;
+    ret = 0;
+
+    LOG_INFO("Poptrie: %u nodes and %u leaves for %u routes\n",
+            b.no_nodes, b.no_leaves, n);
+
+out:
+    if(ret < 0)
+        printf("Not enough memory for the Poptrie structure!\n");
+    poptrie_free(poptrie);
+    free(b.ranges);
+    free(b.nodes);
+    free(b.leaves);
+    return ret;
+}
+
+/**
+ * \brief Fill a node of a Poptrie and all nodes below it.
+ *
+ * A node covers 2^(32 - off) addresses. The addresses are extended to 64
+ * bits by appending zeros. Thus, the last level of nodes uses the same
+ * stride and every slot covers at most a single address.
+ *
+ * \param b The Poptrie we build.
+ * \param node The index of the node.
+ * \param base The first address of the node extended to 64 bits.
+ * \param off The number of address bits consumed above this node.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int poptrie_fill_node(poptrie_builder_t *b, uint32_t node,
+                                uint64_t base, uint off)
+{
+    const uint64_t slot_size = UINT64_C(1) << (64 - off - POPTRIE_STRIDE);
+    uint64_t vector = 0, leafvec = 0, first = 0;
+    uint32_t base0 = b->no_leaves, hop_id = 0, prev_hop_id = 0;
+    int children = 0;
+    uint slot = 0;
+
+    // Slots with the same next hop as the previous leaf share its leaf
+    for(slot = 0; slot < 64; ++slot) {
+        first = base + slot * slot_size;
+        if(!get_uniform_hop(b->ranges, b->no_ranges, first >> 32,
+                            (first + slot_size - 1) >> 32, &hop_id)) {
+            vector |= UINT64_C(1) << slot;
+            continue;
+        }
+        if(leafvec != 0 && hop_id == prev_hop_id)
+            continue;
+        if(poptrie_add_leaf(b, hop_id) < 0)
+            return ERR_MEM;
+        leafvec |= UINT64_C(1) << slot;
+        prev_hop_id = hop_id;
+    }
+
+    // The children are stored consecutively -> Allocate them before we
+    // fill them
+    if((children = poptrie_alloc_nodes(b, __builtin_popcountll(vector))) < 0)
+        return ERR_MEM;
+    b->nodes[node].vector = vector;
+    b->nodes[node].leafvec = leafvec;
+    b->nodes[node].base0 = base0;
+    b->nodes[node].base1 = children;
+
+    for(slot = 0; slot < 64; ++slot) {
+        if(((vector >> slot) & 1) == 0)
+            continue;
+        if(poptrie_fill_node(b, children++, base + slot * slot_size,
+                                off + POPTRIE_STRIDE) < 0)
+            return ERR_MEM;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Allocate consecutive nodes of a Poptrie.
+ *
+ * \return The index of the first node.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int poptrie_alloc_nodes(poptrie_builder_t *b, uint32_t n)
+{
+    poptrie_node_t *nodes = NULL;
+    uint32_t first = b->no_nodes, size = b->size_nodes;
+
+    if(first + n > size) {
+        size = RTE_MAX(RTE_MAX(2 * size, first + n),
+                        (uint32_t)INIT_POPTRIE_SIZE);
+        if((nodes = realloc(b->nodes, size * sizeof(poptrie_node_t))) == NULL)
+            return ERR_MEM;
+        b->nodes = nodes;
+        b->size_nodes = size;
+    }
+
+    b->no_nodes += n;
+    return first;
+}
+
+/**
+ * \brief Append a leaf to a Poptrie.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int poptrie_add_leaf(poptrie_builder_t *b, uint32_t hop_id)
+{
+    uint16_t *leaves = NULL;
+    uint32_t size = b->size_leaves;
+
+    if(b->no_leaves == size) {
+        size = RTE_MAX(2 * size, (uint32_t)INIT_POPTRIE_SIZE);
+        if((leaves = realloc(b->leaves, size * sizeof(uint16_t))) == NULL)
+            return ERR_MEM;
+        b->leaves = leaves;
+        b->size_leaves = size;
+    }
+
+    b->leaves[b->no_leaves++] = hop_id;
+    return 0;
+}
+
+static void poptrie_free(void *tbl)
+{
+    poptrie_t *poptrie = tbl;
+
+    if(poptrie == NULL)
+        return;
+    rte_free(poptrie->nodes);
+    rte_free(poptrie->leaves);
+    rte_free(poptrie);
+}
+
+/**
+ * \brief Get the next hop ID of an IPv4 address from a Poptrie structure.
+ *
+ * \param tbl The Poptrie structure.
+ * \param dst_ip_cpu_bo The destination IP in CPU byte order (little endian)
+ *
+ * \return The next hop ID. 0 if there is no route to this address.
+ */
+static uint32_t poptrie_lookup(const void *tbl, uint32_t dst_ip_cpu_bo)
+{
+    const poptrie_t *poptrie = tbl;
+    const poptrie_node_t *node = NULL;
+    const uint64_t key = (uint64_t)dst_ip_cpu_bo << 32;
+    uint32_t index = poptrie->direct[dst_ip_cpu_bo >> 16];
+    uint64_t mask = 0;
+    uint off = DIRECT_BITS, slot = 0;
+
+    if(index & POPTRIE_LEAF)
+        return index & ~POPTRIE_LEAF;
+
+    node = poptrie->nodes + index;
+    for(;;) {
+        slot = (key >> (64 - POPTRIE_STRIDE - off)) & 63;
+        mask = (UINT64_C(2) << slot) - 1; // Slots up to this one
+        if(((node->vector >> slot) & 1) == 0)
+            return poptrie->leaves[
+                        node->base0 + __builtin_popcountll(node->leafvec & mask)
+                        - 1
+                    ];
+        node = poptrie->nodes + node->base1
+                + __builtin_popcountll(node->vector & mask) - 1;
+        off += POPTRIE_STRIDE;
+    }
+}
+
+static void poptrie_lookup_bulk(const void *tbl, const uint32_t *ips,
+                                uint32_t *hop_ids, uint32_t n)
+{
+    const poptrie_t *poptrie = tbl;
+    uint32_t i = 0;
+
+    for(i = 0; i < n; ++i) {
+        if(i + PREFETCH_OFFSET < n)
+            rte_prefetch0(&poptrie->direct[ips[i + PREFETCH_OFFSET] >> 16]);
+        hop_ids[i] = poptrie_lookup(poptrie, ips[i]);
+    }
+}
+
+static size_t poptrie_memory(const void *tbl)
+{
+    const poptrie_t *poptrie = tbl;
+
+    return sizeof(poptrie_t)
+            + poptrie->no_nodes * sizeof(poptrie_node_t)
+            + poptrie->no_leaves * sizeof(uint16_t);
+}
+
+/*********************************
+ *            rte_lpm            *
+ *********************************/
+/**
+ * \brief Build an rte_lpm structure of a set of routes.
+ *
+ * See dxr_build().
+ */
+static int lpm_build(dir24_8_t *fib, tmp_route_t *const *routes, uint n)
+{
+    static uint no_lpms = 0; // rte_lpm requires unique names
+    struct rte_lpm_config config;
+    char name[RTE_LPM_NAMESIZE];
+    lpm_t *lpm = NULL;
+    uint i = 0;
+
+    if(fib->no_nxt_hops > LPM_MAX_NXT_HOPS) {
+        printf("rte_lpm supports at most %d next hops!\n", LPM_MAX_NXT_HOPS);
+        return ERR_GEN;
+    }
+
+    // Every route longer than /24 requires at most one TBL8 group
+    memset(&config, 0, sizeof(config));
+    config.max_rules = RTE_MAX(n, 1U);
+    config.number_tbl8s = 1;
+    for(i = 0; i < n; ++i)
+        if(routes[i]->prf > 24)
+            ++config.number_tbl8s;
+
+    if((lpm = alloc_fib_mem("lpm", sizeof(lpm_t), fib->socket)) == NULL)
+        return ERR_MEM;
+    snprintf(name, sizeof(name), "fib_lpm_%u", no_lpms++);
+    if((lpm->lpm = rte_lpm_create(name, fib->socket, &config)) == NULL) {
+        printf("Not enough memory for the rte_lpm structure!\n");
+        rte_free(lpm);
+        return ERR_MEM;
+    }
+
+    for(i = 0; i < n; ++i) {
+        if(routes[i]->prf == 0) {
+            lpm->default_hop_id = routes[i]->hop_id;
+            continue;
+        }
+        if(rte_lpm_add(lpm->lpm, routes[i]->dst_net_cpu_bo, routes[i]->prf,
+                        routes[i]->hop_id) < 0) {
+            printf("Cannot add a route to the rte_lpm structure!\n");
+            lpm_free(lpm);
+            return ERR_GEN;
+        }
+    }
+
+    lpm->size = sizeof(struct rte_lpm)
+                + (size_t)config.number_tbl8s
+                    * RTE_LPM_TBL8_GROUP_NUM_ENTRIES
+                    * sizeof(struct rte_lpm_tbl_entry);
+    fib->engine_tbl = lpm;
+    return 0;
+}
+
+static void lpm_free(void *tbl)
+{
+    lpm_t *lpm = tbl;
+
+    if(lpm == NULL)
+        return;
+    rte_lpm_free(lpm->lpm);
+    rte_free(lpm);
+}
+
+static uint32_t lpm_lookup(const void *tbl, uint32_t dst_ip_cpu_bo)
+{
+    const lpm_t *lpm = tbl;
+    uint32_t hop_id = 0;
+
+    if(rte_lpm_lookup(lpm->lpm, dst_ip_cpu_bo, &hop_id) == 0)
+        return hop_id;
+    return lpm->default_hop_id;
+}
+
+static void lpm_lookup_bulk(const void *tbl, const uint32_t *ips,
+                            uint32_t *hop_ids, uint32_t n)
+{
+    const lpm_t *lpm = tbl;
+    uint32_t i = 0, j = 0, cnt = 0;
+
+    // The bulk lookup of rte_lpm keeps its state on the stack
+    for(i = 0; i < n; i += cnt) {
+        cnt = RTE_MIN(n - i, (uint32_t)LPM_BULK_SIZE);
+        rte_lpm_lookup_bulk(lpm->lpm, ips + i, hop_ids + i, cnt);
+        for(j = i; j < i + cnt; ++j)
+            hop_ids[j] = hop_ids[j] & RTE_LPM_LOOKUP_SUCCESS ?
+                            hop_ids[j] & LPM_NXT_HOP_MASK :
+                            lpm->default_hop_id;
+    }
+}
+
+static size_t lpm_memory(const void *tbl)
+{
+    return ((const lpm_t *)tbl)->size;
+}
@@ -0,0 +1,17 @@
+/**
+ * This file declares the lookup engines that can replace the Dir-24-8
+ * tables. See fib_engine_t.
+ */
+#ifndef FIB_ENGINES_H__
+#define FIB_ENGINES_H__
+
+#include "routing_table_additional.h"
+
+// DXR: Ranges of addresses with the same next hop, searched per /16
+extern const fib_engine_t dxr_engine;
+// Poptrie: Multiway trie with popcount compressed nodes and leaves
+extern const fib_engine_t poptrie_engine;
+// The LPM library of DPDK
+extern const fib_engine_t lpm_engine;
+
+#endif
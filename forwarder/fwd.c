@@ -144,12 +144,12 @@ int main(int argc, char* argv[]) {
 	/* open hardware queues */
 	if (src_interface == dst_interface) {
 		/* open 1x RX and 1xTX for src */
-		configure_device(src_interface, 1);
+		configure_device(src_interface, 1, 1, false);
 		printf("same interface\n");
 	} else {
 		/* open 1x RX and 1xTX for src/dst */
-		configure_device(dst_interface, 1);
-		configure_device(src_interface, 1);
+		configure_device(dst_interface, 1, 1, false);
+		configure_device(src_interface, 1, 1, false);
 	}
 	printf("Forwarding from interface %i to interface %i\n", src_interface, dst_interface);
 
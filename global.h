@@ -16,6 +16,7 @@
 #define ERR_NOTFORME -9
 #define ERR_TTL_EXP -10
 #define ERR_NO_ROUTE -11
+#define ERR_MISMATCH -12
+#define ERR_RATE_LIMIT -13
 
-#define VERBOSE
 #endif
\ No newline at end of file
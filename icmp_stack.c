@@ -0,0 +1,279 @@
+#include <stdbool.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+
+#include <rte_common.h>
+#include <rte_hash_crc.h>
+#include <rte_icmp.h>
+#include <rte_ip.h>
+#include <rte_log.h>
+#include <rte_mbuf.h>
+#include <rte_meter.h>
+
+#include "icmp_stack.h"
+#include "ethernet_stack.h"
+#include "router.h"
+#include "stats.h"
+#include "global.h"
+
+// Headers prepended to the offending packet
+#define ICMP_ERR_HDR_LEN (sizeof(struct ipv4_hdr) + sizeof(struct icmp_hdr))
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static bool may_send_error(const struct ether_hdr *eth,
+                            const struct ipv4_hdr *ip, uint16_t len);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+static struct rte_meter_srtcm all_bucket;
+static struct rte_meter_srtcm src_buckets[ICMP_SRC_BUCKETS];
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Handle an IPv4 packet addressed to the router.
+ * 
+ * Currently we only answer ICMP echo requests. The request buffer is reused
+ * for the reply.
+ * 
+ * \param cfg The configuration of the interface this packet was received on.
+ * \param mbuf The frame containing the packet. The IPv4 header was already
+ *              checked by the worker.
+ * 
+ * \return 0 if the reply was sent.
+ *          Errors: ERR_INV_PKT: Truncated ICMP message or invalid checksum.
+ *                  ERR_NOTFORME: Neither ICMP nor an echo request.
+ */
+int handle_icmp(intf_cfg_t *cfg, struct rte_mbuf *mbuf)
+{
+    struct ether_hdr *eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    struct ipv4_hdr *ip = (struct ipv4_hdr *)(eth + 1);
+    const uint16_t ihl = (ip->version_ihl & 0x0F) << 2;
+    const uint16_t len = rte_be_to_cpu_16(ip->total_length);
+    struct icmp_hdr *icmp = (struct icmp_hdr *)((char *)ip + ihl);
+    struct ether_addr d_ether;
+
+    if(ip->next_proto_id != IPPROTO_ICMP)
+        return ERR_NOTFORME;
+    if(len < ihl + sizeof(struct icmp_hdr)
+        || rte_raw_cksum(icmp, len - ihl) != 0xFFFF)
+        return ERR_INV_PKT;
+    if(icmp->icmp_type != IP_ICMP_ECHO_REQUEST || icmp->icmp_code != 0)
+        return ERR_NOTFORME;
+
+    icmp->icmp_type = IP_ICMP_ECHO_REPLY;
+    icmp->icmp_cksum = 0;
+    icmp->icmp_cksum = ~rte_raw_cksum(icmp, len - ihl);
+
+    ip->dst_addr = ip->src_addr;
+    ip->src_addr = cfg->ip_addr_be;
+    ip->time_to_live = ICMP_TTL;
+    ip->hdr_checksum = 0;
+    ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+    ether_addr_copy(&eth->s_addr, &d_ether);
+    return send_frame(cfg, mbuf, cfg->intf, &d_ether);
+}
+
+/**
+ * \brief Configure the rate limits of the ICMP errors.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_CFG: Invalid rate or burst.
+ */
+int init_icmp_errors(void)
+{
+    // Every error costs one token -> Rates in errors per second
+    struct rte_meter_srtcm_params all = {
+        .cir = ICMP_ERR_RATE, .cbs = ICMP_ERR_BURST, .ebs = 0
+    };
+    struct rte_meter_srtcm_params src = {
+        .cir = ICMP_SRC_RATE, .cbs = ICMP_SRC_BURST, .ebs = 0
+    };
+
+    int level = rte_log_get_level(RTE_LOGTYPE_METER), err = 0;
+
+    // Every config call logs the bucket at INFO -> Keep the log quiet,
+    // configure one bucket per rate and copy it
+    rte_log_set_level(RTE_LOGTYPE_METER, RTE_LOG_WARNING);
+    if(
+        rte_meter_srtcm_config(&all_bucket, &all) != 0
+        || rte_meter_srtcm_config(&src_buckets[0], &src) != 0
+    )
+        err = ERR_CFG;
+    if(level >= 0)
+        rte_log_set_level(RTE_LOGTYPE_METER, (uint32_t)level);
+    if(err < 0)
+        return err;
+
+    for(uint i = 1; i < ICMP_SRC_BUCKETS; ++i)
+        src_buckets[i] = src_buckets[0];
+    return 0;
+}
+
+/**
+ * \brief Answer a packet the router cannot forward with an ICMP error.
+ *
+ * No error is sent for packets RFC 1812 exempts: ICMP errors, fragments
+ * other than the first one, link layer broadcasts and packets from or to
+ * addresses that do not identify a single host. Otherwise the error is
+ * sent if the tokens of the source and of the router allow it.
+ *
+ * The error goes back to the MAC the packet came from: It is the previous
+ * hop and reaches the source. Must only be called by the slow path.
+ *
+ * \param cfg The configuration of the interface the packet was received on.
+ * \param mbuf The frame containing the packet. Its IPv4 header must be the
+ *              one received. The buffer is reused for the error if it is
+ *              sent, otherwise the caller still owns it.
+ * \param type The ICMP type of the error.
+ * \param code The ICMP code of the error.
+ * \param now The current TSC.
+ *
+ * \return 0 if the error was sent.
+ *          Errors: ERR_NOTFORME: No error may be sent for the packet.
+ *                  ERR_RATE_LIMIT: The rate limits suppressed the error.
+ *                  ERR_MEM, ERR_NOT_IMPL: See build_icmp_error().
+ */
+int send_icmp_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t type,
+                    uint8_t code, uint64_t now)
+{
+    const struct ether_hdr *eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    const struct ipv4_hdr *ip = (const struct ipv4_hdr *)(eth + 1);
+    const uint32_t src = rte_be_to_cpu_32(ip->src_addr);
+    struct rte_meter_srtcm *bucket = NULL;
+    struct ether_addr d_ether;
+    int err = 0;
+
+    if(!may_send_error(eth, ip, rte_pktmbuf_data_len(mbuf) - ETHER_HDR_LEN))
+        return ERR_NOTFORME;
+
+    // Ask the source first: A single flooding source must not use up the
+    // tokens of all others
+    bucket = &src_buckets[rte_hash_crc_4byte(src, 0) & (ICMP_SRC_BUCKETS - 1)];
+    if(rte_meter_srtcm_color_blind_check(bucket, now, 1) != e_RTE_METER_GREEN
+        || rte_meter_srtcm_color_blind_check(&all_bucket, now, 1)
+            != e_RTE_METER_GREEN) {
+        lcore_stats[cfg->lcore].icmp_limited++;
+        return ERR_RATE_LIMIT;
+    }
+
+    if((err = build_icmp_error(cfg, mbuf, type, code, &d_ether)) < 0)
+        return err;
+    lcore_stats[cfg->lcore].icmp_errors++;
+    return send_frame(cfg, mbuf, cfg->intf, &d_ether);
+}
+
+/**
+ * \brief Turn a frame into an ICMP error about the packet it contains.
+ *
+ * The buffer is reused without copying: The new IPv4 and ICMP headers are
+ * prepended in the headroom and the packet is cut behind the quoted bytes.
+ * The new ethernet header is in front of the new IPv4 header, its
+ * destination is not set.
+ *
+ * \param cfg The configuration of the interface the packet was received on.
+ *              Its address is the source of the error.
+ * \param mbuf The frame containing the offending packet.
+ * \param type The ICMP type of the error.
+ * \param code The ICMP code of the error.
+ * \param d_ether The source MAC of the frame -> The destination of the error.
+ *
+ * \return 0 on success. The buffer is unchanged on errors.
+ *          Errors: ERR_MEM: Not enough headroom in the buffer.
+ *                  ERR_NOT_IMPL: Frame in several segments.
+ */
+int build_icmp_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t type,
+                        uint8_t code, struct ether_addr *d_ether)
+{
+    struct ether_hdr *eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    struct ipv4_hdr *ip = (struct ipv4_hdr *)(eth + 1);
+    const uint16_t len = rte_pktmbuf_data_len(mbuf) - ETHER_HDR_LEN;
+    const uint32_t dst = ip->src_addr;
+    struct icmp_hdr *icmp = NULL;
+    uint16_t quote = (ip->version_ihl & 0x0F) * 4 + ICMP_QUOTE_LEN;
+
+    if(!rte_pktmbuf_is_contiguous(mbuf))
+        return ERR_NOT_IMPL;
+    if(rte_pktmbuf_headroom(mbuf) < ICMP_ERR_HDR_LEN)
+        return ERR_MEM;
+
+    quote = RTE_MIN(quote, RTE_MIN(len, rte_be_to_cpu_16(ip->total_length)));
+    ether_addr_copy(&eth->s_addr, d_ether);
+    rte_pktmbuf_trim(mbuf, len - quote);
+    // The new headers overwrite the old ethernet header
+    eth = (struct ether_hdr *)rte_pktmbuf_prepend(mbuf, ICMP_ERR_HDR_LEN);
+    eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+    ip = (struct ipv4_hdr *)(eth + 1);
+    icmp = (struct icmp_hdr *)(ip + 1);
+
+    icmp->icmp_type = type;
+    icmp->icmp_code = code;
+    icmp->icmp_ident = 0; // Unused
+    icmp->icmp_seq_nb = 0;
+    icmp->icmp_cksum = 0;
+    icmp->icmp_cksum = ~rte_raw_cksum(icmp, sizeof(*icmp) + quote);
+
+    ip->version_ihl = 0x45;
+    ip->type_of_service = 0;
+    ip->total_length = rte_cpu_to_be_16(ICMP_ERR_HDR_LEN + quote);
+    ip->packet_id = 0;
+    ip->fragment_offset = 0;
+    ip->time_to_live = ICMP_TTL;
+    ip->next_proto_id = IPPROTO_ICMP;
+    ip->src_addr = cfg->ip_addr_be;
+    ip->dst_addr = dst;
+    ip->hdr_checksum = 0;
+    ip->hdr_checksum = rte_ipv4_cksum(ip);
+    return 0;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Check if RFC 1812 allows an ICMP error about a packet.
+ *
+ * \param eth The ethernet header of the frame.
+ * \param ip The IPv4 header of the packet.
+ * \param len The length of the packet regarding the link layer.
+ *
+ * \return true if an error may be sent.
+ */
+static bool may_send_error(const struct ether_hdr *eth,
+                            const struct ipv4_hdr *ip, uint16_t len)
+{
+    const uint32_t src = rte_be_to_cpu_32(ip->src_addr);
+    const uint32_t dst = rte_be_to_cpu_32(ip->dst_addr);
+    const uint16_t ihl = (ip->version_ihl & 0x0F) << 2;
+    const struct icmp_hdr *icmp = (const struct icmp_hdr *)((const char *)ip
+                                                                + ihl);
+
+    if(!is_unicast_ether_addr(&eth->d_addr))
+        return false;
+    // Not one host: this network, loopback, multicast, class E, broadcast
+    if((src >> 24) == 0 || (src >> 24) == 127 || src >= IPv4(224, 0, 0, 0)
+        || IS_IPV4_MCAST(dst) || dst == IPv4(255, 255, 255, 255))
+        return false;
+    if(rte_be_to_cpu_16(ip->fragment_offset) & IPV4_HDR_OFFSET_MASK)
+        return false;
+
+    // Never answer an error with an error
+    if(ip->next_proto_id == IPPROTO_ICMP && len > ihl) {
+        switch(icmp->icmp_type) {
+        case ICMP_DEST_UNREACH:
+        case ICMP_SOURCE_QUENCH:
+        case ICMP_REDIRECT:
+        case ICMP_TIME_EXCEEDED:
+        case ICMP_PARAMETERPROB:
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * This file contains methods to handle ICMP packets addressed to the router
+ * and to send ICMP errors.
+ *
+ * ICMP errors are rate limited by token buckets: One for all errors and one
+ * per source (sources share buckets by hash). Only the slow path sends
+ * errors -> The buckets need no locking.
+ */
+#ifndef ICMP_STACK_H__
+#define ICMP_STACK_H__
+
+#include <stdint.h>
+
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#include "router.h"
+
+// TTL of the packets the router originates
+#define ICMP_TTL 64
+// Bytes of the payload quoted after the header of the offending packet
+#define ICMP_QUOTE_LEN 8
+// Rate and burst of all ICMP errors
+#define ICMP_ERR_RATE 1000
+#define ICMP_ERR_BURST 100
+// Rate and burst of the ICMP errors sent to one source
+#define ICMP_SRC_RATE 10
+#define ICMP_SRC_BURST 10
+// Buckets of the per source limit. Must be a power of 2.
+#define ICMP_SRC_BUCKETS 1024
+
+int handle_icmp(intf_cfg_t *cfg, struct rte_mbuf *mbuf);
+int init_icmp_errors(void);
+int send_icmp_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t type,
+                    uint8_t code, uint64_t now);
+int build_icmp_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t type,
+                        uint8_t code, struct ether_addr *d_ether);
+
+#endif
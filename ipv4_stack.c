@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include <rte_ip.h>
 
 #include <rte_mbuf.h>
@@ -9,195 +11,260 @@
 #include "ethernet_stack.h"
 #include "routing_table.h"
 #include "routing_table_additional.h"
+#include "neigh.h"
+#include "slow_path.h"
 #include "global.h"
+#include "log.h"
 
 /*********************************
  *  Static function declarations *
  *********************************/
-static int basic_chks(const void *pkt, uint16_t len);
-static int lookup_and_fwd(intf_cfg_t *cfg, struct rte_mbuf *mbuf, 
-                                const void *pkt);
+static int basic_chks(const void *pkt, uint16_t len, uint64_t ol_flags);
+static int prepare_fwd(intf_cfg_t *cfg, struct ipv4_hdr *hdr, uint16_t len,
+                        uint64_t ol_flags);
+static void lookup_and_fwd(intf_cfg_t *cfg, struct rte_mbuf **mbufs,
+                                uint16_t n);
 
 
 /*********************************
- *  Inline function definitions  *
+ *      Function definitions     *
  *********************************/
-static inline void drop_pkt(struct rte_mbuf *mbuf)
+/**
+ * /brief Handle a burst of received IPv4 packets.
+ * 
+ * Handle all IPv4 packets of a RX burst and forward them to their next hops
+ * if all sanity chacks are okay. We first validate the whole burst, then
+ * lookup the next hops of all remaining packets and finally hand one vector
+ * of packets per egress interface to the ethernet stack.
+ * Packets addressed to this host and packets whose TTL expired are handed to
+ * the slow path. Invalid packets are dropped.
+ * 
+ * \param cfg The configuration of the interface the packets were received on.
+ * \param mbufs The DPDK buffers containing the complete frames. We take
+ *              ownership of the buffers. They are either reused for
+ *              forwarding or dropped.
+ * \param n Number of buffers in mbufs. Must not exceed THREAD_BUFSIZE.
+ */
+void handle_ipv4(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n)
 {
-    rte_pktmbuf_free(mbuf);
-}
+    struct rte_mbuf *fwd[THREAD_BUFSIZE], *drops[THREAD_BUFSIZE];
+    lcore_stats_t *stats = &lcore_stats[cfg->lcore];
+    uint16_t no_fwd = 0, no_drops = 0;
+    struct ipv4_hdr *hdr = NULL;
+    int err = 0;
+
+    for(uint16_t i = 0; i < n; ++i) {
+        hdr = rte_pktmbuf_mtod_offset(mbufs[i], struct ipv4_hdr *,
+                                        ETHER_HDR_LEN);
+        err = prepare_fwd(cfg, hdr,
+                            rte_pktmbuf_data_len(mbufs[i]) - ETHER_HDR_LEN,
+                            mbufs[i]->ol_flags);
+        // The padding of short frames must not be sent on or quoted
+        if(err != ERR_INV_PKT)
+            rte_pktmbuf_trim(mbufs[i], rte_pktmbuf_data_len(mbufs[i])
+                                - ETHER_HDR_LEN
+                                - rte_be_to_cpu_16(hdr->total_length));
+        if(err == 0) {
+            fwd[no_fwd++] = mbufs[i];
+        } else if(err == ERR_NOTFORME) {
+            defer_to_slow(cfg, mbufs[i], SLOW_LOCAL, cfg->intf, 0);
+        } else if(err == ERR_TTL_EXP) {
+            defer_to_slow(cfg, mbufs[i], SLOW_TTL_EXP, cfg->intf, 0);
+        } else {
+            stats->drops[get_drop_reason(err, DROP_IPV4_INV)]++;
+            drops[no_drops++] = mbufs[i];
+        }
+    }
 
+    drop_frames(drops, no_drops);
+
+    if(no_fwd > 0)
+        lookup_and_fwd(cfg, fwd, no_fwd);
+}
 
 /*********************************
- *      Function definitions     *
+ *  Static function definitions  *
  *********************************/
 /**
- * /brief Handle an received IPv4 packet.
+ * /brief Check a single IPv4 packet and prepare it for forwarding.
  * 
- * Handle an IPv4 packet and forward it to the next hop if all sanity chacks
- * are okay. We drop the packet if it is addressed to this host because
- * we do not know what to do with it on a router.
+ * Performs the basic checks on the packet and decrements the TTL if we have
+ * to forward the packet.
  * 
  * \param cfg The configuration of the interface this packet was received on.
- * \param mbuf The DPDK buffer containing the complete frame. This parameter
- *              is neccessary for reusage in the case of forwarding and
- *              memory cleanup if we drop that packet.
- * \param pkt Pointer to the start of the IPv4 packet.
+ * \param hdr Pointer to the start of the IPv4 packet.
  * \param len Length of the IPv4 packet regarding the link layer.
+ * \param ol_flags The RX offload flags of the buffer.
  * 
- * \returns 0 if the packet was forwarded successfully or was addressed to this
- *              host.
+ * \returns 0 if the packet shall be forwarded.
  *              Errors: ERR_INV_PKT: The packet was invalid
+ *                      ERR_NOTFORME: The packet was addressed to this host
  *                      ERR_TTL_EXP: TTL expired in transit. TTL < 0 after
  *                                      decrement.
  */
-int handle_ipv4(intf_cfg_t *cfg, struct rte_mbuf *mbuf, 
-                const void *pkt, uint16_t len)
+static int prepare_fwd(intf_cfg_t *cfg, struct ipv4_hdr *hdr, uint16_t len,
+                        uint64_t ol_flags)
 {
-    struct ipv4_hdr *hdr = (struct ipv4_hdr *)pkt;
-
-    if(basic_chks(pkt, len) < 0) { // Drop the packet
-        // If the check method does not provide an error message. Do it here
-        #ifndef VERBOSE
-        printf("Received invalid IPv4 packet. Dropping it!\n");
-        #endif
-        drop_pkt(mbuf);
+    if(basic_chks(hdr, len, ol_flags) < 0) // Drop the packet, the reason is traced
         return ERR_INV_PKT;
-    }
 
     // Check if we have to forward the packet or if it is addressed to this host
     if(hdr->dst_addr == cfg->ip_addr_be) { // Thanks, but i can not use it..
-        #ifdef VERBOSE
-        printf("Thanks for this nice IP packet, but i have to drop it!\n");
-        #endif
-        drop_pkt(mbuf);
-        return 0;
+        TRACE_DEBUG(TRC_IPV4_NOTFORME, rte_be_to_cpu_32(hdr->src_addr), 0, 0);
+        return ERR_NOTFORME;
     }
 
     // Is the TTL large enough to forward the packet?
     if(--hdr->time_to_live < 1) {
-        #ifdef VERBOSE
-        printf("Cannot forward the packet. TTL expired in transit.\n");
-        #endif
-        drop_pkt(mbuf);
+        TRACE_DEBUG(TRC_IPV4_TTL_EXP, rte_be_to_cpu_32(hdr->src_addr), 0, 0);
         return ERR_TTL_EXP;
     }
 
     // Update the checksum
     hdr->hdr_checksum += rte_cpu_to_be_16(0x0100);
-
-    return lookup_and_fwd(cfg, mbuf, pkt);
+    return 0;
 }
 
-/*********************************
- *  Static function definitions  *
- *********************************/
 /**
  * /brief Perform basic IPv4 packet validity checks.
  * 
  * This funciton performs basic (header) validity checks according to 
  * RFC 1812.
+ * If the NIC already validated the header checksum, we trust its verdict.
+ * Otherwise we sum up the header including its options in software.
  * 
  * \param pkt Pointer to the header of the currently handled IPv4 packet.
- * \param len Length of the data reported by the link layer.
+ * \param len Length of the data reported by the link layer. It may include
+ *              the padding of the frame.
+ * \param ol_flags The RX offload flags of the buffer.
  * 
  * \return -1 if any error occured. 0 if the checks are okay.
  */
-static int basic_chks(const void *pkt, uint16_t len)
+static int basic_chks(const void *pkt, uint16_t len, uint64_t ol_flags)
 {
-    struct ipv4_hdr *hdr = (struct ipv4_hdr *)pkt;
+    const struct ipv4_hdr *hdr = (const struct ipv4_hdr *)pkt;
 
     if(len < 20) { // IP packet is smaller than 20 bytes?
-        #ifdef VERBOSE
-        printf("IPv4 packet is smaller than 20 bytes. Dropping it!\n");
-        #endif
+        TRACE_DEBUG(TRC_IPV4_SHORT, len, 0, 0);
         return -1;
     }
 
-    uint16_t chksum = hdr->hdr_checksum;
-    hdr->hdr_checksum = 0;
-    if(rte_ipv4_cksum(hdr) != chksum) { // Invalid checksum
-        #ifdef VERBOSE
-        printf("IPv4 packet has an invalid checksum. Dropping it!\n");
-        #endif
-        return -1;
-    }
-
-    // Paste the original checksum back to the packet.
-    // Calculating the new one is handled by the caller!
-    hdr->hdr_checksum = chksum;
     if((hdr->version_ihl & 0xF0) != 0x40) { // Check if the version is 4
-        #ifdef VERBOSE
-        printf("IP stack cannot handle other IP versions than 4."
-                    "Dropping the packet!\n");
-        #endif
+        TRACE_DEBUG(TRC_IPV4_VERSION, hdr->version_ihl >> 4, 0, 0);
         return -1;
     }
 
     // IHL must be at least 20 byte -> 5 * 32 bit (4 byte)
     if((hdr->version_ihl & 0x0F) < 5) {
-        #ifdef VERBOSE
-        printf("IHL is less than 20. Dropping the packet!\n");
-        #endif
+        TRACE_DEBUG(TRC_IPV4_IHL, (hdr->version_ihl & 0x0F) << 2, 0, 0);
         return -1;
     }
 
     // IHL increased to a 16 bit value
     uint16_t ihl_16 = ((uint16_t)((hdr->version_ihl & 0x000F))) << 2;
     if(rte_be_to_cpu_16(hdr->total_length) < ihl_16) {
-        #ifdef VERBOSE
-        printf("Total length is smaller than IHL. Dropping the packet!\n");
-        #endif
+        TRACE_DEBUG(TRC_IPV4_TOTAL_LEN, rte_be_to_cpu_16(hdr->total_length),
+                    ihl_16, 0);
         return -1;
     }
 
-    // Additional test that is not conform to RFC 1812 but such a packet is
-    // invalid!
-    if(rte_be_to_cpu_16(hdr->total_length) != len) {
-        #ifdef VERBOSE
-        printf("Total length of IPv4 packet does not equal the packet length"
-                    " reported by the link layer. Dropping it!\n");
-        #endif
+    // The link layer must hold the whole packet. Short packets are padded
+    // to the minimum ethernet payload.
+    if(rte_be_to_cpu_16(hdr->total_length) > len) {
+        TRACE_DEBUG(TRC_IPV4_LEN_MISMATCH,
+                    rte_be_to_cpu_16(hdr->total_length), len, 0);
         return -1;
     }
 
+    // The header is complete now -> Check the checksum. The sum of a valid
+    // header including its checksum is 0xFFFF.
+    switch(ol_flags & PKT_RX_IP_CKSUM_MASK) {
+    case PKT_RX_IP_CKSUM_GOOD:
+        break;
+    case PKT_RX_IP_CKSUM_BAD:
+        TRACE_DEBUG(TRC_IPV4_CHKSUM, rte_be_to_cpu_16(hdr->hdr_checksum), 0, 0);
+        return -1;
+    default: // Not checked by the NIC
+        if(rte_raw_cksum(hdr, ihl_16) != 0xFFFF) {
+            TRACE_DEBUG(TRC_IPV4_CHKSUM, rte_be_to_cpu_16(hdr->hdr_checksum),
+                        0, 0);
+            return -1;
+        }
+        break;
+    }
+
     return 0;
 }
 
 /**
- * /brief Forward the packet to the right next hop.
+ * /brief Forward the packets to the right next hops.
  * 
  * This function traverses the routing table using the Longest-Prefix-Matching
- * (LPM) algorithm. If a suitable prefix is found, we send out the packet
- * to the specified egress interface to the next hop stored in the routing
- * table entry.
- * 
- * Currently this method uses the dummy_routing_table provided by the
- * instructors.
- * 
- * \param cfg Configuration of the ingress interface of the packet.
- * \param mbuf The rte_mbuf containing the packet. This is reused for sending.
- * \param pkt Pointer to the actual IPv4 payload. In the packet, the TTL must
- *              already be decreased!
+ * (LPM) algorithm for all packets with a single bulk lookup.
+ * If a suitable prefix is found, we rewrite both MACs of the frame with
+ * the adjacency of the next hop and add the packet to the vector of its
+ * egress interface. Next hops given by IP get the destination MAC of the
+ * neighbor table. Afterwards, every vector is sent out
+ * with a single call to the ethernet stack.
+ * Packets without route or to unresolved next hops take the slow path.
  * 
- * \returns 0 on success.
- *          Errors: ERR_NO_ROUTE if we did not find a suitable route
+ * \param cfg Configuration of the ingress interface of the packets.
+ * \param mbufs The rte_mbufs containing the packets. Those are reused for
+ *              sending. In the packets, the TTL must already be decreased!
+ * \param n Number of buffers in mbufs. Must not exceed THREAD_BUFSIZE.
  */
-static int lookup_and_fwd(intf_cfg_t *cfg, struct rte_mbuf *mbuf, 
-                            const void *pkt)
+static void lookup_and_fwd(intf_cfg_t *cfg, struct rte_mbuf **mbufs,
+                            uint16_t n)
 {
-    uint32_t dst_addr_be = ((struct ipv4_hdr *)pkt)->dst_addr;
-
-    rt_entry_t *entry = get_next_hop(rte_be_to_cpu_32(dst_addr_be));
-
-    if(entry == NULL) { // No entry found..
-        #ifdef VERBOSE
-        printf("Cannot get routing table entry for ip address: %d.%d.%d.%d\n",
-                    (uint8_t)dst_addr_be, (uint8_t)(dst_addr_be >> 8),
-                    (uint8_t)(dst_addr_be >> 16), (uint8_t)(dst_addr_be >> 24));
-        #endif
-        drop_pkt(mbuf);
-        return ERR_NO_ROUTE;
+    struct rte_mbuf *out[RTE_MAX_ETHPORTS][THREAD_BUFSIZE];
+    uint16_t no_out[RTE_MAX_ETHPORTS] = { 0 };
+    uint8_t ports[THREAD_BUFSIZE]; // Egress interfaces used by this burst
+    uint32_t dst_addrs[THREAD_BUFSIZE];
+    uint32_t hop_ids[THREAD_BUFSIZE];
+    uint16_t no_ports = 0;
+    const dir24_8_t *fib = get_local_fib();
+    const adj_t *adj = NULL;
+    uint8_t *l2 = NULL;
+    uint32_t hop_ip = 0;
+
+    for(uint16_t i = 0; i < n; ++i)
+        dst_addrs[i] = rte_be_to_cpu_32(
+                        rte_pktmbuf_mtod_offset(mbufs[i], struct ipv4_hdr *,
+                                                ETHER_HDR_LEN)->dst_addr
+        );
+
+    lookup_bulk(fib, dst_addrs, hop_ids, n);
+
+    for(uint16_t i = 0; i < n; ++i) {
+        adj = get_adj(fib, hop_ids[i]);
+
+        if(adj == NULL || adj->intf >= RTE_MAX_ETHPORTS) {
+            // No entry found..
+            TRACE_DEBUG(TRC_IPV4_NO_ROUTE, dst_addrs[i], 0, 0);
+            defer_to_slow(cfg, mbufs[i], SLOW_NO_ROUTE, cfg->intf, 0);
+            continue;
+        }
+
+        l2 = rte_pktmbuf_mtod(mbufs[i], uint8_t *);
+        if(is_neigh_adj(adj)) {
+            hop_ip = get_neigh_mac_ip((const struct ether_addr *)adj->l2);
+            if(neigh_lookup(adj->intf, hop_ip, (struct ether_addr *)l2) < 0) {
+                // The slow path sends it as soon as the next hop answers
+                defer_to_slow(cfg, mbufs[i], SLOW_NEIGH, adj->intf, hop_ip);
+                continue;
+            }
+            memcpy(l2 + ETHER_ADDR_LEN, adj->l2 + ETHER_ADDR_LEN,
+                    ETHER_ADDR_LEN);
+        } else {
+            memcpy(l2, adj->l2, ADJ_L2_LEN); // One 8 and one 4 byte store
+        }
+
+        // First packet of this burst for this egress interface?
+        if(no_out[adj->intf] == 0)
+            ports[no_ports++] = adj->intf;
+        out[adj->intf][no_out[adj->intf]++] = mbufs[i];
     }
-    return send_frame(cfg, mbuf, entry->dst_port, &entry->dst_mac);
-}
\ No newline at end of file
+
+    for(uint16_t i = 0; i < no_ports; ++i)
+        send_l2_frames(cfg, out[ports[i]], no_out[ports[i]], ports[i]);
+}
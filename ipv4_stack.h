@@ -10,7 +10,6 @@
 
 #define IPv4_ADDR_LEN 0x04
 
-extern int handle_ipv4(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
-                        const void *pkt, uint16_t len);
+extern void handle_ipv4(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n);
 
 #endif
\ No newline at end of file
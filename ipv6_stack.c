@@ -0,0 +1,188 @@
+#include <string.h>
+
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include "ipv6_stack.h"
+#include "router.h"
+#include "ethernet_stack.h"
+#include "fib6.h"
+#include "slow_path.h"
+#include "global.h"
+#include "log.h"
+
+/*********************************
+ *  Static function declarations *
+ *********************************/
+static int prepare_fwd6(struct ipv6_hdr *hdr, uint16_t len);
+static inline uint32_t get_upper32(const uint8_t *addr);
+static void lookup_and_fwd6(intf_cfg_t *cfg, struct rte_mbuf **mbufs,
+                                uint16_t n);
+
+/*********************************
+ *      Function definitions     *
+ *********************************/
+/**
+ * /brief Handle a burst of received IPv6 packets.
+ * 
+ * Works like handle_ipv4(): We validate the whole burst, look up the next
+ * hops of the remaining packets with a single bulk lookup and hand one
+ * vector per egress interface to the ethernet stack.
+ * Packets to link-local and multicast addresses are handed to the slow path
+ * (neighbor discovery). Packets whose hop limit expired and packets without
+ * a route are dropped: We send no ICMPv6 errors.
+ * 
+ * \param cfg The configuration of the interface the packets were received on.
+ * \param mbufs The buffers containing the complete frames. We take
+ *              ownership of the buffers.
+ * \param n Number of buffers in mbufs. Must not exceed THREAD_BUFSIZE.
+ */
+void handle_ipv6(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n)
+{
+    struct rte_mbuf *fwd[THREAD_BUFSIZE], *drops[THREAD_BUFSIZE];
+    lcore_stats_t *stats = &lcore_stats[cfg->lcore];
+    uint16_t no_fwd = 0, no_drops = 0;
+    struct ipv6_hdr *hdr = NULL;
+    int err = 0;
+
+    for(uint16_t i = 0; i < n; ++i) {
+        hdr = rte_pktmbuf_mtod_offset(mbufs[i], struct ipv6_hdr *,
+                                        ETHER_HDR_LEN);
+        err = prepare_fwd6(hdr, rte_pktmbuf_data_len(mbufs[i])
+                                - ETHER_HDR_LEN);
+        // The padding of short frames must not be sent on
+        if(err != ERR_INV_PKT)
+            rte_pktmbuf_trim(mbufs[i], rte_pktmbuf_data_len(mbufs[i])
+                                - ETHER_HDR_LEN - IPV6_HDR_LEN
+                                - rte_be_to_cpu_16(hdr->payload_len));
+        if(err == 0) {
+            fwd[no_fwd++] = mbufs[i];
+        } else if(err == ERR_NOTFORME) {
+            defer_to_slow(cfg, mbufs[i], SLOW_LOCAL6, cfg->intf, 0);
+        } else {
+            stats->drops[err == ERR_TTL_EXP ? DROP_IPV6_HOP_EXP
+                                            : DROP_IPV6_INV]++;
+            drops[no_drops++] = mbufs[i];
+        }
+    }
+
+    drop_frames(drops, no_drops);
+
+    if(no_fwd > 0)
+        lookup_and_fwd6(cfg, fwd, no_fwd);
+}
+
+/*********************************
+ *  Static function definitions  *
+ *********************************/
+/**
+ * /brief Check a single IPv6 packet and prepare it for forwarding.
+ * 
+ * IPv6 has no header checksum -> The checks are the version, the length
+ * and the addresses. We decrement the hop limit if we forward the packet.
+ * 
+ * \param hdr Pointer to the start of the IPv6 packet.
+ * \param len Length of the IPv6 packet regarding the link layer. It may
+ *              include the padding of the frame.
+ * 
+ * \return 0 if the packet shall be forwarded.
+ *          Errors: ERR_INV_PKT: The packet was invalid.
+ *                  ERR_NOTFORME: Link-local or multicast destination.
+ *                  ERR_TTL_EXP: The hop limit expired in transit.
+ */
+static int prepare_fwd6(struct ipv6_hdr *hdr, uint16_t len)
+{
+    if(len < IPV6_HDR_LEN) {
+        TRACE_DEBUG(TRC_IPV6_SHORT, len, 0, 0);
+        return ERR_INV_PKT;
+    }
+    if((rte_be_to_cpu_32(hdr->vtc_flow) >> 28) != 6) {
+        TRACE_DEBUG(TRC_IPV6_VERSION, rte_be_to_cpu_32(hdr->vtc_flow) >> 28,
+                    0, 0);
+        return ERR_INV_PKT;
+    }
+    // Jumbograms are not supported. Packets with less than 6 bytes of
+    // payload are padded to the minimum ethernet payload.
+    if(rte_be_to_cpu_16(hdr->payload_len) + IPV6_HDR_LEN > len) {
+        TRACE_DEBUG(TRC_IPV6_LEN_MISMATCH,
+                    rte_be_to_cpu_16(hdr->payload_len), len, 0);
+        return ERR_INV_PKT;
+    }
+    if(hdr->src_addr[0] == 0xFF) {
+        TRACE_DEBUG(TRC_IPV6_SRC_MCAST, get_upper32(hdr->src_addr), 0, 0);
+        return ERR_INV_PKT;
+    }
+
+    // Multicast (ff00::/8) and link-local (fe80::/10) destinations are never
+    // forwarded
+    if(hdr->dst_addr[0] == 0xFF
+        || (hdr->dst_addr[0] == 0xFE && (hdr->dst_addr[1] & 0xC0) == 0x80))
+        return ERR_NOTFORME;
+
+    if(hdr->hop_limits <= 1) {
+        TRACE_DEBUG(TRC_IPV6_HOP_EXP, get_upper32(hdr->src_addr), 0, 0);
+        return ERR_TTL_EXP;
+    }
+    hdr->hop_limits--;
+    return 0;
+}
+
+/**
+ * /brief Get the upper 32 bit of an IPv6 address for the trace.
+ */
+static inline uint32_t get_upper32(const uint8_t *addr)
+{
+    return (uint32_t)addr[0] << 24 | (uint32_t)addr[1] << 16
+            | (uint32_t)addr[2] << 8 | addr[3];
+}
+
+/**
+ * /brief Forward IPv6 packets to their next hops.
+ * 
+ * Like the IPv4 packets, the frames are rewritten with the adjacency of
+ * their next hop.
+ * 
+ * \param cfg Configuration of the ingress interface of the packets.
+ * \param mbufs The buffers containing the packets. Those are reused for
+ *              sending. The hop limit must already be decreased!
+ * \param n Number of buffers in mbufs. Must not exceed THREAD_BUFSIZE.
+ */
+static void lookup_and_fwd6(intf_cfg_t *cfg, struct rte_mbuf **mbufs,
+                            uint16_t n)
+{
+    struct rte_mbuf *out[RTE_MAX_ETHPORTS][THREAD_BUFSIZE];
+    struct rte_mbuf *drops[THREAD_BUFSIZE];
+    uint16_t no_out[RTE_MAX_ETHPORTS] = { 0 };
+    uint8_t ports[THREAD_BUFSIZE]; // Egress interfaces used by this burst
+    uint8_t dst_addrs[THREAD_BUFSIZE][IPV6_ADDR_LEN];
+    int32_t hop_ids[THREAD_BUFSIZE];
+    uint16_t no_ports = 0, no_drops = 0;
+    const adj_t *adj = NULL;
+
+    for(uint16_t i = 0; i < n; ++i)
+        memcpy(dst_addrs[i],
+                rte_pktmbuf_mtod_offset(mbufs[i], struct ipv6_hdr *,
+                                        ETHER_HDR_LEN)->dst_addr,
+                IPV6_ADDR_LEN);
+
+    fib6_lookup_bulk(dst_addrs, hop_ids, n);
+
+    for(uint16_t i = 0; i < n; ++i) {
+        if((adj = get_adj6(hop_ids[i])) == NULL) {
+            TRACE_DEBUG(TRC_IPV6_NO_ROUTE, get_upper32(dst_addrs[i]), 0, 0);
+            drops[no_drops++] = mbufs[i];
+            continue;
+        }
+
+        memcpy(rte_pktmbuf_mtod(mbufs[i], uint8_t *), adj->l2, ADJ_L2_LEN);
+        if(no_out[adj->intf] == 0)
+            ports[no_ports++] = adj->intf;
+        out[adj->intf][no_out[adj->intf]++] = mbufs[i];
+    }
+
+    lcore_stats[cfg->lcore].drops[DROP_IPV6_NO_ROUTE] += no_drops;
+    drop_frames(drops, no_drops);
+
+    for(uint16_t i = 0; i < no_ports; ++i)
+        send_l2_frames(cfg, out[ports[i]], no_out[ports[i]], ports[i]);
+}
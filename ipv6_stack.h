@@ -0,0 +1,15 @@
+/**
+ * This file contains definitions to forward IPv6 packets.
+ */
+#ifndef IPV6_STACK_H__
+#define IPV6_STACK_H__
+
+#include <rte_mbuf.h>
+
+#include "router.h"
+
+#define IPV6_HDR_LEN 40
+
+void handle_ipv6(intf_cfg_t *cfg, struct rte_mbuf **mbufs, uint16_t n);
+
+#endif
@@ -0,0 +1,249 @@
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "global.h"
+
+/*
+ * Formats of the arguments of a trace event. The message of an event
+ * contains one %s per argument.
+ */
+typedef enum trace_arg {
+    ARG_NONE = 0,
+    ARG_DEC,
+    ARG_HEX,
+    ARG_IP // CPU byte order
+} trace_arg_t;
+
+typedef struct trace_desc {
+    const char *msg;
+    trace_arg_t args[3];
+} trace_desc_t;
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static void format_trace_arg(char *buf, size_t size, trace_arg_t type,
+                                uint32_t arg);
+static void *drain_traces_loop(void *arg);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+int log_level = LOG_LVL_INFO;
+trace_ring_t trace_rings[RTE_MAX_LCORE];
+
+static const char *const level_names[] = {
+    [LOG_LVL_NONE] = "none",
+    [LOG_LVL_ERR] = "err",
+    [LOG_LVL_WARN] = "warn",
+    [LOG_LVL_INFO] = "info",
+    [LOG_LVL_DEBUG] = "debug"
+};
+
+static const trace_desc_t trace_descs[NO_TRACE_EVENTS] = {
+    [TRC_ARP_REPLY] = {
+        "Sent ARP reply on interface %s to target with IP %s",
+        { ARG_DEC, ARG_IP } },
+    [TRC_ARP_INV_LEN] = {
+        "ARP packet with an invalid length: %s", { ARG_HEX } },
+    [TRC_ARP_NOT_IMPL] = {
+        "Not able to handle this ARP packet. Operation: %s", { ARG_HEX } },
+    [TRC_ARP_NOTFORME] = {
+        "ARP packet was not sent to this hosts IP: TIP: %s", { ARG_IP } },
+    [TRC_ARP_INV_HRD] = {
+        "Not able to handle this ARP packet. Unknown HW address type: %s",
+        { ARG_HEX } },
+    [TRC_ARP_INV_PRO] = {
+        "Not able to handle this ARP packet. "
+        "Unknown protocol address type: %s", { ARG_HEX } },
+    [TRC_ARP_INV_ADDR_LEN] = {
+        "Not able to handle this ARP packet. "
+        "Invalid HW (%s) or protocol (%s) address length",
+        { ARG_DEC, ARG_DEC } },
+    [TRC_TX_NO_INTF] = {
+        "Cannot send frames on unconfigured interface %s", { ARG_DEC } },
+    [TRC_IPV4_NOTFORME] = {
+        "Dropped IPv4 packet from %s addressed to this host", { ARG_IP } },
+    [TRC_IPV4_TTL_EXP] = {
+        "Cannot forward the packet from %s. TTL expired in transit.",
+        { ARG_IP } },
+    [TRC_IPV4_SHORT] = {
+        "IPv4 packet is smaller than 20 bytes (%s). Dropping it!",
+        { ARG_DEC } },
+    [TRC_IPV4_CHKSUM] = {
+        "IPv4 packet has an invalid checksum (%s). Dropping it!",
+        { ARG_HEX } },
+    [TRC_IPV4_VERSION] = {
+        "IP stack cannot handle other IP versions than 4 (%s). "
+        "Dropping the packet!", { ARG_DEC } },
+    [TRC_IPV4_IHL] = {
+        "IHL is less than 20 (%s). Dropping the packet!", { ARG_DEC } },
+    [TRC_IPV4_TOTAL_LEN] = {
+        "Total length %s is smaller than IHL %s. Dropping the packet!",
+        { ARG_DEC, ARG_DEC } },
+    [TRC_IPV4_LEN_MISMATCH] = {
+        "Total length of IPv4 packet (%s) does not equal the packet length "
+        "reported by the link layer (%s). Dropping it!",
+        { ARG_DEC, ARG_DEC } },
+    [TRC_IPV4_NO_ROUTE] = {
+        "Cannot get routing table entry for ip address: %s", { ARG_IP } },
+    [TRC_IPV6_SHORT] = {
+        "IPv6 packet is smaller than 40 bytes (%s). Dropping it!",
+        { ARG_DEC } },
+    [TRC_IPV6_VERSION] = {
+        "IPv6 stack cannot handle other IP versions than 6 (%s). "
+        "Dropping the packet!", { ARG_DEC } },
+    [TRC_IPV6_LEN_MISMATCH] = {
+        "Payload length of IPv6 packet (%s) does not match the packet length "
+        "reported by the link layer (%s). Dropping it!",
+        { ARG_DEC, ARG_DEC } },
+    [TRC_IPV6_SRC_MCAST] = {
+        "IPv6 packet from a multicast address (upper 32 bit: %s). "
+        "Dropping it!",
+        { ARG_HEX } },
+    [TRC_IPV6_HOP_EXP] = {
+        "Cannot forward the packet from upper 32 bit %s. Hop limit expired "
+        "in transit.", { ARG_HEX } },
+    [TRC_IPV6_NO_ROUTE] = {
+        "Cannot get routing table entry for IPv6 address (upper 32 bit: %s)",
+        { ARG_HEX } }
+};
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Set the runtime log level.
+ *
+ * Messages above the level given at compile time are never printed.
+ *
+ * \param name none, err, warn, info or debug.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_FORMAT: Unknown level.
+ */
+int set_log_level(const char *name)
+{
+    int lvl = 0;
+
+    if(name == NULL)
+        return ERR_FORMAT;
+
+    for(lvl = LOG_LVL_NONE; lvl <= LOG_LVL_DEBUG; ++lvl) {
+        if(strcmp(name, level_names[lvl]) == 0) {
+            if(lvl > LOG_LVL_COMPILE)
+                printf("Warning: Log level %s is not compiled in. "
+                        "Using %s.\n", name, level_names[LOG_LVL_COMPILE]);
+            log_level = lvl;
+            return 0;
+        }
+    }
+    return ERR_FORMAT;
+}
+
+/**
+ * \brief Format and remove all records of the trace rings.
+ *
+ * Must only be called by a single thread at a time.
+ *
+ * \param out The stream the messages are written to.
+ *
+ * \return The number of formatted records.
+ */
+uint32_t drain_traces(FILE *out)
+{
+    static uint32_t reported_drops[RTE_MAX_LCORE];
+    const double hz = rte_get_tsc_hz();
+    char args[3][16];
+    const trace_desc_t *desc = NULL;
+    trace_ring_t *ring = NULL;
+    trace_rec_t rec;
+    uint32_t tail = 0, cnt = 0, dropped = 0;
+    unsigned lcore = 0, i = 0;
+
+    for(lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        ring = &trace_rings[lcore];
+
+        for(tail = ring->tail; tail != ring->head; ++tail) {
+            // Read the record after the head that published it
+            rte_smp_rmb();
+            rec = ring->recs[tail & (TRACE_RING_SIZE - 1)];
+            // The record must be read before the lcore can overwrite it
+            rte_smp_mb();
+            ring->tail = tail + 1;
+
+            if(rec.event >= NO_TRACE_EVENTS)
+                continue;
+            desc = &trace_descs[rec.event];
+            for(i = 0; i < 3; ++i)
+                format_trace_arg(args[i], sizeof(args[i]), desc->args[i],
+                                    rec.args[i]);
+
+            fprintf(out, "[lcore %u %.6f] ", lcore, rec.tsc / hz);
+            fprintf(out, desc->msg, args[0], args[1], args[2]);
+            fputc('\n', out);
+            ++cnt;
+        }
+
+        if((dropped = ring->dropped) != reported_drops[lcore]) {
+            fprintf(out, "[lcore %u] Dropped %u trace records\n", lcore,
+                    dropped - reported_drops[lcore]);
+            reported_drops[lcore] = dropped;
+        }
+    }
+
+    if(cnt > 0)
+        fflush(out);
+    return cnt;
+}
+
+/**
+ * \brief Start a control thread printing the trace records periodically.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_START: Cannot create the thread.
+ */
+int start_trace_thread(void)
+{
+    pthread_t thread;
+
+    if(pthread_create(&thread, NULL, drain_traces_loop, NULL) != 0) {
+        printf("Cannot start the trace thread!\n");
+        return ERR_START;
+    }
+    pthread_detach(thread);
+    return 0;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+static void format_trace_arg(char *buf, size_t size, trace_arg_t type,
+                                uint32_t arg)
+{
+    switch(type) {
+    case ARG_DEC:
+        snprintf(buf, size, "%u", arg);
+        break;
+    case ARG_HEX:
+        snprintf(buf, size, "0x%x", arg);
+        break;
+    case ARG_IP:
+        snprintf(buf, size, "%u.%u.%u.%u", arg >> 24, (arg >> 16) & 0xFF,
+                    (arg >> 8) & 0xFF, arg & 0xFF);
+        break;
+    default:
+        buf[0] = '\0';
+    }
+}
+
+static void *drain_traces_loop(void *arg)
+{
+    for(;;) {
+        drain_traces(stdout);
+        usleep(TRACE_DRAIN_INTERVAL_US);
+    }
+    return NULL;
+}
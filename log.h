@@ -0,0 +1,157 @@
+/**
+ * This file provides the logging of the router.
+ *
+ * Messages are filtered at compile time by LOG_LVL_COMPILE and at runtime by
+ * log_level. Statements above LOG_LVL_COMPILE compile to nothing.
+ * The datapath never calls printf(): Its events are written to a lock-free
+ * trace ring of the lcore and formatted by a control thread. See log.c.
+ */
+#ifndef LOG_H__
+#define LOG_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_config.h>
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_memory.h>
+
+#define LOG_LVL_NONE 0
+#define LOG_LVL_ERR 1
+#define LOG_LVL_WARN 2
+#define LOG_LVL_INFO 3
+#define LOG_LVL_DEBUG 4
+
+// Set by the build. See CMakeLists.txt
+#ifndef LOG_LVL_COMPILE
+#define LOG_LVL_COMPILE LOG_LVL_INFO
+#endif
+
+#define TRACE_RING_SIZE 1024 // Records per lcore, power of 2
+#define TRACE_DRAIN_INTERVAL_US 100000
+
+#define LOG(lvl, ...) \
+    do { \
+        if((lvl) <= LOG_LVL_COMPILE && (lvl) <= log_level) \
+            printf(__VA_ARGS__); \
+    } while(0)
+#define LOG_ERR(...) LOG(LOG_LVL_ERR, __VA_ARGS__)
+#define LOG_WARN(...) LOG(LOG_LVL_WARN, __VA_ARGS__)
+#define LOG_INFO(...) LOG(LOG_LVL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG(LOG_LVL_DEBUG, __VA_ARGS__)
+
+#define TRACE(lvl, event, a0, a1, a2) \
+    do { \
+        if((lvl) <= LOG_LVL_COMPILE && (lvl) <= log_level) \
+            trace_event((event), (a0), (a1), (a2)); \
+    } while(0)
+#define TRACE_WARN(event, a0, a1, a2) TRACE(LOG_LVL_WARN, event, a0, a1, a2)
+#define TRACE_DEBUG(event, a0, a1, a2) TRACE(LOG_LVL_DEBUG, event, a0, a1, a2)
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+/*
+ * Events of the datapath. The message of every event is defined in log.c.
+ */
+typedef enum trace_event_id {
+    TRC_ARP_REPLY, // Interface, target IP
+    TRC_ARP_INV_LEN, // Length
+    TRC_ARP_NOT_IMPL, // Operation
+    TRC_ARP_NOTFORME, // Target IP
+    TRC_ARP_INV_HRD, // HW address type
+    TRC_ARP_INV_PRO, // Protocol address type
+    TRC_ARP_INV_ADDR_LEN, // HW address length, protocol address length
+    TRC_TX_NO_INTF, // Interface
+    TRC_IPV4_NOTFORME, // Source IP
+    TRC_IPV4_TTL_EXP, // Source IP
+    TRC_IPV4_SHORT, // Length
+    TRC_IPV4_CHKSUM, // Received checksum
+    TRC_IPV4_VERSION, // Version
+    TRC_IPV4_IHL, // IHL
+    TRC_IPV4_TOTAL_LEN, // Total length, IHL
+    TRC_IPV4_LEN_MISMATCH, // Total length, link layer length
+    TRC_IPV4_NO_ROUTE, // Destination IP
+    TRC_IPV6_SHORT, // Length
+    TRC_IPV6_VERSION, // Version
+    TRC_IPV6_LEN_MISMATCH, // Payload length, link layer length
+    TRC_IPV6_SRC_MCAST, // Upper 32 bit of the source IP
+    TRC_IPV6_HOP_EXP, // Upper 32 bit of the source IP
+    TRC_IPV6_NO_ROUTE, // Upper 32 bit of the destination IP
+    NO_TRACE_EVENTS
+} trace_event_id_t;
+
+typedef struct trace_rec {
+    uint64_t tsc;
+    uint32_t event;
+    uint32_t args[3];
+} trace_rec_t;
+
+/*
+ * Single producer (the lcore), single consumer (the control thread) ring.
+ * Records are dropped if the ring is full.
+ */
+typedef struct trace_ring {
+    volatile uint32_t head; // Written by the lcore
+    volatile uint32_t dropped; // Written by the lcore
+    volatile uint32_t tail __rte_cache_aligned; // Written by the consumer
+    trace_rec_t recs[TRACE_RING_SIZE] __rte_cache_aligned;
+} trace_ring_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int set_log_level(const char *name);
+uint32_t drain_traces(FILE *out);
+int start_trace_thread(void);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern int log_level;
+extern trace_ring_t trace_rings[RTE_MAX_LCORE];
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Write an event to the trace ring of the calling lcore.
+ *
+ * Use the TRACE macros instead. Threads not managed by DPDK cannot trace.
+ *
+ * \param event The trace_event_id_t.
+ * \param a0, a1, a2 The arguments of the event.
+ */
+static inline void trace_event(uint32_t event, uint32_t a0, uint32_t a1,
+                                uint32_t a2)
+{
+    const unsigned lcore = rte_lcore_id();
+    trace_ring_t *ring = NULL;
+    trace_rec_t *rec = NULL;
+    uint32_t head = 0;
+
+    if(lcore >= RTE_MAX_LCORE)
+        return;
+
+    ring = &trace_rings[lcore];
+    head = ring->head;
+    if(head - ring->tail == TRACE_RING_SIZE) {
+        ring->dropped++;
+        return;
+    }
+
+    rec = &ring->recs[head & (TRACE_RING_SIZE - 1)];
+    rec->tsc = rte_rdtsc();
+    rec->event = event;
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+
+    // The record must be complete before the consumer can see it
+    rte_smp_wmb();
+    ring->head = head + 1;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/icmp6.h>
+
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#include "ndp_stack.h"
+#include "ipv6_stack.h"
+#include "fib6.h"
+#include "ethernet_stack.h"
+#include "router.h"
+#include "global.h"
+
+// Neighbor advertisement with the target link-layer address option
+#define NDP_NA_LEN (sizeof(struct nd_neighbor_advert) + 8)
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Handle an IPv6 packet to a link-local or multicast address.
+ * 
+ * Called by the slow path. We answer neighbor solicitations for the
+ * link-local address of the interface. The solicitation buffer is reused
+ * for the advertisement. Solicitations of the duplicate address detection
+ * (unspecified source) are not answered.
+ * 
+ * \param cfg The configuration of the interface this packet was received on.
+ * \param mbuf The frame containing the packet. The IPv6 header was already
+ *              checked by the worker.
+ * 
+ * \return 0 if the advertisement was sent.
+ *          Errors: ERR_INV_PKT: Truncated message, invalid checksum or hop
+ *                              limit.
+ *                  ERR_NOTFORME: No solicitation for our address.
+ *                  ERR_MEM: No room for the advertisement in the buffer.
+ */
+int handle_ndp(intf_cfg_t *cfg, struct rte_mbuf *mbuf)
+{
+    struct ether_hdr *eth = rte_pktmbuf_mtod(mbuf, struct ether_hdr *);
+    struct ipv6_hdr *ip = (struct ipv6_hdr *)(eth + 1);
+    const uint16_t len = rte_be_to_cpu_16(ip->payload_len);
+    const uint16_t data_len = rte_pktmbuf_data_len(mbuf);
+    const uint16_t na_len = ETHER_HDR_LEN + IPV6_HDR_LEN + NDP_NA_LEN;
+    struct nd_neighbor_solicit *ns = (struct nd_neighbor_solicit *)(ip + 1);
+    struct nd_neighbor_advert *na = (struct nd_neighbor_advert *)(ip + 1);
+    struct nd_opt_hdr *opt = (struct nd_opt_hdr *)(na + 1);
+    static const uint8_t unspec[IPV6_ADDR_LEN] = { 0 };
+    uint8_t own[IPV6_ADDR_LEN];
+    struct ether_addr d_ether;
+
+    if(ip->proto != IPPROTO_ICMPV6)
+        return ERR_NOTFORME;
+    if(len < sizeof(struct icmp6_hdr))
+        return ERR_INV_PKT;
+    if(ns->nd_ns_type != ND_NEIGHBOR_SOLICIT)
+        return ERR_NOTFORME;
+    if(len < sizeof(*ns) || ns->nd_ns_code != 0
+        || ip->hop_limits != NDP_HOP_LIMIT
+        || rte_ipv6_udptcp_cksum(ip, ns) != 0xFFFF)
+        return ERR_INV_PKT;
+
+    get_link_local(&cfg->ether_addr, own);
+    if(memcmp(&ns->nd_ns_target, own, IPV6_ADDR_LEN) != 0
+        || memcmp(ip->src_addr, unspec, IPV6_ADDR_LEN) == 0)
+        return ERR_NOTFORME;
+
+    if(data_len < na_len && rte_pktmbuf_append(mbuf, na_len - data_len)
+                            == NULL)
+        return ERR_MEM;
+    if(data_len > na_len)
+        rte_pktmbuf_trim(mbuf, data_len - na_len);
+
+    // The target stays in place
+    na->nd_na_type = ND_NEIGHBOR_ADVERT;
+    na->nd_na_code = 0;
+    na->nd_na_cksum = 0;
+    na->nd_na_flags_reserved = ND_NA_FLAG_ROUTER | ND_NA_FLAG_SOLICITED
+                                | ND_NA_FLAG_OVERRIDE;
+    opt->nd_opt_type = ND_OPT_TARGET_LINKADDR;
+    opt->nd_opt_len = 1; // Units of 8 bytes
+    ether_addr_copy(&cfg->ether_addr, (struct ether_addr *)(opt + 1));
+
+    memcpy(ip->dst_addr, ip->src_addr, IPV6_ADDR_LEN);
+    memcpy(ip->src_addr, own, IPV6_ADDR_LEN);
+    ip->payload_len = rte_cpu_to_be_16(NDP_NA_LEN);
+    ip->hop_limits = NDP_HOP_LIMIT;
+    na->nd_na_cksum = rte_ipv6_udptcp_cksum(ip, na);
+
+    ether_addr_copy(&eth->s_addr, &d_ether);
+    return send_frame(cfg, mbuf, cfg->intf, &d_ether);
+}
@@ -0,0 +1,70 @@
+/**
+ * This file contains methods to handle IPv6 neighbor discovery (NDP).
+ *
+ * The router answers neighbor solicitations for the link-local address of
+ * every interface -> Hosts and routers on the link can use it as next hop.
+ * The router has no other IPv6 addresses and resolves no IPv6 next hops:
+ * IPv6 routes name the MAC of their next hop.
+ */
+#ifndef NDP_STACK_H__
+#define NDP_STACK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+
+#include "router.h"
+
+// Hop limit of all NDP messages
+#define NDP_HOP_LIMIT 255
+
+int handle_ndp(intf_cfg_t *cfg, struct rte_mbuf *mbuf);
+
+/**
+ * \brief Get the link-local address of an interface.
+ *
+ * fe80::/64 with the modified EUI-64 interface ID of the MAC (RFC 4291).
+ *
+ * \param mac The MAC of the interface.
+ * \param addr The address (16 bytes).
+ */
+static inline void get_link_local(const struct ether_addr *mac,
+                                    uint8_t *addr)
+{
+    const uint8_t *m = mac->addr_bytes;
+
+    memset(addr, 0, 8);
+    addr[0] = 0xFE;
+    addr[1] = 0x80;
+    addr[8] = m[0] ^ 0x02;
+    addr[9] = m[1];
+    addr[10] = m[2];
+    addr[11] = 0xFF;
+    addr[12] = 0xFE;
+    addr[13] = m[3];
+    addr[14] = m[4];
+    addr[15] = m[5];
+}
+
+/**
+ * \brief Check if a frame is sent to the solicited-node multicast address
+ *      of our link-local address.
+ *
+ * \param dst The destination MAC of the frame.
+ * \param mac The MAC of the interface.
+ *
+ * \return true if the MAC is 33:33:ff followed by the last 3 bytes of mac.
+ */
+static inline bool is_solicited_node_mac(const struct ether_addr *dst,
+                                            const struct ether_addr *mac)
+{
+    const uint8_t *d = dst->addr_bytes;
+
+    return d[0] == 0x33 && d[1] == 0x33 && d[2] == 0xFF
+            && memcmp(&d[3], &mac->addr_bytes[3], 3) == 0;
+}
+
+#endif
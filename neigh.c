@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_arp.h>
+#include <rte_cycles.h>
+#include <rte_hash_crc.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+
+#include "neigh.h"
+#include "arp_stack.h"
+#include "ethernet_stack.h"
+#include "routing_table_additional.h"
+#include "global.h"
+#include "log.h"
+
+// Buffers of the ARP requests sent by the slow path
+#define NEIGH_POOL_SIZE 511
+#define NEIGH_POOL_CACHE 32
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static neigh_t *add_neigh(const neigh_key_t *key, uint64_t now);
+static void send_request(intf_cfg_t *cfg, const neigh_key_t *key);
+static void drop_pending(intf_cfg_t *cfg, neigh_t *neigh);
+static const intf_cfg_t *find_intf_cfg(uint8_t intf);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+struct rte_hash *neigh_hash = NULL;
+neigh_t *neighs = NULL;
+
+static struct rte_mempool *neigh_pool = NULL;
+static uint no_neighs = 0;
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Create the neighbor table.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+int init_neigh(void)
+{
+    struct rte_hash_parameters params = {
+        .name = "neigh_hash",
+        .entries = NEIGH_MAX_ENTRIES,
+        .key_len = sizeof(neigh_key_t),
+        .hash_func = rte_hash_crc,
+        .socket_id = SOCKET_ID_ANY,
+    };
+
+    if(
+        (neigh_hash = rte_hash_create(&params)) == NULL
+        || (neighs = rte_zmalloc("neighs",
+                                NEIGH_MAX_ENTRIES * sizeof(neigh_t),
+                                RTE_CACHE_LINE_SIZE)) == NULL
+        || (neigh_pool == NULL
+            && (neigh_pool = rte_pktmbuf_pool_create("neigh_pool",
+                                NEIGH_POOL_SIZE, NEIGH_POOL_CACHE, 0,
+                                RTE_PKTMBUF_HEADROOM + ETHER_MIN_LEN,
+                                SOCKET_ID_ANY)) == NULL)
+    ) {
+        printf("Cannot allocate memory for the neighbor table!\n");
+        free_neigh();
+        return ERR_MEM;
+    }
+    return 0;
+}
+
+/**
+ * \brief Free the neighbor table and drop all queued packets.
+ *
+ * No worker may use the table anymore.
+ */
+void free_neigh(void)
+{
+    const void *key = NULL;
+    void *data = NULL;
+    uint32_t it = 0;
+    int32_t pos = 0;
+
+    while(
+        neigh_hash != NULL
+        && (pos = rte_hash_iterate(neigh_hash, &key, &data, &it)) >= 0
+    ) {
+        for(uint8_t i = 0; i < neighs[pos].no_pending; ++i)
+            rte_pktmbuf_free(neighs[pos].pending[i]);
+    }
+
+    rte_hash_free(neigh_hash);
+    rte_free(neighs);
+    neigh_hash = NULL;
+    neighs = NULL;
+    no_neighs = 0;
+}
+
+/**
+ * \brief Get the number of neighbors in the table.
+ */
+uint get_no_neighs(void)
+{
+    return no_neighs;
+}
+
+/**
+ * \brief Send an IPv4 packet to its next hop or queue it until the MAC is
+ *      known.
+ *
+ * Called by the slow path for packets the workers could not resolve. The
+ * first packet to a neighbor creates it and sends the first ARP request.
+ *
+ * \param cfg The state of the slow path.
+ * \param mbuf The frame. We take ownership of the buffer.
+ * \param intf The egress interface.
+ * \param ip_cpu_bo The next hop in little endian format.
+ */
+void resolve_neigh(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t intf,
+                    uint32_t ip_cpu_bo)
+{
+    neigh_key_t key = { .ip_cpu_bo = ip_cpu_bo, .intf = intf, .pad = { 0 } };
+    lcore_stats_t *stats = &lcore_stats[cfg->lcore];
+    const uint64_t now = rte_rdtsc();
+    neigh_t *neigh = NULL;
+    uint64_t hw = 0;
+    int32_t pos = 0;
+
+    if((pos = rte_hash_lookup(neigh_hash, &key)) >= 0) {
+        neigh = &neighs[pos];
+    } else if((neigh = add_neigh(&key, now)) != NULL) {
+        send_request(cfg, &key);
+    } else {
+        stats->drops[DROP_NEIGH_FULL]++;
+        rte_pktmbuf_free(mbuf);
+        return;
+    }
+
+    // Resolved since the worker looked it up
+    if((hw = neigh->hw) & NEIGH_VALID) {
+        neigh->used = true;
+        send_frame(cfg, mbuf, key.intf, (struct ether_addr *)&hw);
+        return;
+    }
+
+    if(neigh->no_pending == NEIGH_QUEUE_LEN) {
+        stats->drops[DROP_NEIGH_FULL]++;
+        rte_pktmbuf_free(mbuf);
+        return;
+    }
+    neigh->pending[neigh->no_pending++] = mbuf;
+}
+
+/**
+ * \brief Learn the MAC of a neighbor from an ARP packet.
+ *
+ * Only neighbors we asked for are updated (RFC 826: Requests update known
+ * senders as well). Their queued packets are sent.
+ *
+ * \param cfg The state of the slow path.
+ * \param arp The valid ARP packet.
+ * \param intf The interface the packet was received on.
+ */
+void learn_neigh(intf_cfg_t *cfg, const struct arp_hdr *arp, uint8_t intf)
+{
+    neigh_key_t key = {
+        .ip_cpu_bo = rte_be_to_cpu_32(arp->arp_data.arp_sip),
+        .intf = intf
+    };
+    struct ether_addr mac;
+    neigh_t *neigh = NULL;
+    uint64_t hw = 0;
+    int32_t pos = 0;
+
+    ether_addr_copy(&arp->arp_data.arp_sha, &mac);
+    if(neigh_hash == NULL || (pos = rte_hash_lookup(neigh_hash, &key)) < 0)
+        return;
+
+    neigh = &neighs[pos];
+    memcpy(&hw, &mac, ETHER_ADDR_LEN);
+    // The workers must see the key of a reused entry before its MAC
+    rte_smp_wmb();
+    neigh->hw = hw | NEIGH_VALID;
+    neigh->state = NEIGH_REACHABLE;
+    neigh->probes = 0;
+    neigh->timer = rte_rdtsc() + rte_get_tsc_hz() * NEIGH_REACHABLE_S;
+
+    LOG_DEBUG("Neighbor %u.%u.%u.%u on interface %u is at "
+                "%02x:%02x:%02x:%02x:%02x:%02x\n",
+                (uint8_t)(key.ip_cpu_bo >> 24), (uint8_t)(key.ip_cpu_bo >> 16),
+                (uint8_t)(key.ip_cpu_bo >> 8), (uint8_t)key.ip_cpu_bo,
+                key.intf, mac.addr_bytes[0], mac.addr_bytes[1],
+                mac.addr_bytes[2], mac.addr_bytes[3], mac.addr_bytes[4],
+                mac.addr_bytes[5]);
+
+    for(uint8_t i = 0; i < neigh->no_pending; ++i)
+        send_frame(cfg, neigh->pending[i], key.intf, &mac);
+    neigh->no_pending = 0;
+}
+
+/**
+ * \brief Send the ARP requests that are due and remove dead neighbors.
+ *
+ * A neighbor is removed if it did not answer NEIGH_MAX_PROBES requests or
+ * if no packet used its MAC since it was confirmed. The workers must not see
+ * the entry anymore before we free it -> We invalidate all dead neighbors
+ * first and wait for one quiescent state of all readers.
+ * Called regularly by the slow path.
+ *
+ * \param cfg The state of the slow path.
+ * \param now The current TSC.
+ */
+void age_neighs(intf_cfg_t *cfg, uint64_t now)
+{
+    const uint64_t retrans_tsc = rte_get_tsc_hz() * NEIGH_RETRANS_MS
+                                    / MS_PER_S;
+    neigh_key_t dead[NEIGH_MAX_ENTRIES];
+    const void *key = NULL;
+    void *data = NULL;
+    neigh_t *neigh = NULL;
+    uint32_t it = 0, no_dead = 0;
+    int32_t pos = 0;
+
+    while(
+        neigh_hash != NULL
+        && (pos = rte_hash_iterate(neigh_hash, &key, &data, &it)) >= 0
+    ) {
+        neigh = &neighs[pos];
+        if(now < neigh->timer)
+            continue;
+
+        if(
+            neigh->state == NEIGH_REACHABLE ? !neigh->used
+            : neigh->probes >= NEIGH_MAX_PROBES
+        ) {
+            neigh->hw = 0;
+            drop_pending(cfg, neigh);
+            dead[no_dead++] = neigh->key;
+            continue;
+        }
+
+        // Confirm a MAC in use while we keep using it
+        if(neigh->state == NEIGH_REACHABLE) {
+            neigh->state = NEIGH_PROBE;
+            neigh->used = false;
+        }
+        send_request(cfg, &neigh->key);
+        neigh->probes++;
+        neigh->timer = now + retrans_tsc;
+    }
+
+    if(no_dead == 0)
+        return;
+
+    wait_for_fib_readers();
+    for(uint32_t i = 0; i < no_dead; ++i)
+        rte_hash_del_key(neigh_hash, &dead[i]);
+    no_neighs -= no_dead;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Create an unresolved neighbor.
+ *
+ * \return The neighbor or NULL if the table is full.
+ */
+static neigh_t *add_neigh(const neigh_key_t *key, uint64_t now)
+{
+    neigh_t *neigh = NULL;
+    int32_t pos = 0;
+
+    if((pos = rte_hash_add_key(neigh_hash, key)) < 0)
+        return NULL;
+
+    neigh = &neighs[pos];
+    memset(neigh, 0, sizeof(neigh_t));
+    neigh->key = *key;
+    neigh->state = NEIGH_INCOMPLETE;
+    neigh->probes = 1; // The request sent by the caller
+    neigh->timer = now + rte_get_tsc_hz() * NEIGH_RETRANS_MS / MS_PER_S;
+    ++no_neighs;
+    return neigh;
+}
+
+/**
+ * \brief Broadcast an ARP request for a neighbor.
+ *
+ * Requests for interfaces without configuration or without a free buffer
+ * are not sent. The neighbor is asked again after NEIGH_RETRANS_MS.
+ */
+static void send_request(intf_cfg_t *cfg, const neigh_key_t *key)
+{
+    const intf_cfg_t *intf = find_intf_cfg(key->intf);
+    struct ether_addr bcast = {
+        .addr_bytes = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }
+    };
+    struct rte_mbuf *mbuf = NULL;
+    struct ether_hdr *eth = NULL;
+    struct arp_hdr *arp = NULL;
+
+    if(intf == NULL || (mbuf = rte_pktmbuf_alloc(neigh_pool)) == NULL)
+        return;
+
+    // Padded to the minimum frame size: Ring and pcap ports do not pad
+    eth = (struct ether_hdr *)rte_pktmbuf_append(mbuf,
+                                            ETHER_MIN_LEN - ETHER_CRC_LEN);
+    memset(eth, 0, ETHER_MIN_LEN - ETHER_CRC_LEN);
+    eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_ARP);
+
+    arp = (struct arp_hdr *)(eth + 1);
+    arp->arp_hrd = rte_cpu_to_be_16(ARP_HRD_ETHER);
+    arp->arp_pro = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+    arp->arp_hln = ETHER_ADDR_LEN;
+    arp->arp_pln = sizeof(uint32_t);
+    arp->arp_op = rte_cpu_to_be_16(ARP_OP_REQUEST);
+    ether_addr_copy(&intf->ether_addr, &arp->arp_data.arp_sha);
+    arp->arp_data.arp_sip = intf->ip_addr_be;
+    arp->arp_data.arp_tip = rte_cpu_to_be_32(key->ip_cpu_bo);
+
+    send_frame(cfg, mbuf, key->intf, &bcast);
+}
+
+/**
+ * \brief Drop the packets queued for a neighbor that did not answer.
+ */
+static void drop_pending(intf_cfg_t *cfg, neigh_t *neigh)
+{
+    lcore_stats[cfg->lcore].drops[DROP_NEIGH_FAILED] += neigh->no_pending;
+    drop_frames(neigh->pending, neigh->no_pending);
+    neigh->no_pending = 0;
+}
+
+/**
+ * \brief Get the configuration of an interface handled by this router.
+ *
+ * \return The configuration or NULL if we do not handle the interface.
+ */
+static const intf_cfg_t *find_intf_cfg(uint8_t intf)
+{
+    const intf_cfg_t *it = intf_cfgs;
+
+    while(it != NULL && it->intf != intf)
+        it = it->nxt;
+    return it;
+}
@@ -0,0 +1,196 @@
+/**
+ * This file resolves the MACs of next hops given by their IPv4 address.
+ *
+ * Routes may name the IPv4 address of their next hop instead of its MAC.
+ * The neighbor table maps (interface, IPv4 address) to the MAC learned by
+ * ARP. The workers only read the table. Packets to neighbors without a MAC
+ * and all ARP packets are handed to the slow path. See slow_path.h.
+ * The slow path is the only writer of the table: It sends the ARP requests,
+ * queues a few packets per unresolved neighbor, sends them as soon as the
+ * reply arrives and ages out unused neighbors.
+ */
+#ifndef NEIGH_H__
+#define NEIGH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_config.h>
+#include <rte_ether.h>
+#include <rte_hash.h>
+#include <rte_arp.h>
+#include <rte_atomic.h>
+#include <rte_mbuf.h>
+
+#include "router.h"
+#include "routing_table_additional.h"
+#include "global.h"
+
+#define NEIGH_MAX_ENTRIES 4096
+// Packets queued per unresolved neighbor. Further packets are dropped.
+#define NEIGH_QUEUE_LEN 8
+// Time between two ARP requests of an unresolved neighbor
+#define NEIGH_RETRANS_MS 1000
+// ARP requests without reply until a neighbor is removed
+#define NEIGH_MAX_PROBES 3
+// Time a learned MAC is used without being confirmed
+#define NEIGH_REACHABLE_S 60
+
+// Next hops given by IPv4 address are stored in the routing table as MAC
+// 01:00:<IPv4 address>. The MAC of a next hop is never a multicast MAC.
+#define NEIGH_HOP_MAC_PREFIX 0x0001
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+typedef struct neigh_key {
+    uint32_t ip_cpu_bo;
+    uint8_t intf;
+    uint8_t pad[3];
+} neigh_key_t;
+
+typedef enum neigh_state {
+    NEIGH_INCOMPLETE, // Waiting for the first ARP reply
+    NEIGH_REACHABLE, // MAC confirmed less than NEIGH_REACHABLE_S ago
+    NEIGH_PROBE // MAC still in use, waiting for the confirmation
+} neigh_state_t;
+
+typedef struct neigh {
+    // Read by the workers: The MAC in the lower 6 bytes, NEIGH_VALID if the
+    // MAC may be used. One word -> The workers never see half a MAC.
+    volatile uint64_t hw;
+    volatile bool used; // Set by the workers, cleared by the slow path
+    // Written by the slow path before the MAC gets valid, checked by the
+    // workers
+    neigh_key_t key;
+    // Slow path only
+    neigh_state_t state;
+    uint8_t probes;
+    uint64_t timer; // TSC of the next probe or the expiry
+    uint8_t no_pending;
+    struct rte_mbuf *pending[NEIGH_QUEUE_LEN];
+} __rte_cache_aligned neigh_t;
+
+#define NEIGH_VALID (1ULL << 63)
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int init_neigh(void);
+void free_neigh(void);
+void resolve_neigh(intf_cfg_t *cfg, struct rte_mbuf *mbuf, uint8_t intf,
+                    uint32_t ip_cpu_bo);
+void learn_neigh(intf_cfg_t *cfg, const struct arp_hdr *arp, uint8_t intf);
+void age_neighs(intf_cfg_t *cfg, uint64_t now);
+uint get_no_neighs(void);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern struct rte_hash *neigh_hash;
+extern neigh_t *neighs;
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Get the MAC stored in the routing table for a next hop IP.
+ *
+ * \param mac The MAC representing the next hop.
+ * \param ip_cpu_bo The IPv4 address of the next hop in little endian format.
+ */
+static inline void get_neigh_hop_mac(struct ether_addr *mac,
+                                        uint32_t ip_cpu_bo)
+{
+    mac->addr_bytes[0] = NEIGH_HOP_MAC_PREFIX & 0xFF;
+    mac->addr_bytes[1] = NEIGH_HOP_MAC_PREFIX >> 8;
+    mac->addr_bytes[2] = (uint8_t)(ip_cpu_bo >> 24);
+    mac->addr_bytes[3] = (uint8_t)(ip_cpu_bo >> 16);
+    mac->addr_bytes[4] = (uint8_t)(ip_cpu_bo >> 8);
+    mac->addr_bytes[5] = (uint8_t)ip_cpu_bo;
+}
+
+/**
+ * \brief Check if the next hop of a routing table entry is given by IP.
+ */
+static inline bool is_neigh_hop(const rt_entry_t *entry)
+{
+    return is_multicast_ether_addr(&entry->dst_mac);
+}
+
+/**
+ * \brief Check if the next hop of an adjacency is given by IP.
+ */
+static inline bool is_neigh_adj(const adj_t *adj)
+{
+    return is_multicast_ether_addr((const struct ether_addr *)adj->l2);
+}
+
+/**
+ * \brief Get the IPv4 address of a next hop MAC of get_neigh_hop_mac().
+ *
+ * \return The address in little endian format.
+ */
+static inline uint32_t get_neigh_mac_ip(const struct ether_addr *mac)
+{
+    const uint8_t *b = mac->addr_bytes;
+
+    return (uint32_t)b[2] << 24 | (uint32_t)b[3] << 16
+            | (uint32_t)b[4] << 8 | b[5];
+}
+
+/**
+ * \brief Get the IPv4 address of a next hop given by IP.
+ *
+ * \return The address in little endian format.
+ */
+static inline uint32_t get_neigh_hop_ip(const rt_entry_t *entry)
+{
+    return get_neigh_mac_ip(&entry->dst_mac);
+}
+
+/**
+ * \brief Look up the MAC of a neighbor.
+ *
+ * Lock-free. The calling lcore must be a registered reader of the routing
+ * table: The slow path invalidates a dead neighbor and waits for the
+ * quiescent state of all readers before it removes the key. The hash of DPDK
+ * may miss a key while the slow path moves it -> The packet takes the slow
+ * path once more. A lookup that raced with the removal may return the
+ * position of a new neighbor -> We check the key after we read the MAC.
+ *
+ * \param intf The interface of the neighbor.
+ * \param ip_cpu_bo The IPv4 address of the neighbor in little endian format.
+ * \param mac The MAC of the neighbor.
+ *
+ * \return 0 if the MAC is known.
+ *          Errors: ERR_NO_ROUTE: The neighbor is not resolved.
+ */
+static inline int neigh_lookup(uint8_t intf, uint32_t ip_cpu_bo,
+                                struct ether_addr *mac)
+{
+    neigh_key_t key = { .ip_cpu_bo = ip_cpu_bo, .intf = intf, .pad = { 0 } };
+    neigh_t *neigh = NULL;
+    uint64_t hw = 0;
+    int32_t pos = 0;
+
+    if(neigh_hash == NULL || (pos = rte_hash_lookup(neigh_hash, &key)) < 0)
+        return ERR_NO_ROUTE;
+
+    neigh = &neighs[pos];
+    hw = neigh->hw;
+    // The key is written before the MAC is made valid. See learn_neigh().
+    rte_smp_rmb();
+    if(
+        !(hw & NEIGH_VALID) || neigh->key.ip_cpu_bo != ip_cpu_bo
+        || neigh->key.intf != intf
+    )
+        return ERR_NO_ROUTE;
+    if(!neigh->used) // Do not write the shared cache line on every packet
+        neigh->used = true;
+    memcpy(mac, &hw, ETHER_ADDR_LEN);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_byteorder.h>
+
+#include "pcap_file.h"
+#include "global.h"
+
+#define INIT_NO_FRAMES 1024
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static uint32_t get_u32(uint32_t val, bool swap);
+static int add_frame(pcap_trace_t *trace, uint32_t *size, uint16_t len);
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Load all frames of a capture file into memory.
+ *
+ * Frames that were truncated by the capture or are longer than max_len
+ * are skipped and counted.
+ *
+ * \param path The capture file.
+ * \param max_len Length of the longest frame we keep.
+ * \param trace The frames. Free them with free_pcap().
+ *
+ * \return 0 on success.
+ *          Errors: ERR_GEN: Cannot read the file.
+ *                  ERR_FORMAT: No Ethernet capture or a truncated file.
+ *                  ERR_MEM: Not enough memory.
+ */
+int read_pcap(const char *path, uint16_t max_len, pcap_trace_t *trace)
+{
+    FILE *file = NULL;
+    pcap_file_hdr_t hdr;
+    pcap_rec_hdr_t rec;
+    uint32_t caplen = 0, len = 0, size = 0;
+    size_t rd = 0;
+    long file_len = 0;
+    bool swap = false;
+    int err = 0;
+
+    memset(trace, 0, sizeof(pcap_trace_t));
+    if((file = fopen(path, "rb")) == NULL) {
+        printf("Cannot open the capture %s!\n", path);
+        return ERR_GEN;
+    }
+
+    if(fread(&hdr, sizeof(hdr), 1, file) != 1) {
+        fclose(file);
+        return ERR_FORMAT;
+    }
+    swap = hdr.magic == rte_bswap32(PCAP_MAGIC)
+            || hdr.magic == rte_bswap32(PCAP_MAGIC_NS);
+    if(
+        (get_u32(hdr.magic, swap) != PCAP_MAGIC
+            && get_u32(hdr.magic, swap) != PCAP_MAGIC_NS)
+        || get_u32(hdr.linktype, swap) != PCAP_LINKTYPE_ETHERNET
+    ) {
+        printf("%s is no Ethernet capture in the pcap format!\n", path);
+        fclose(file);
+        return ERR_FORMAT;
+    }
+
+    // The frames never take more memory than the file
+    if(
+        fseek(file, 0, SEEK_END) != 0 || (file_len = ftell(file)) < 0
+        || fseek(file, sizeof(hdr), SEEK_SET) != 0
+    ) {
+        fclose(file);
+        return ERR_GEN;
+    }
+    if((trace->data = malloc(file_len > 0 ? file_len : 1)) == NULL) {
+        fclose(file);
+        return ERR_MEM;
+    }
+
+    while((rd = fread(&rec, 1, sizeof(rec), file)) == sizeof(rec)) {
+        caplen = get_u32(rec.caplen, swap);
+        len = get_u32(rec.len, swap);
+        if(caplen > PCAP_SNAPLEN) {
+            err = ERR_FORMAT;
+            break;
+        }
+        if(caplen != len || len > max_len) {
+            trace->no_skipped++;
+            if(fseek(file, caplen, SEEK_CUR) != 0) {
+                err = ERR_FORMAT;
+                break;
+            }
+            continue;
+        }
+
+        if((err = add_frame(trace, &size, (uint16_t)len)) < 0)
+            break;
+        if(fread(trace->data + trace->offs[trace->no_frames], len, 1,
+                    file) != 1) {
+            err = ERR_FORMAT;
+            break;
+        }
+        trace->bytes += len;
+        trace->no_frames++;
+    }
+
+    // A partial record header is a truncated file as well
+    if(err == 0 && rd != 0)
+        err = ERR_FORMAT;
+    fclose(file);
+    if(err < 0) {
+        printf("Cannot read the capture %s!\n", path);
+        free_pcap(trace);
+    }
+    return err;
+}
+
+/**
+ * \brief Free the frames of a capture.
+ */
+void free_pcap(pcap_trace_t *trace)
+{
+    free(trace->data);
+    free(trace->offs);
+    free(trace->lens);
+    memset(trace, 0, sizeof(pcap_trace_t));
+}
+
+/**
+ * \brief Create a capture file and write its header.
+ *
+ * \param path The capture file. An existing file is replaced.
+ *
+ * \return The file or NULL if we cannot write it.
+ */
+FILE *create_pcap(const char *path)
+{
+    const pcap_file_hdr_t hdr = {
+        .magic = PCAP_MAGIC,
+        .version_major = PCAP_VERSION_MAJOR,
+        .version_minor = PCAP_VERSION_MINOR,
+        .thiszone = 0,
+        .sigfigs = 0,
+        .snaplen = PCAP_SNAPLEN,
+        .linktype = PCAP_LINKTYPE_ETHERNET
+    };
+    FILE *file = NULL;
+
+    if((file = fopen(path, "wb")) == NULL)
+        return NULL;
+    if(fwrite(&hdr, sizeof(hdr), 1, file) != 1) {
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+/**
+ * \brief Append frames to a capture file.
+ *
+ * \param file A file of create_pcap().
+ * \param mbufs The frames. Only the first segment is written.
+ * \param n Number of frames.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_GEN: Cannot write the file.
+ */
+int write_pcap(FILE *file, struct rte_mbuf **mbufs, uint16_t n)
+{
+    pcap_rec_hdr_t rec = { 0 };
+
+    for(uint16_t i = 0; i < n; ++i) {
+        rec.caplen = rec.len = rte_pktmbuf_data_len(mbufs[i]);
+        if(
+            fwrite(&rec, sizeof(rec), 1, file) != 1
+            || fwrite(rte_pktmbuf_mtod(mbufs[i], void *), rec.len, 1,
+                        file) != 1
+        )
+            return ERR_GEN;
+    }
+    return 0;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Convert a header field to the byte order of the host.
+ */
+static uint32_t get_u32(uint32_t val, bool swap)
+{
+    return swap ? rte_bswap32(val) : val;
+}
+
+/**
+ * \brief Make room for the next frame and set its offset and length.
+ *
+ * \param size The number of frames the arrays can hold.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int add_frame(pcap_trace_t *trace, uint32_t *size, uint16_t len)
+{
+    const uint32_t i = trace->no_frames;
+    uint64_t *offs = NULL;
+    uint16_t *lens = NULL;
+
+    if(i == *size) {
+        *size = *size == 0 ? INIT_NO_FRAMES : 2 * *size;
+        if((offs = realloc(trace->offs, *size * sizeof(uint64_t))) == NULL)
+            return ERR_MEM;
+        trace->offs = offs;
+        if((lens = realloc(trace->lens, *size * sizeof(uint16_t))) == NULL)
+            return ERR_MEM;
+        trace->lens = lens;
+    }
+
+    trace->offs[i] = i == 0 ? 0 : trace->offs[i - 1] + trace->lens[i - 1];
+    trace->lens[i] = len;
+    return 0;
+}
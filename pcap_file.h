@@ -0,0 +1,66 @@
+/**
+ * This file reads and writes capture files in the classic pcap format.
+ *
+ * A capture is loaded into memory at once -> Replaying it does not touch
+ * the file system. Only Ethernet captures are supported. The byte order
+ * and the timestamp resolution of a file are taken from its magic number.
+ * Written records have zero timestamps -> Two runs that send the same
+ * frames write byte-identical files.
+ */
+#ifndef PCAP_FILE_H__
+#define PCAP_FILE_H__
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <rte_config.h>
+#include <rte_mbuf.h>
+
+#define PCAP_MAGIC 0xa1b2c3d4
+#define PCAP_MAGIC_NS 0xa1b23c4d
+#define PCAP_VERSION_MAJOR 2
+#define PCAP_VERSION_MINOR 4
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_SNAPLEN 65535
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+typedef struct pcap_file_hdr {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t linktype;
+} pcap_file_hdr_t;
+
+typedef struct pcap_rec_hdr {
+    uint32_t ts_sec;
+    uint32_t ts_frac; // Microseconds or nanoseconds, see the magic
+    uint32_t caplen;
+    uint32_t len;
+} pcap_rec_hdr_t;
+
+/*
+ * The frames of a capture. The frames lie back to back in data.
+ */
+typedef struct pcap_trace {
+    uint8_t *data;
+    uint64_t *offs; // Offset of every frame in data
+    uint16_t *lens;
+    uint32_t no_frames;
+    uint32_t no_skipped; // Truncated or longer than the maximum length
+    uint64_t bytes; // Sum of all frame lengths
+} pcap_trace_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int read_pcap(const char *path, uint16_t max_len, pcap_trace_t *trace);
+void free_pcap(pcap_trace_t *trace);
+FILE *create_pcap(const char *path);
+int write_pcap(FILE *file, struct rte_mbuf **mbufs, uint16_t n);
+
+#endif
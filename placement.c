@@ -0,0 +1,217 @@
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_ethdev.h>
+#include <rte_lcore.h>
+
+#include "placement.h"
+#include "global.h"
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static int parse_cpu_mask(const char *def, uint16_t *cpus, uint max);
+static int add_cpu(uint16_t *cpus, uint *no_cpus, uint max, long cpu);
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Parse a set of CPUs.
+ *
+ * The set is either a corelist like 2,4-7 or a hexadecimal coremask like
+ * 0xF4. The order of a corelist is kept, a coremask is ordered ascending.
+ *
+ * \param def The corelist or coremask.
+ * \param cpus The parsed CPU IDs.
+ * \param max Size of cpus.
+ *
+ * \return The number of CPUs.
+ *          Errors: ERR_FORMAT: Invalid set, duplicate or too many CPUs.
+ */
+int parse_cpu_set(const char *def, uint16_t *cpus, uint max)
+{
+    const char *it = def;
+    char *end = NULL;
+    long first = 0, last = 0;
+    uint no_cpus = 0;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+    if(strncmp(def, "0x", 2) == 0 || strncmp(def, "0X", 2) == 0)
+        return parse_cpu_mask(def + 2, cpus, max);
+
+    do {
+        first = strtol(it, &end, 10);
+        if(end == it || first < 0)
+            return ERR_FORMAT;
+        last = first;
+        if(*end == '-') {
+            it = end + 1;
+            last = strtol(it, &end, 10);
+            if(end == it || last < first)
+                return ERR_FORMAT;
+        }
+        for(; first <= last; ++first)
+            if(add_cpu(cpus, &no_cpus, max, first) < 0)
+                return ERR_FORMAT;
+        it = end + 1;
+    } while(*end == ',');
+
+    return *end == '\0' ? (int)no_cpus : ERR_FORMAT;
+}
+
+/**
+ * \brief Get the CPUs this process may run on.
+ *
+ * \param cpus The CPU IDs in ascending order.
+ * \param max Size of cpus.
+ *
+ * \return The number of CPUs.
+ *          Errors: ERR_GEN: Cannot get the affinity of the process.
+ */
+int get_allowed_cpus(uint16_t *cpus, uint max)
+{
+    cpu_set_t set;
+    uint no_cpus = 0;
+
+    if(sched_getaffinity(0, sizeof(set), &set) != 0)
+        return ERR_GEN;
+
+    for(uint cpu = 0; cpu < CPU_SETSIZE && no_cpus < max; ++cpu)
+        if(CPU_ISSET(cpu, &set))
+            cpus[no_cpus++] = cpu;
+    return no_cpus > 0 ? (int)no_cpus : ERR_GEN;
+}
+
+/**
+ * \brief Build the --lcores argument of DPDK.
+ *
+ * The master lcore 0 is pinned to the first CPU. The workers 1..no_workers
+ * are pinned to the remaining CPUs, one CPU each. If there are not enough
+ * CPUs, workers share the CPUs round robin. With a single CPU, the master
+ * and all workers share it.
+ *
+ * \param buf The argument, e.g. --lcores=0@2,1@3,2@4.
+ * \param size Size of buf.
+ * \param cpus The CPUs to use.
+ * \param no_cpus Number of CPUs in cpus. Must not be 0.
+ * \param no_workers Number of worker lcores.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: buf is too small.
+ */
+int build_lcore_map(char *buf, size_t size, const uint16_t *cpus,
+                        uint no_cpus, uint no_workers)
+{
+    const uint no_worker_cpus = no_cpus > 1 ? no_cpus - 1 : 1;
+    const uint16_t *worker_cpus = no_cpus > 1 ? cpus + 1 : cpus;
+    int len = 0;
+
+    len = snprintf(buf, size, "--lcores=0@%u", cpus[0]);
+    for(uint lcore = 1; lcore <= no_workers && (size_t)len < size; ++lcore)
+        len += snprintf(buf + len, size - len, ",%u@%u", lcore,
+                        worker_cpus[(lcore - 1) % no_worker_cpus]);
+    if((size_t)len >= size)
+        return ERR_MEM;
+
+    if(no_workers > 0 && (no_workers > no_worker_cpus || no_cpus == 1))
+        printf("Warning: %u workers share %u CPUs. Use -c to give the "
+                "router more CPUs.\n", no_workers, no_cpus);
+    return 0;
+}
+
+/**
+ * \brief Assign the worker lcores to the interfaces.
+ *
+ * Every interface gets workers_per_intf lcores on the NUMA node of its NIC.
+ * If that node has no free lcore, we use one of another node and warn.
+ *
+ * \param intfs The list of interfaces.
+ * \param workers_per_intf Number of workers per interface.
+ * \param lcores The lcore of worker w of the i-th interface of the list
+ *              at index i * workers_per_intf + w.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_CFG: There are not enough worker lcores.
+ */
+int place_workers(const intf_cfg_t *intfs, uint workers_per_intf,
+                        uint16_t *lcores)
+{
+    bool used[RTE_MAX_LCORE] = { false };
+    const intf_cfg_t *it = NULL;
+    uint idx = 0, lcore = 0, chosen = 0;
+    int socket = 0;
+
+    for(it = intfs; it != NULL; it = it->nxt) {
+        socket = rte_eth_dev_socket_id(it->intf);
+
+        for(uint w = 0; w < workers_per_intf; ++w, ++idx) {
+            chosen = RTE_MAX_LCORE;
+            RTE_LCORE_FOREACH_SLAVE(lcore) {
+                if(used[lcore])
+                    continue;
+                if(socket < 0
+                    || (int)rte_lcore_to_socket_id(lcore) == socket) {
+                    chosen = lcore;
+                    break;
+                }
+                if(chosen == RTE_MAX_LCORE)
+                    chosen = lcore; // Remote fallback
+            }
+            if(chosen == RTE_MAX_LCORE)
+                return ERR_CFG;
+
+            if(socket >= 0 && (int)rte_lcore_to_socket_id(chosen) != socket)
+                printf("Warning: lcore %u serves interface %u from NUMA "
+                        "node %u instead of %d\n", chosen, it->intf,
+                        rte_lcore_to_socket_id(chosen), socket);
+            used[chosen] = true;
+            lcores[idx] = chosen;
+        }
+    }
+    return 0;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+static int parse_cpu_mask(const char *def, uint16_t *cpus, uint max)
+{
+    const size_t len = strlen(def);
+    uint no_cpus = 0;
+    int digit = 0;
+    char c = 0;
+
+    if(len == 0)
+        return ERR_FORMAT;
+
+    // The last digit holds the CPUs 0-3
+    for(size_t i = 0; i < len; ++i) {
+        c = tolower(def[len - 1 - i]);
+        if(!isxdigit(c))
+            return ERR_FORMAT;
+        digit = isdigit(c) ? c - '0' : c - 'a' + 10;
+        for(uint bit = 0; bit < 4; ++bit)
+            if(digit & (1 << bit)
+                && add_cpu(cpus, &no_cpus, max, i * 4 + bit) < 0)
+                return ERR_FORMAT;
+    }
+    return no_cpus > 0 ? (int)no_cpus : ERR_FORMAT;
+}
+
+static int add_cpu(uint16_t *cpus, uint *no_cpus, uint max, long cpu)
+{
+    if(*no_cpus >= max || cpu >= CPU_SETSIZE)
+        return ERR_FORMAT;
+    for(uint i = 0; i < *no_cpus; ++i)
+        if(cpus[i] == cpu)
+            return ERR_FORMAT;
+    cpus[(*no_cpus)++] = (uint16_t)cpu;
+    return 0;
+}
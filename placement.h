@@ -0,0 +1,30 @@
+/**
+ * This file places the lcores of the router on CPUs and the workers of the
+ * interfaces on lcores.
+ *
+ * The master is lcore 0 on the first CPU of the CPU set. The workers and the
+ * slow path are the lcores 1..N pinned to the remaining CPUs. After DPDK
+ * probed the devices, every interface gets workers on the NUMA node of its
+ * NIC. The slow path gets the remaining lcore.
+ */
+#ifndef PLACEMENT_H__
+#define PLACEMENT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <rte_config.h>
+
+#include "router.h"
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int parse_cpu_set(const char *def, uint16_t *cpus, uint max);
+int get_allowed_cpus(uint16_t *cpus, uint max);
+int build_lcore_map(char *buf, size_t size, const uint16_t *cpus,
+                        uint no_cpus, uint no_workers);
+int place_workers(const intf_cfg_t *intfs, uint workers_per_intf,
+                        uint16_t *lcores);
+
+#endif
@@ -0,0 +1,247 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_memcpy.h>
+
+#include "replay.h"
+#include "bench.h"
+#include "dpdk_init.h"
+#include "ethernet_stack.h"
+#include "pcap_file.h"
+#include "routing_table_additional.h"
+#include "slow_path.h"
+#include "global.h"
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static int replay_burst(intf_cfg_t *cfg, struct rte_mempool *pool,
+                        const pcap_trace_t *trace, uint32_t first,
+                        uint16_t n, uint64_t *cycles);
+static int drain_ports(FILE *out, uint64_t *sent);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+static bool enabled = false;
+static const char *in_path = NULL, *out_path = NULL;
+static uint32_t no_loops = 1;
+static int replay_intf = -1; // -1: The first configured interface
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Parse the replay definition and enable the replay mode.
+ *
+ * Format: <capture>[,out=<capture>][,loops=<n>][,intf=<id>]
+ *
+ * \param def The definition. It is modified and must stay valid.
+ *
+ * \return 0 if we could parse the definition.
+ *          Errors: ERR_FORMAT
+ */
+int parse_replay(char *def)
+{
+    char *key = NULL, *val = NULL, *save = NULL, *tmp = NULL;
+    long ltmp = 0;
+
+    if(def == NULL || (in_path = strtok_r(def, ",", &save)) == NULL)
+        return ERR_FORMAT;
+
+    while((key = strtok_r(NULL, ",", &save)) != NULL) {
+        if((val = strchr(key, '=')) == NULL)
+            return ERR_FORMAT;
+        *val++ = '\0';
+        if(strcmp(key, "out") == 0) {
+            out_path = val;
+            continue;
+        }
+
+        ltmp = strtol(val, &tmp, 10);
+        if(*tmp != '\0' || val == tmp)
+            return ERR_FORMAT;
+        if(strcmp(key, "loops") == 0 && ltmp >= 1 && ltmp <= INT32_MAX)
+            no_loops = (uint32_t)ltmp;
+        else if(strcmp(key, "intf") == 0 && ltmp >= 0
+                && ltmp < RTE_MAX_ETHPORTS)
+            replay_intf = (int)ltmp;
+        else
+            return ERR_FORMAT;
+    }
+
+    enabled = true;
+    return 0;
+}
+
+/**
+ * \brief Check if the router replays a capture.
+ */
+bool replay_enabled(void)
+{
+    return enabled;
+}
+
+/**
+ * \brief Get the interface the capture is received on.
+ *
+ * \return The interface or -1 for the first configured interface.
+ */
+int get_replay_intf(void)
+{
+    return replay_intf;
+}
+
+/**
+ * \brief Replay the capture through the datapath of a worker.
+ *
+ * The frames are copied from memory into fresh buffers as a NIC would
+ * write them. The pipeline cycles only count the datapath and the slow
+ * path, the wall clock rate includes the copies and the output.
+ *
+ * \param cfg The state of the worker. Set up for the calling lcore.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_GEN, ERR_FORMAT: See read_pcap(). Cannot write
+ *                                  the output capture.
+ *                  ERR_MEM: Not enough memory.
+ */
+int run_replay(intf_cfg_t *cfg)
+{
+    struct rte_mempool *pool =
+                get_socket_mempool(rte_eth_dev_socket_id(cfg->intf), true);
+    pcap_trace_t trace;
+    FILE *out = NULL;
+    uint64_t cycles = 0, sent = 0, written = 0, start = 0;
+    uint32_t loop = 0, i = 0;
+    uint16_t n = 0;
+    double secs = 0, frames = 0;
+    int err = 0;
+
+    if(pool == NULL)
+        return ERR_MEM;
+    if((err = read_pcap(in_path, rte_pktmbuf_data_room_size(pool)
+                            - RTE_PKTMBUF_HEADROOM, &trace)) < 0)
+        return err;
+    if(out_path != NULL && (out = create_pcap(out_path)) == NULL) {
+        printf("Cannot create the capture %s!\n", out_path);
+        free_pcap(&trace);
+        return ERR_GEN;
+    }
+    printf("Replaying %u frames (%u skipped) of %s on interface %u, "
+            "%u loops\n", trace.no_frames, trace.no_skipped, in_path,
+            cfg->intf, no_loops);
+
+    register_fib_reader();
+    start = rte_rdtsc();
+    for(loop = 0; loop < no_loops && err == 0; ++loop) {
+        for(i = 0; i < trace.no_frames && err == 0; i += n) {
+            n = RTE_MIN((uint32_t)REPLAY_BURST, trace.no_frames - i);
+            if((err = replay_burst(cfg, pool, &trace, i, n, &cycles)) == 0)
+                err = drain_ports(loop == 0 ? out : NULL, &sent);
+        }
+        if(loop == 0)
+            written = sent;
+    }
+    secs = (double)(rte_rdtsc() - start) / rte_get_tsc_hz();
+    unregister_fib_reader();
+
+    frames = (double)trace.no_frames * loop;
+    if(err == 0 && secs > 0 && cycles > 0) {
+        printf("Replay result: %u loops in %.3f s, %.3f Mpps "
+                "%.2f Gbit/s, pipeline %.3f Mpps (%.0f cycles per frame), "
+                "sent %"PRIu64" frames\n", loop, secs, frames / secs / 1e6,
+                (double)trace.bytes * loop * 8 / secs / 1e9,
+                frames * rte_get_tsc_hz() / cycles / 1e6, cycles / frames,
+                sent);
+    }
+    if(out != NULL) {
+        if(fclose(out) != 0 && err == 0)
+            err = ERR_GEN;
+        if(err == 0)
+            printf("Wrote %"PRIu64" frames to %s\n", written, out_path);
+        else
+            printf("Cannot write the capture %s!\n", out_path);
+    }
+    free_pcap(&trace);
+    return err;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Copy a burst of the capture into buffers and handle it.
+ *
+ * The worker sends the frames when the burst is handled. Frames for the
+ * slow path are handled right away.
+ *
+ * \param first Index of the first frame.
+ * \param n Number of frames.
+ * \param cycles Adds the cycles of the datapath and the slow path.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: The pool is exhausted.
+ */
+static int replay_burst(intf_cfg_t *cfg, struct rte_mempool *pool,
+                        const pcap_trace_t *trace, uint32_t first,
+                        uint16_t n, uint64_t *cycles)
+{
+    struct rte_mbuf *mbufs[REPLAY_BURST];
+    uint64_t start = 0;
+
+    if(rte_pktmbuf_alloc_bulk(pool, mbufs, n) != 0) {
+        printf("The mempool is exhausted!\n");
+        return ERR_MEM;
+    }
+    for(uint16_t i = 0; i < n; ++i) {
+        rte_memcpy(rte_pktmbuf_mtod(mbufs[i], void *),
+                    trace->data + trace->offs[first + i],
+                    trace->lens[first + i]);
+        mbufs[i]->data_len = mbufs[i]->pkt_len = trace->lens[first + i];
+        mbufs[i]->port = cfg->intf;
+    }
+
+    start = rte_rdtsc();
+    handle_frames(cfg, mbufs, n);
+    flush_frames(cfg);
+    while(serve_slow_path() > 0)
+        ;
+    fib_quiescent();
+    *cycles += rte_rdtsc() - start;
+    return 0;
+}
+
+/**
+ * \brief Take the frames the router sent on all interfaces.
+ *
+ * The frames are ordered by interface, then by TX queue.
+ *
+ * \param out The output capture or NULL.
+ * \param sent Adds the number of frames.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_GEN: Cannot write the output capture.
+ */
+static int drain_ports(FILE *out, uint64_t *sent)
+{
+    struct rte_mbuf *mbufs[REPLAY_BURST];
+    const intf_cfg_t *it = NULL;
+    uint16_t n = 0;
+    int err = 0;
+
+    for(it = intf_cfgs; it != NULL; it = it->nxt) {
+        while((n = drain_bench_port(it->intf, mbufs, REPLAY_BURST)) > 0) {
+            if(out != NULL && err == 0)
+                err = write_pcap(out, mbufs, n);
+            *sent += n;
+            drop_frames(mbufs, n);
+        }
+    }
+    return err;
+}
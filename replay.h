@@ -0,0 +1,32 @@
+/**
+ * This file contains the replay mode: The router forwards a captured trace.
+ *
+ * router-replay loads a pcap capture into memory and feeds it through the
+ * datapath of a worker and through the slow path on the master lcore, loop
+ * after loop. The interfaces are the ring ports of the benchmark mode. See
+ * bench.h. Every frame the router sends in the first loop is written to an
+ * output capture -> Compare it byte by byte with a golden capture.
+ * A single lcore handles the frames in their order -> The output only
+ * depends on the capture, the routes and the timers of the slow path (ICMP
+ * rate limits, ARP retransmissions).
+ */
+#ifndef REPLAY_H__
+#define REPLAY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "router.h"
+
+// Frames copied from the capture and handled at once
+#define REPLAY_BURST THREAD_BUFSIZE
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int parse_replay(char *def);
+bool replay_enabled(void);
+int get_replay_intf(void);
+int run_replay(intf_cfg_t *cfg);
+
+#endif
@@ -0,0 +1,40 @@
+#include <stdio.h>
+
+#include "router.h"
+#include "replay.h"
+#include "global.h"
+
+static char *usage_msg = "Replay a pcap capture through the router\n"
+                        "Usage: router-replay <replay_def> <router options>\n"
+                        "\t<replay_def> = <capture>[,out=<capture>][,loops=<n>][,intf=<id>]\n"
+                        "\tout: Write the frames the router sends in the first loop to a capture for a byte-exact comparison\n"
+                        "\tloops: Replay the capture this often for the throughput (Default: 1)\n"
+                        "\tintf: The interface the capture is received on (Default: The first of the -p options)\n"
+                        "The interfaces are ring ports, their IDs must be 0..<interfaces>-1. See router -h for the router options.\n";
+
+/**
+ * Main function of the replay.
+ */
+int main(int argc, char* argv[]) {
+    int err = 0;
+
+    if(argc < 2 || parse_replay(argv[1]) < 0) {
+        printf(usage_msg);
+        return ERR_GEN;
+    }
+
+    // The replay definition takes the place of the program name
+    switch(err = parse_args(argc - 1, argv + 1)) {
+        case 0:
+            err = start_router() < 0 ? -1 : 0;
+            break;
+        case 1: // Help printed
+            err = 0;
+            break;
+        default:
+            break;
+    }
+
+    clean_shutdown();
+    return err;
+}
@@ -1,8 +1,12 @@
 #include <arpa/inet.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <inttypes.h>
 #include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/prctl.h>
 
 #include <rte_config.h>
 #include <rte_mbuf.h>
@@ -12,16 +16,25 @@
 #include <rte_ip.h>
 #include <rte_byteorder.h>
 #include <rte_launch.h>
+#include <rte_cycles.h>
+#include <rte_interrupts.h>
 
 #include <arpa/inet.h>
 
 #include "router.h"
 #include "dpdk_init.h"
+#include "placement.h"
 #include "routing_table.h"
 #include "routing_table_additional.h"
 #include "ethernet_stack.h"
 #include "routing_table.h"
+#include "neigh.h"
+#include "fib6.h"
+#include "slow_path.h"
+#include "bench.h"
+#include "replay.h"
 #include "global.h"
+#include "log.h"
 
 // A route in the given format <IP>/<CIDR>,<MAC>,<interface>
 // must not be longer than 36 characters at max
@@ -31,41 +44,128 @@
 /**********************************
  *  Static function declarations  *
  **********************************/
-static int parse_install_route(const char *route);
+static int parse_install_route(const char *route, bool update);
+static int parse_route_file(const char *path);
+static int add_cmdline_routes(void);
 static int parse_intf_dev(const char *def);
+static int parse_tx_retries(const char *def);
+static int parse_stats_interval(const char *def);
+static int parse_mempool(char *def);
+static int parse_workers(const char *def);
+static bool workers_span_sockets(void);
+static int find_slow_lcore(void);
+static int parse_snapshot(const char *def);
 static int parse_mac(const char *s_mac, struct ether_addr *mac);
+static int parse_nxt_hop(const char *def, struct ether_addr *mac);
 static int cfg_intfs();
 static int dpdk_init();
 static int start_threads();
 static int router_thread(void *arg);
+static void serve_control(void);
+static int start_bench_lcores(void);
+static int start_replay(void);
+static bool uses_ring_ports(void);
+static int stop_router(void);
+static void init_idle(intf_cfg_t *cfg);
+static void idle(intf_cfg_t *cfg, uint32_t *sleep_us);
+static int parse_idle(const char *def);
+static void handle_route_update(char *cmd);
+static int parse_route_update(char *cmd);
+static int parse_del_route(const char *def);
 static void print_help();
 
 static char *help_msg = "DPDK-based software router\n"
-                        "Usage: router [-r <route_def>]* [-p <interface_def>]* [-h]\n"
-                        "\t-r: Add a route to the routing table <route_def> = <net_address>/prefix,<nxt_hop_mac>,<egress_iface>\n"
+                        "Usage: router [-r <route_def>]* [-f <route_file>]* [-p <interface_def>]* [-t <tx_retries>] [-w <workers>] [-c <cpus>] [-i <idle_def>] [-R] [-s <snapshot_def>] [-e <engine>] [-l <level>] [-S <interval>] [-m <pool_def>] [-B <bench_def>] [-h]\n"
+                        "\t-r: Add a route to the routing table <route_def> = <net_address>/prefix,<nxt_hop_mac>|<nxt_hop_ip>,<egress_iface>. The MAC of a next hop IP is resolved by ARP. <net_address> may be an IPv6 address with a next hop MAC\n"
+                        "\t-f: Add all routes of a file to the routing table. One <route_def> per line, '#' starts a comment line\n"
                         "\t-p: Specify a interface the router shall handle <interface_dev> = <interface_id>,<ip_address>\n"
-                        "\t-h: Print this help message\n";
+                        "\t-t: Retries on a full TX queue before frames are dropped <tx_retries> = <number>|block (Default: 4)\n"
+                        "\t-w: Worker lcores per interface. RSS spreads the packets of an interface over the RX queues of its workers (Default: 1)\n"
+                        "\t-c: CPUs of the router as corelist (e.g. 2,4-7) or hex coremask. The master uses the first CPU, every worker and the slow path lcore one of the others. Workers are placed on the NUMA node of their interface (Default: All CPUs the router may run on)\n"
+                        "\t-i: What a worker does if its RX queue is empty <idle_def> = poll|backoff[,<max_us>]|interrupt. poll: Busy polling. backoff: Sleeps doubling up to <max_us> (Default: 20). interrupt: Sleep until the RX queue signals packets, falls back to backoff without device support. The busy share of the lcores in the stats reports helps to choose (Default: backoff)\n"
+                        "\t-R: Replicate the routing table in the memory of every socket with worker lcores\n"
+                        "\t-s: Save the built routing table to or load it from a snapshot file <snapshot_def> = save|load,<file>\n"
+                        "\t-e: Lookup engine of the routing table <engine> = dir24-8|dxr|poptrie|lpm (default: dir24-8)\n"
+                        "\t-l: Runtime log level <level> = none|err|warn|info|debug (default: info). Levels above the one set at compile time are not available\n"
+                        "\t-S: Seconds between two reports of the datapath counters, 0 disables the reports (Default: 1)\n"
+                        "\t-m: Mbufs and handler of the mempools <pool_def> = auto|<mbufs>[,<handler>]. All ports of a socket share one pool. auto: Sized by the descriptors, workers and buffers. <handler>: Mempool handler of DPDK, e.g. ring_mp_mc or stack (Default: auto,ring_mp_mc)\n"
+                        "\t-B: Forward synthetic traffic instead of the NICs: Every interface is a ring port fed by a generator lcore and drained by a sink lcore that verifies the forwarded frames. Interface IDs must be 0..<interfaces>-1 <bench_def> = default|<key>=<value>[,<key>=<value>]*. Keys: dst=routes|uniform (hosts in the routed networks or random addresses), flows=<n> (Default: 1024), size=<bytes>|imix (Default: 64), invalid=<percent> and arp=<percent> (Default: 0), time=<seconds> (Stop the router after this time and exit with an error on corrupt frames. Default: 0, run until stdin is closed)\n"
+                        "\t-h: Print this help message\n"
+                        "Routes can be changed at runtime with one command per line on stdin:\n"
+                        "\tadd <route_def>\n"
+                        "\tdel <net_address>/prefix\n";
 
 
 /**********************************
  *       Lists and Fields         *
  **********************************/
 static uint no_intf = 0;
+static int tx_retries = TX_DEF_RETRIES;
+static int stats_interval = STATS_DEF_INTERVAL_S;
+static uint no_workers = DEF_WORKERS; // Per interface
+// Per lcore state of the workers, indexed by lcore
+static intf_cfg_t *workers[RTE_MAX_LCORE];
+// Lcore of worker w of the i-th interface at i * no_workers + w
+static uint16_t worker_lcores[RTE_MAX_LCORE];
+static uint16_t cpus[RTE_MAX_LCORE];
+static int no_cpus = 0; // 0: All CPUs we may run on
+static idle_mode_t idle_mode = IDLE_BACKOFF;
+static uint32_t idle_max_us = IDLE_DEF_MAX_US;
+static bool replicate_fib = false;
+// The -r and -f options and their arguments in the given order. The route
+// hash needs DPDK -> The routes are added after its initialization.
+static char **route_args = NULL;
+static uint no_route_args = 0;
+static bool save_snapshot = false, load_snapshot = false;
+static const char *snapshot_path = NULL;
+// The lcore handling ARP, ICMP and unresolved next hops for the workers
+static int slow_lcore = -1;
 intf_cfg_t *intf_cfgs = NULL;
+volatile bool router_running = true;
 
 int router_thread(void *arg)
 {
     intf_cfg_t* cfg = (intf_cfg_t *)arg;
 	struct rte_mbuf* buf[THREAD_BUFSIZE];
+    const uint64_t drain_tsc = rte_get_tsc_hz() / US_PER_S * TX_DRAIN_US;
+    lcore_stats_t *stats = &lcore_stats[cfg->lcore];
+    uint64_t last_flush = rte_rdtsc(), start = 0, now = 0;
+    uint32_t idle_polls = 0, sleep_us = 0;
 
-	while (1) {
-		uint32_t rx = recv_from_device(cfg->intf, cfg->num_rx_queues, buf, THREAD_BUFSIZE);
-        if (rx == 0)
-            usleep(100);
-		for (uint32_t i = 0; i < rx; ++i) {
-            handle_frame(cfg, buf[i]);
+    init_idle(cfg);
+    register_fib_reader();
+	while (router_running) {
+        start = rte_rdtsc();
+		uint32_t rx = rte_eth_rx_burst(cfg->intf, cfg->rx_queue, buf, THREAD_BUFSIZE);
+        if (rx > 0) {
+            handle_frames(cfg, buf, rx);
+            idle_polls = 0;
+            sleep_us = 0;
+        }
+
+        // The RX queues are drained or the frames waited long enough
+        if (rx < THREAD_BUFSIZE || rte_rdtsc() - last_flush > drain_tsc) {
+            flush_frames(cfg);
+            last_flush = rte_rdtsc();
+        }
+
+        // We do not hold any routing table entries between two bursts
+        fib_quiescent();
+
+        now = rte_rdtsc();
+        if (rx > 0) {
+            stats->busy_cycles += now - start;
+        } else {
+            stats->idle_cycles += now - start;
+            // Spin a little before we sleep -> Bursts keep a low latency
+            if (cfg->idle_mode != IDLE_POLL && ++idle_polls > IDLE_SPIN_POLLS) {
+                idle(cfg, &sleep_us);
+                stats->idle_cycles += rte_rdtsc() - now;
+            }
         }
 	}
+    flush_frames(cfg);
+    unregister_fib_reader();
 	return 0;
 }
 
@@ -90,19 +190,67 @@ int start_router()
         return ERR_GEN;
     }
 
+    if(add_cmdline_routes() < 0)
+        return ERR_GEN;
+
     if(cfg_intfs() < 0) {
         printf("Could not configure the interfaces! Aborting...\n");
         return ERR_GEN;
     }
 
-    // There might occur an error
-    build_routing_table();
+    if(no_intf > 0 && place_workers(intf_cfgs, no_workers,
+                                        worker_lcores) < 0) {
+        printf("Not enough worker lcores! Aborting...\n");
+        return ERR_GEN;
+    }
+    slow_lcore = find_slow_lcore();
+
+    // Place the routing table on the socket of the first worker. Workers on
+    // other sockets need a replica in their local memory.
+    set_routing_table_placement(
+                no_intf > 0 ? (int)rte_lcore_to_socket_id(worker_lcores[0])
+                            : SOCKET_ID_ANY,
+                replicate_fib || workers_span_sockets()
+    );
+
+    // Loading a snapshot replaces building the routing table
+    if(load_snapshot && load_routing_table(snapshot_path) == 0) {
+        printf("Loaded the routing table from %s\n", snapshot_path);
+    } else {
+        if(load_snapshot)
+            printf("Cannot load the routing table snapshot. Building it...\n");
+        // There might occur an error
+        build_routing_table();
+    }
+
+    if(save_snapshot && save_routing_table(snapshot_path) < 0)
+        printf("Cannot save the routing table snapshot!\n");
+
+    if(build_fib6(no_intf > 0 ? (int)rte_lcore_to_socket_id(worker_lcores[0])
+                                : SOCKET_ID_ANY) < 0)
+        return ERR_GEN;
+
+    if(init_neigh() < 0 || init_slow_path() < 0)
+        return ERR_GEN;
 
     printf("Starting to serve on %d interfaces!\n", no_intf);
 
+    // The lcores only write their events to the trace rings
+    start_trace_thread();
+    // The master replays a capture instead of starting the workers
+    if(replay_enabled())
+        return start_replay() < 0 ? ERR_GEN : 0;
     start_threads();
+    if(bench_enabled() && start_bench_lcores() < 0)
+        return ERR_GEN;
+
+    // The master lcore applies route updates and reports the counters
+    // while the others serve
+    serve_control();
 
     // Wait until all lcores have finished serving
+    if(bench_enabled() && stop_router() < 0)
+        return ERR_GEN;
     rte_eal_mp_wait_lcore();
     return 0;
 }
@@ -111,30 +259,68 @@ int start_router()
  * \brief Start packet processing on the different interfaces.
  * 
  * This functions starts the packet processing on the different lcores.
- * We pass the intf_cfg_t structure to the router_thread method responsible
- * for this interface as arguments.
+ * Every interface is served by no_workers lcores. Each of them polls its
+ * own RX queue of the interface and gets a copy of the intf_cfg_t
+ * structure of the interface that holds its per lcore state. We pass the
+ * copy to the router_thread method as argument.
+ * The slow path lcore gets the TX queue after the ones of the workers on
+ * every interface.
  * 
  * \return 0 on success.
  *          Errors: ERR_START If we could not start the thread on one core.
+ *                  ERR_MEM Cannot allocate the state of a worker.
  */
 static int start_threads() {
-    // lcore 0 is reserved for the MASTER
-    int it = 1;
-    intf_cfg_t *iterator = intf_cfgs;
+    // The lcores were assigned by place_workers()
+    uint idx = 0, lcore = 0;
+    intf_cfg_t *iterator = intf_cfgs, *egress = NULL, *worker = NULL;
 
-    for(; iterator != NULL; iterator = iterator->nxt, it++) {
-        iterator->num_rx_queues = no_intf;
-        iterator->lcore = it;
+    for(; iterator != NULL; iterator = iterator->nxt) {
         rte_eth_macaddr_get(iterator->intf, &iterator->ether_addr);
 
-        
-        if(rte_eal_remote_launch(router_thread, iterator, it) < 0) {
-            printf("Could not launch packet processing on lcore %d\n", it);
-            return ERR_START;
+        for(uint queue = 0; queue < no_workers; ++queue, ++idx) {
+            lcore = worker_lcores[idx];
+            if((worker = malloc(sizeof(intf_cfg_t))) == NULL)
+                return ERR_MEM;
+            memcpy(worker, iterator, sizeof(intf_cfg_t));
+            worker->lcore = lcore;
+            worker->rx_queue = queue;
+            worker->idle_mode = idle_mode;
+            worker->nxt = NULL;
+            workers[lcore] = worker;
+
+            // Every worker uses its own TX queue on every interface
+            for(egress = intf_cfgs; egress != NULL; egress = egress->nxt) {
+                if(setup_tx_port(worker, egress->intf, idx, tx_retries) < 0) {
+                    printf("Could not setup TX buffer of lcore %u for "
+                            "interface %d\n", lcore, egress->intf);
+                    return ERR_START;
+                }
+            }
+
+            if(rte_eal_remote_launch(router_thread, worker, lcore) < 0) {
+                printf("Could not launch packet processing on lcore %u\n",
+                        lcore);
+                return ERR_START;
+            }
+            printf("Starting to process RX queue %u of interface: %d on "
+                    "lcore %u (socket %u)\n", queue, worker->intf, lcore,
+                    rte_lcore_to_socket_id(lcore));
         }
-        printf("Starting to process packets of interface: %d on lcore %d\n",
-                iterator->intf, iterator->lcore);
     }
+
+    if(slow_lcore < 0)
+        return 0;
+    if(setup_slow_path(slow_lcore, idx, tx_retries) < 0) {
+        printf("Could not setup the TX buffers of the slow path\n");
+        return ERR_START;
+    }
+    if(rte_eal_remote_launch(slow_path_thread, NULL, slow_lcore) < 0) {
+        printf("Could not launch the slow path on lcore %d\n", slow_lcore);
+        return ERR_START;
+    }
+    printf("Starting the slow path on lcore %d (socket %u)\n", slow_lcore,
+            rte_lcore_to_socket_id(slow_lcore));
     return 0;
 }
 
@@ -164,6 +350,7 @@ int add_intf_cfg(uint8_t intf, uint32_t ip_addr) {
 
     if((*iterator = malloc(sizeof(intf_cfg_t))) == NULL)
         return ERR_MEM;
+    memset(*iterator, 0, sizeof(intf_cfg_t));
 
     (*iterator)->ip_addr_be = ip_addr;
     (*iterator)->intf = intf;
@@ -184,25 +371,39 @@ int add_intf_cfg(uint8_t intf, uint32_t ip_addr) {
  * 
  * Initialize DPDK by setting the number of cores to use, the number of memory
  * sockets and the coremask.
- * We will reserve no_intf + 1 threads for the router as lcore 0 is for the 
- * master -> Therefore, we can use 1..no_intf + 1 for the clients!
+ * We will reserve no_intf * no_workers + 2 threads for the router as lcore 0
+ * is for the master -> Therefore, we can use 1..no_intf * no_workers + 1 for
+ * the workers and the slow path! Every lcore is pinned to one CPU of the CPU
+ * set. See build_lcore_map().
+ * A benchmark gets two more lcores per interface. Benchmarks and replays
+ * run without NICs and huge pages.
  * 
  * \return 0 if the initilaization was successful.
  *          Errors: ERR_CFG: Some error occured while configuring DPDK.
  */
 static int dpdk_init()
 {
-    int argc = no_intf > 0 ? 3 : 2;
-	char* argv[argc];
-    char no_cores[32];
+    int argc = 3;
+	char* argv[7];
+    char lcore_map[2048];
 
-    argv[0] = "-c1";
+    argv[0] = "router";
     argv[1] = "-n1";
 
-    if(no_intf > 0) {
-        // +1 as we need one for the master thread (ID 0)
-        sprintf(no_cores, "--lcores=(0-%1.3u)@0", no_intf+1);
-        argv[2] = no_cores;    
+    if(no_cpus == 0 && (no_cpus = get_allowed_cpus(cpus, RTE_MAX_LCORE)) < 0)
+        return ERR_CFG;
+    // Lcore 0 is the master thread, 1..N are the workers and the slow path,
+    // the generators and sinks of a benchmark follow
+    if(build_lcore_map(lcore_map, sizeof(lcore_map), cpus, no_cpus,
+                        no_intf > 0 ? no_intf * no_workers + 1
+                                        + get_bench_lcores(no_intf) : 0) < 0)
+        return ERR_CFG;
+    argv[2] = lcore_map;
+    if(uses_ring_ports()) {
+        argv[argc++] = "--no-pci";
+        argv[argc++] = "--no-huge";
+        argv[argc++] = "-m";
+        argv[argc++] = BENCH_MEM_MB;
     }
 
 	if(rte_eal_init(argc, argv) == -1)
@@ -217,17 +418,49 @@ static int dpdk_init()
  * interfaces according to the intf_cfgs list.
  * 
  * \return 0 if interface configuration was successful for all interfaces.
- *          Errors: Currently none, but we use int as return type if we
- *                  want to use error messages in the future.
- *                  Therefore, the user should test if the return value
- *                  is smaller than zero for upwards compatibility.
+ *          Errors: ERR_CFG: A ring port interface ID is not below the
+ *                          number of interfaces.
+ *                  ERR_MEM: Not enough memory for the ring ports.
  */
 static int cfg_intfs()
 {
     intf_cfg_t *iterator = intf_cfgs;
+    int err = 0;
     
-    for(; iterator != NULL; iterator = iterator->nxt) {
-        configure_device(iterator->intf, no_intf);
+    // The ring ports of a benchmark or a replay replace the NICs
+    if(uses_ring_ports()) {
+        for(; iterator != NULL; iterator = iterator->nxt) {
+            if(iterator->intf >= no_intf) {
+                printf("Interfaces of ring ports must be 0..%u!\n",
+                        no_intf - 1);
+                return ERR_CFG;
+            }
+        }
+        if((err = create_bench_ports(no_intf, no_workers,
+                                        no_intf * no_workers + 1)) < 0)
+            return err;
+        // Every generator and sink or the replay holds a burst
+        for(uint i = 0; i < get_bench_lcores(no_intf); ++i)
+            reserve_lcore_mbufs(BENCH_BURST);
+        if(replay_enabled())
+            reserve_lcore_mbufs(REPLAY_BURST);
+    }
+
+    // Every worker polls one RX queue of its interface and owns one TX
+    // queue on every interface. The last TX queue belongs to the slow path.
+    // The pools are created with the first device -> Reserve all mbufs first.
+    for(; iterator != NULL; iterator = iterator->nxt)
+        reserve_port_mbufs(iterator->intf, no_workers,
+                            no_intf * no_workers + 1);
+    // Workers hold an RX burst, a TX buffer per interface and their ring to
+    // the slow path, the slow path a TX buffer per interface
+    for(uint i = 0; i < no_intf * no_workers; ++i)
+        reserve_lcore_mbufs((no_intf + 1) * THREAD_BUFSIZE + SLOW_RING_SIZE);
+    reserve_lcore_mbufs(no_intf * THREAD_BUFSIZE);
+
+    for(iterator = intf_cfgs; iterator != NULL; iterator = iterator->nxt) {
+        configure_device(iterator->intf, no_workers, no_intf * no_workers + 1,
+                            idle_mode == IDLE_INTERRUPT);
     }
 
     return 0;
@@ -239,7 +472,8 @@ static int cfg_intfs()
  * This method will parse a route given as command line argument to the router.
  * After checking the format, we add it to the routing table.
  * Routing definition example: 10.0.10.2/32,52:54:00:cb:ee:f4,0
- * Format: <net_address>/prefix,<nxt_hop_mac>,<egress_iface>
+ * Format: <net_address>/prefix,<nxt_hop_mac>|<nxt_hop_ip>,<egress_iface>
+ * IPv6 routes name the MAC of their next hop: 2001:db8::/32,52:54:00:cb:ee:f4,0
  * 
  * This function is designed to work on command line arguments.
  * In addition, we do not copy the input string to some local buffer.
@@ -251,14 +485,20 @@ static int cfg_intfs()
  * However, these entries are currently not used!
  * 
  * \param route a string containing a single route as command line argument.
+ * \param update Install the route in the routing table in use instead of
+ *              only adding it to the routes the table is built from.
  * \return 0 if we could parse the route.
- *          Errors: ERR_FORMAT
+ *          Errors: ERR_FORMAT, ERR_NOT_IMPL: Update of an IPv6 route.
+ *                  Errors of add_route(), fib_add_route() and
+ *                  fib6_add_route()
  */
-static int parse_install_route(const char *route)
+static int parse_install_route(const char *route, bool update)
 {
     char *cidr_start = NULL, *mac_start = NULL, *intf_start = NULL, *tmp = NULL;
     uint32_t net_addr = 0;
+    uint8_t net_addr6[IPV6_ADDR_LEN];
     uint8_t cidr = 0, intf_id = 0;
+    bool ipv6 = false;
     long ltmp = 0;
     struct ether_addr mac_addr;
 
@@ -285,21 +525,24 @@ static int parse_install_route(const char *route)
     intf_start++;
 
     // IP address cannot be converted
-    if(inet_pton(AF_INET, route, &net_addr) != 1)
-        return ERR_FORMAT;
+    if(inet_pton(AF_INET, route, &net_addr) != 1) {
+        if(inet_pton(AF_INET6, route, net_addr6) != 1)
+            return ERR_FORMAT;
+        ipv6 = true;
+    }
 
     ltmp = strtol(cidr_start, &tmp, 10);
     // Invalid CIDR
     if(tmp != mac_start - 1)
         return ERR_FORMAT;
-    if(((uint8_t)ltmp) != ltmp)
+    if(ltmp < 0 || ltmp > (ipv6 ? 128 : 32))
         return ERR_FORMAT;
     if(cidr_start == tmp)
         return ERR_FORMAT;
     cidr = (uint8_t)ltmp;
 
-    // Parse the MAC address
-    if(parse_mac(mac_start, &mac_addr) < 0)
+    // Parse the MAC address or the IP of the next hop
+    if(parse_nxt_hop(mac_start, &mac_addr) < 0)
         return ERR_FORMAT;
 
     ltmp = strtol(intf_start, &tmp, 10);
@@ -312,10 +555,422 @@ static int parse_install_route(const char *route)
         return ERR_FORMAT;
     intf_id = (uint8_t)ltmp;
 
-    add_route(rte_be_to_cpu_32(net_addr), cidr, &mac_addr, intf_id);
+    // The IPv6 table is built once -> IPv6 routes cannot be updated
+    if(ipv6)
+        return update ? ERR_NOT_IMPL
+                    : fib6_add_route(net_addr6, cidr, &mac_addr, intf_id);
+    if(update)
+        return fib_add_route(rte_be_to_cpu_32(net_addr), cidr, &mac_addr,
+                                intf_id);
+    return add_route(rte_be_to_cpu_32(net_addr), cidr, &mac_addr, intf_id);
+}
+
+/**
+ * \brief Parse the routing table snapshot definition.
+ * 
+ * Format: save|load,<file>
+ * 
+ * \param def The snapshot definition.
+ * \return 0 if we could parse the definition.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_snapshot(const char *def)
+{
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    if(strncmp(def, "save,", 5) == 0)
+        save_snapshot = true;
+    else if(strncmp(def, "load,", 5) == 0)
+        load_snapshot = true;
+    else
+        return ERR_FORMAT;
+
+    snapshot_path = def + 5;
+    if(*snapshot_path == '\0' || (save_snapshot && load_snapshot))
+        return ERR_FORMAT;
+    return 0;
+}
+
+/**
+ * \brief Parse a file of route definitions and add them to the routing table.
+ * 
+ * Every line contains one route definition. See parse_install_route().
+ * Empty lines and lines starting with '#' are ignored.
+ * 
+ * \param path The path of the file.
+ * \return 0 if we could parse all routes.
+ *          Errors: ERR_GEN: Cannot read the file.
+ *                  Errors of parse_install_route()
+ */
+static int parse_route_file(const char *path)
+{
+    FILE *file = NULL;
+    char line[128];
+    uint no_line = 0;
+    int ret = 0;
+
+    if((file = fopen(path, "r")) == NULL) {
+        printf("Cannot open the route file %s!\n", path);
+        return ERR_GEN;
+    }
+
+    while(fgets(line, sizeof(line), file) != NULL) {
+        ++no_line;
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '\0' || line[0] == '#')
+            continue;
+
+        if((ret = parse_install_route(line, false)) < 0) {
+            if(ret == ERR_FORMAT)
+                printf("Route definition in line %u of %s has an illegal "
+                        "format!\n", no_line, path);
+            break;
+        }
+    }
+
+    fclose(file);
+    return ret;
+}
+
+/**
+ * \brief Add the routes of the -r and -f options in the given order.
+ *
+ * \return 0 if all routes were added.
+ *          Errors: ERR_GEN
+ */
+static int add_cmdline_routes(void)
+{
+    int err = 0;
+
+    for(uint i = 0; i + 1 < no_route_args; i += 2) {
+        if(route_args[i][1] == 'f') {
+            if(parse_route_file(route_args[i + 1]) < 0)
+                return ERR_GEN;
+        } else if((err = parse_install_route(route_args[i + 1], false)) < 0) {
+            if(err == ERR_FORMAT)
+                printf("Route definition has an illegal format!\n");
+            return ERR_GEN;
+        }
+    }
     return 0;
 }
 
+/**
+ * \brief Prepare the idle strategy of a worker.
+ * 
+ * Called by the worker itself. If the RX queue cannot raise interrupts on
+ * this thread, the worker falls back to the backoff strategy.
+ * 
+ * \param cfg The state of the worker.
+ */
+static void init_idle(intf_cfg_t *cfg)
+{
+    if(cfg->idle_mode == IDLE_INTERRUPT
+        && rte_eth_dev_rx_intr_ctl_q(cfg->intf, cfg->rx_queue,
+                                        RTE_EPOLL_PER_THREAD,
+                                        RTE_INTR_EVENT_ADD, NULL) < 0) {
+        LOG_WARN("RX queue %u of interface %u has no interrupt. "
+                    "lcore %u backs off instead.\n", cfg->rx_queue,
+                    cfg->intf, cfg->lcore);
+        cfg->idle_mode = IDLE_BACKOFF;
+    }
+
+    // Sleeps of a few microseconds must not be extended by the default
+    // timer slack of 50 us
+    if(cfg->idle_mode == IDLE_BACKOFF)
+        prctl(PR_SET_TIMERSLACK, 1UL);
+}
+
+/**
+ * \brief Sleep because the RX queue of a worker is empty.
+ * 
+ * backoff: Every call sleeps twice as long as the previous one, at most
+ *          idle_max_us. This is the latency a packet arriving during a
+ *          sleep can get.
+ * interrupt: Wait for the interrupt of the RX queue. We are no reader of the
+ *          routing table meanwhile -> Updates do not wait for us.
+ * 
+ * \param cfg The state of the worker.
+ * \param sleep_us The previous sleep of the backoff. Reset to 0 if frames
+ *              were received.
+ */
+static void idle(intf_cfg_t *cfg, uint32_t *sleep_us)
+{
+    struct rte_epoll_event event;
+    struct timespec ts;
+
+    if(cfg->idle_mode == IDLE_INTERRUPT) {
+        unregister_fib_reader();
+        rte_eth_dev_rx_intr_enable(cfg->intf, cfg->rx_queue);
+        // A packet received before the interrupt was enabled might not
+        // raise it -> Bounded wait
+        rte_epoll_wait(RTE_EPOLL_PER_THREAD, &event, 1, IDLE_INTR_TIMEOUT_MS);
+        rte_eth_dev_rx_intr_disable(cfg->intf, cfg->rx_queue);
+        register_fib_reader();
+        return;
+    }
+
+    *sleep_us = *sleep_us == 0 ? 1 : RTE_MIN(*sleep_us * 2, idle_max_us);
+    ts.tv_sec = *sleep_us / US_PER_S;
+    ts.tv_nsec = (*sleep_us % US_PER_S) * 1000;
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * \brief Serve the control tasks of the master lcore.
+ * 
+ * We apply the route updates read from stdin. Every line of stdin contains
+ * one update command:
+ *      add <net_address>/prefix,<nxt_hop_mac>|<nxt_hop_ip>,<egress_iface>
+ *      del <net_address>/prefix
+ * Every command is visible to the lookups as soon as we parsed it. Only the
+ * routing table entries covered by the route are updated while the worker
+ * lcores keep forwarding.
+ * While waiting for commands, we report the datapath counters every
+ * stats_interval seconds.
+ * We return if stdin is closed and the reports are disabled or at the end
+ * of a benchmark.
+ */
+static void serve_control(void)
+{
+    struct pollfd pfd = { .fd = STDIN_FILENO, .events = POLLIN };
+    const uint64_t interval_tsc = rte_get_tsc_hz() * stats_interval;
+    uint64_t next_report = rte_rdtsc() + interval_tsc, now = 0;
+    const uint64_t bench_end = get_bench_end();
+    char buf[256], *eol = NULL;
+    size_t len = 0;
+    ssize_t rd = 0;
+    int timeout = -1;
+    bool stdin_open = true;
+
+    if(stats_interval > 0)
+        report_stats(stdout); // Start of the first interval
+
+    // A benchmark without an end runs until stdin is closed
+    while(
+        stdin_open || bench_end != 0
+        || (stats_interval > 0 && !bench_enabled())
+    ) {
+        now = rte_rdtsc();
+        if(bench_end != 0 && now >= bench_end)
+            break;
+        if(stats_interval > 0) {
+            timeout = now >= next_report ? 0 :
+                        (next_report - now) * MS_PER_S / rte_get_tsc_hz() + 1;
+        }
+        if(bench_end != 0 && (timeout < 0 || now + (uint64_t)timeout
+                                * rte_get_tsc_hz() / MS_PER_S > bench_end))
+            timeout = (bench_end - now) * MS_PER_S / rte_get_tsc_hz() + 1;
+
+        if(poll(&pfd, stdin_open ? 1 : 0, timeout) > 0) {
+            if((rd = read(STDIN_FILENO, buf + len, sizeof(buf) - len - 1)) <= 0)
+                stdin_open = false;
+            else
+                len += rd;
+            buf[len] = '\0';
+
+            // Apply all complete commands
+            while((eol = strchr(buf, '\n')) != NULL) {
+                *eol = '\0';
+                handle_route_update(buf);
+                len -= eol + 1 - buf;
+                memmove(buf, eol + 1, len + 1);
+            }
+            if(len == sizeof(buf) - 1 || (!stdin_open && len > 0)) {
+                handle_route_update(buf); // Too long or not terminated
+                len = 0;
+                buf[0] = '\0';
+            }
+        }
+
+        if(stats_interval > 0 && rte_rdtsc() >= next_report) {
+            report_stats(stdout);
+            if(bench_enabled())
+                report_bench(stdout);
+            next_report += interval_tsc;
+        }
+    }
+}
+
+/**
+ * \brief Launch the generators and sinks of the benchmark.
+ *
+ * They get the lcores the workers and the slow path left.
+ *
+ * \return 0 on success.
+ *          Errors: See start_bench().
+ */
+static int start_bench_lcores(void)
+{
+    uint16_t lcores[RTE_MAX_LCORE];
+    uint no_lcores = 0, lcore = 0, i = 0;
+
+    RTE_LCORE_FOREACH_SLAVE(lcore) {
+        for(i = 0; i < no_intf * no_workers && worker_lcores[i] != lcore; ++i)
+            ;
+        if(i == no_intf * no_workers && (int)lcore != slow_lcore)
+            lcores[no_lcores++] = lcore;
+    }
+    return start_bench(lcores, no_lcores, worker_lcores, no_intf * no_workers);
+}
+
+/**
+ * \brief Replay the capture on the master lcore.
+ *
+ * The master takes the place of a worker of the ingress interface: It uses
+ * the first TX queue of every interface, the slow path the last one.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_CFG: The ingress interface is not configured.
+ *                  ERR_START: Cannot set up the TX queues.
+ *                  ERR_MEM: Not enough memory.
+ *                  See run_replay().
+ */
+static int start_replay(void)
+{
+    const int ingress = get_replay_intf();
+    const uint lcore = rte_lcore_id();
+    intf_cfg_t *iterator = NULL, *cfg = NULL, *worker = NULL;
+    int err = 0;
+
+    for(iterator = intf_cfgs; iterator != NULL; iterator = iterator->nxt) {
+        rte_eth_macaddr_get(iterator->intf, &iterator->ether_addr);
+        if(cfg == NULL && (ingress < 0 || iterator->intf == ingress))
+            cfg = iterator;
+    }
+    if(cfg == NULL) {
+        printf("The interface of the replay is not configured!\n");
+        return ERR_CFG;
+    }
+
+    if((worker = malloc(sizeof(intf_cfg_t))) == NULL)
+        return ERR_MEM;
+    memcpy(worker, cfg, sizeof(intf_cfg_t));
+    worker->lcore = lcore;
+    worker->rx_queue = 0;
+    worker->idle_mode = IDLE_POLL;
+    worker->nxt = NULL;
+    workers[lcore] = worker;
+
+    for(iterator = intf_cfgs; iterator != NULL; iterator = iterator->nxt) {
+        if(setup_tx_port(worker, iterator->intf, 0, tx_retries) < 0)
+            return ERR_START;
+    }
+    if(setup_slow_path(lcore, no_intf * no_workers, tx_retries) < 0)
+        return ERR_START;
+
+    if(stats_interval > 0)
+        report_stats(stdout); // Start of the interval
+    err = run_replay(worker);
+    if(stats_interval > 0)
+        report_stats(stdout);
+    return err;
+}
+
+/**
+ * \brief Check if the interfaces are ring ports instead of NICs.
+ */
+static bool uses_ring_ports(void)
+{
+    return bench_enabled() || replay_enabled();
+}
+
+/**
+ * \brief Stop the benchmark and all lcores of the router.
+ *
+ * The workers get BENCH_DRAIN_MS to forward the frames the generators left
+ * in the RX rings. The sinks count all frames the router sent.
+ *
+ * \return 0 if all forwarded frames passed the checks of the sinks.
+ *          Errors: ERR_MISMATCH: The router forwarded corrupt frames.
+ */
+static int stop_router(void)
+{
+    stop_generators();
+    rte_delay_ms(BENCH_DRAIN_MS);
+
+    router_running = false;
+    for(uint i = 0; i < no_intf * no_workers; ++i)
+        rte_eal_wait_lcore(worker_lcores[i]);
+    if(slow_lcore >= 0)
+        rte_eal_wait_lcore(slow_lcore);
+
+    return stop_bench();
+}
+
+/**
+ * \brief Apply a single route update command and print the result.
+ * 
+ * \param cmd The command. Empty commands are ignored.
+ */
+static void handle_route_update(char *cmd)
+{
+    int ret = 0;
+
+    cmd[strcspn(cmd, "\r")] = '\0';
+    if(cmd[0] == '\0')
+        return;
+
+    if((ret = parse_route_update(cmd)) == ERR_FORMAT)
+        printf("Route update has an illegal format!\n");
+    else if(ret < 0)
+        printf("Could not update the routing table.\n");
+    else
+        printf("Routing table updated.\n");
+    fflush(stdout);
+}
+
+/**
+ * \brief Parse a route update command and apply it to the routing table.
+ * 
+ * \param cmd The command: 'add <route_def>' or 'del <net_address>/prefix'.
+ * \return 0 if we could parse and apply the command.
+ *          Errors: ERR_FORMAT, ERR_NO_ROUTE, Errors of fib_add_route()
+ */
+static int parse_route_update(char *cmd)
+{
+    if(strncmp(cmd, "add ", 4) == 0)
+        return parse_install_route(cmd + 4, true);
+    if(strncmp(cmd, "del ", 4) == 0)
+        return parse_del_route(cmd + 4);
+    return ERR_FORMAT;
+}
+
+/**
+ * \brief Parse a route to delete and remove it from the routing table.
+ * 
+ * Format: <net_address>/prefix
+ * 
+ * \param def The route to delete.
+ * \return 0 if we could parse and delete the route.
+ *          Errors: ERR_FORMAT, ERR_NO_ROUTE: There is no such route.
+ */
+static int parse_del_route(const char *def)
+{
+    char *cidr_start = NULL, *tmp = NULL;
+    uint32_t net_addr = 0;
+    long ltmp = 0;
+
+    // Missing CIDR
+    if((cidr_start = strstr(def, "/")) == NULL)
+        return ERR_FORMAT;
+    *cidr_start = '\0';
+    cidr_start++;
+
+    if(inet_pton(AF_INET, def, &net_addr) != 1)
+        return ERR_FORMAT;
+
+    ltmp = strtol(cidr_start, &tmp, 10);
+    if(*tmp != '\0' || cidr_start == tmp || ltmp < 0 || ltmp > 32)
+        return ERR_FORMAT;
+
+    if(fib_del_route(rte_be_to_cpu_32(net_addr), (uint8_t)ltmp) < 0) {
+        printf("There is no route for this network!\n");
+        return ERR_NO_ROUTE;
+    }
+    return 0;
+}
 
 /**
  * /brief Parse a single interface definition and add it to the interface config.
@@ -390,6 +1045,220 @@ static int parse_mac(const char *s_mac, struct ether_addr *mac)
     }
 }
 
+/**
+ * /brief Parse the next hop of a route.
+ * 
+ * The next hop is either its MAC or its IPv4 address. An IPv4 address is
+ * stored as the MAC representing it in the routing table. See neigh.h.
+ * 
+ * \param def a string containing the MAC or the IPv4 address.
+ * \param mac a buffer we shall put the MAC of the next hop in.
+ * \return 0 on successs.
+ *          Errors: ERR_FORMAT: Neither a MAC nor an IPv4 address or a
+ *                              multicast MAC.
+ */
+static int parse_nxt_hop(const char *def, struct ether_addr *mac)
+{
+    uint32_t ip_addr = 0;
+
+    if(strchr(def, ':') == NULL) {
+        if(inet_pton(AF_INET, def, &ip_addr) != 1)
+            return ERR_FORMAT;
+        get_neigh_hop_mac(mac, rte_be_to_cpu_32(ip_addr));
+        return 0;
+    }
+
+    if(parse_mac(def, mac) < 0 || is_multicast_ether_addr(mac))
+        return ERR_FORMAT;
+    return 0;
+}
+
+/**
+ * /brief Parse the TX retry policy.
+ * 
+ * The policy is either the number of retries on a full TX queue before we
+ * drop the frames or 'block' to retry until the queue accepts all frames.
+ * 
+ * \param def a string containing the TX retry policy.
+ * \return 0 if we could parse the policy.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_tx_retries(const char *def)
+{
+    long ltmp = 0;
+    char *tmp = NULL;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    if(strcmp(def, "block") == 0) {
+        tx_retries = TX_RETRY_BLOCK;
+        return 0;
+    }
+
+    ltmp = strtol(def, &tmp, 10);
+    if(*tmp != '\0' || def == tmp || ltmp < 0 || ltmp > INT16_MAX)
+        return ERR_FORMAT;
+
+    tx_retries = (int)ltmp;
+    return 0;
+}
+
+/**
+ * /brief Parse the interval of the stats reports.
+ * 
+ * \param def a string containing the interval in seconds. 0 disables the
+ *              reports.
+ * \return 0 if we could parse the interval.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_stats_interval(const char *def)
+{
+    long ltmp = 0;
+    char *tmp = NULL;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    ltmp = strtol(def, &tmp, 10);
+    if(*tmp != '\0' || def == tmp || ltmp < 0 || ltmp > INT16_MAX)
+        return ERR_FORMAT;
+
+    stats_interval = (int)ltmp;
+    return 0;
+}
+
+/**
+ * /brief Parse the size and the handler of the mempools.
+ * 
+ * Format: auto|<mbufs>[,<handler>]
+ * 
+ * \param def a string containing the mempool definition. The handler name
+ *              is used in place.
+ * \return 0 if we could parse the definition.
+ *          Errors: ERR_FORMAT: Invalid size or unknown handler.
+ */
+static int parse_mempool(char *def)
+{
+    char *handler = NULL, *tmp = NULL;
+    long ltmp = 0;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    if((handler = strchr(def, ',')) != NULL)
+        *handler++ = '\0';
+    if(strcmp(def, "auto") != 0) {
+        ltmp = strtol(def, &tmp, 10);
+        if(*tmp != '\0' || def == tmp || ltmp <= 0 || ltmp > MAX_MBUFS)
+            return ERR_FORMAT;
+    }
+
+    if(set_mempool_config((uint32_t)ltmp, handler) < 0)
+        return ERR_FORMAT;
+    return 0;
+}
+
+/**
+ * /brief Parse the idle strategy of the workers.
+ * 
+ * Format: poll|backoff[,<max_us>]|interrupt
+ * 
+ * \param def a string containing the idle strategy.
+ * \return 0 if we could parse the strategy.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_idle(const char *def)
+{
+    long ltmp = 0;
+    char *tmp = NULL;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    if(strcmp(def, "poll") == 0) {
+        idle_mode = IDLE_POLL;
+        return 0;
+    }
+    if(strcmp(def, "interrupt") == 0) {
+        idle_mode = IDLE_INTERRUPT;
+        return 0;
+    }
+    if(strncmp(def, "backoff", 7) != 0)
+        return ERR_FORMAT;
+
+    idle_mode = IDLE_BACKOFF;
+    if(def[7] == '\0')
+        return 0;
+    if(def[7] != ',')
+        return ERR_FORMAT;
+
+    def += 8;
+    ltmp = strtol(def, &tmp, 10);
+    if(*tmp != '\0' || def == tmp || ltmp < 1 || ltmp > US_PER_S)
+        return ERR_FORMAT;
+
+    idle_max_us = (uint32_t)ltmp;
+    return 0;
+}
+
+/**
+ * \brief Check if the workers run on more than one socket.
+ * 
+ * \return true if the workers use the memory of several sockets.
+ */
+static bool workers_span_sockets(void)
+{
+    for(uint idx = 1; idx < no_intf * no_workers; ++idx)
+        if(rte_lcore_to_socket_id(worker_lcores[idx])
+            != rte_lcore_to_socket_id(worker_lcores[0]))
+            return true;
+    return false;
+}
+
+/**
+ * \brief Get the lcore of the slow path.
+ * 
+ * The slow path uses the slave lcore that place_workers() left.
+ * 
+ * \return The lcore or -1 if there is no free lcore.
+ */
+static int find_slow_lcore(void)
+{
+    bool used[RTE_MAX_LCORE] = { false };
+    uint lcore = 0;
+
+    for(uint idx = 0; idx < no_intf * no_workers; ++idx)
+        used[worker_lcores[idx]] = true;
+    RTE_LCORE_FOREACH_SLAVE(lcore)
+        if(!used[lcore])
+            return (int)lcore;
+    return -1;
+}
+
+/**
+ * /brief Parse the number of worker lcores per interface.
+ * 
+ * \param def a string containing the number of workers.
+ * \return 0 if we could parse the number.
+ *          Errors: ERR_FORMAT
+ */
+static int parse_workers(const char *def)
+{
+    long ltmp = 0;
+    char *tmp = NULL;
+
+    if(def == NULL)
+        return ERR_FORMAT;
+
+    ltmp = strtol(def, &tmp, 10);
+    if(*tmp != '\0' || def == tmp || ltmp < 1 || ltmp >= RTE_MAX_LCORE)
+        return ERR_FORMAT;
+
+    no_workers = (uint)ltmp;
+    return 0;
+}
+
 /**
  * /brief Parse all command line arguments.
  * 
@@ -406,10 +1275,12 @@ int parse_args(int argc, char **argv)
     for (ctr = 1; ctr < argc && argv[ctr][0] == '-'; ++ctr) {
         switch (argv[ctr][1]) {
         case 'r':
-            if(parse_install_route(argv[++ctr]) < 0) {
-                printf("Route definition has an illegal format!\n");
+        case 'f':
+            if(route_args == NULL
+                && (route_args = malloc(argc * sizeof(char *))) == NULL)
                 return ERR_GEN;
-            }
+            route_args[no_route_args++] = argv[ctr];
+            route_args[no_route_args++] = argv[++ctr];
             break;
         case 'p':
             if((err = parse_intf_dev(argv[++ctr])) < 0) {
@@ -425,6 +1296,70 @@ int parse_args(int argc, char **argv)
                 return ERR_GEN;
             }
             break;
+        case 't':
+            if(parse_tx_retries(argv[++ctr]) < 0) {
+                printf("TX retries have an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'w':
+            if(parse_workers(argv[++ctr]) < 0) {
+                printf("Number of workers has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'c':
+            if((no_cpus = parse_cpu_set(argv[++ctr], cpus,
+                                        RTE_MAX_LCORE)) < 0) {
+                printf("CPU set has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'i':
+            if(parse_idle(argv[++ctr]) < 0) {
+                printf("Idle strategy has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'R':
+            replicate_fib = true;
+            break;
+        case 's':
+            if(parse_snapshot(argv[++ctr]) < 0) {
+                printf("Snapshot definition has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'e':
+            if(set_fib_engine(argv[++ctr]) < 0) {
+                printf("Unknown lookup engine!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'l':
+            if(set_log_level(argv[++ctr]) < 0) {
+                printf("Unknown log level!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'S':
+            if(parse_stats_interval(argv[++ctr]) < 0) {
+                printf("Stats interval has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'm':
+            if(parse_mempool(argv[++ctr]) < 0) {
+                printf("Mempool definition has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
+        case 'B':
+            if(parse_bench(argv[++ctr]) < 0) {
+                printf("Benchmark definition has an illegal format!\n");
+                return ERR_GEN;
+            }
+            break;
         case 'h':
             print_help();
             return 1;
@@ -436,6 +1371,12 @@ int parse_args(int argc, char **argv)
     if(no_intf == 0)
                 printf("Warning:"
                     "No interfaces specified the router shall handle.\n");
+    // Lcore 0 is the master, one lcore serves the slow path
+    if(no_intf * no_workers + 1 >= RTE_MAX_LCORE) {
+        printf("Too many workers! At most %d lcores are supported.\n",
+                RTE_MAX_LCORE);
+        return ERR_GEN;
+    }
     return 0;
 }
 
@@ -456,10 +1397,24 @@ void clean_shutdown(void)
 
     clean_tmp_routing_table();
     clean_routing_table();
+    clean_fib6();
+    free_slow_path();
+    free_neigh();
+    free_bench();
+    for(uint lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        if(workers[lcore] != NULL) {
+            free_tx_ports(workers[lcore]);
+            free(workers[lcore]);
+            workers[lcore] = NULL;
+        }
+    }
     while(intf_it != NULL) {
         intf_nxt = intf_it->nxt;
         free(intf_it);
         intf_it = intf_nxt;
     }
+    free(route_args);
+    route_args = NULL;
+    no_route_args = 0;
 }
 
@@ -2,27 +2,73 @@
 #define ROUTER_H__
 #include <rte_ether.h>
 #include <rte_ip.h>
+#include <rte_ethdev.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <unistd.h>
 #include <inttypes.h>
 
+#include "stats.h"
+
 // Size of the receive buffer of a single thread
 #define THREAD_BUFSIZE 64
+// Maximum time frames may wait in a TX buffer if we keep receiving full bursts
+#define TX_DRAIN_US 100
+// Number of TX retries on a full queue before we drop the frames
+#define TX_DEF_RETRIES 4
+// Retry value telling us to block until the TX queue accepts all frames
+#define TX_RETRY_BLOCK -1
+// Default number of worker lcores per interface
+#define DEF_WORKERS 1
+// Empty polls before an idle lcore starts to sleep
+#define IDLE_SPIN_POLLS 64
+// Default latency cap of the exponential backoff
+#define IDLE_DEF_MAX_US 20
+// Maximum time an lcore waits for an RX interrupt
+#define IDLE_INTR_TIMEOUT_MS 10
+// Largest mempool of the -m option
+#define MAX_MBUFS (1 << 24)
 
 
 /**********************************
  *  Static structure definitions  *
  **********************************/
+/*
+ * What a worker does if its RX queue stays empty.
+ */
+typedef enum idle_mode {
+    IDLE_POLL, // Busy polling, lowest latency
+    IDLE_BACKOFF, // Exponentially growing sleeps up to a latency cap
+    IDLE_INTERRUPT // Sleep until the RX queue raises an interrupt
+} idle_mode_t;
+
+/*
+ * Per lcore TX state of a single egress interface.
+ * Frames are buffered until the buffer is full or flushed by the
+ * router_thread.
+ */
+typedef struct tx_port {
+    struct rte_eth_dev_tx_buffer *buf;
+    uint8_t intf;
+    uint16_t queue;
+    struct ether_addr s_ether; // MAC of the interface
+    int retries; // Retries on a full queue. TX_RETRY_BLOCK: never drop
+    lcore_stats_t *stats; // Counters of the lcore
+} tx_port_t;
+
 typedef struct intf_cfg {
     uint8_t intf;
     uint32_t ip_addr_be; // Efficiency reason: IP address in big endian format
     struct ether_addr ether_addr;
     // The lcore argument tells the router_thread the lcore it is executed in
-    // In addition, this number-1 gives us the transeive queue number we have
-    // to use for ever interface
     uint16_t lcore;
-    uint16_t num_rx_queues;
+    uint16_t rx_queue; // The RX queue of intf this lcore polls
+    idle_mode_t idle_mode;
+    // TX state of this lcore for every egress interface (NULL: unused)
+    tx_port_t *tx_ports[RTE_MAX_ETHPORTS];
+    uint8_t tx_port_ids[RTE_MAX_ETHPORTS];
+    uint8_t no_tx_ports;
     struct intf_cfg *nxt;
 } intf_cfg_t;
 
@@ -30,6 +76,8 @@ typedef struct intf_cfg {
  *         Public fields          *
  **********************************/
 extern intf_cfg_t *intf_cfgs;
+// Cleared to let the workers and the slow path return
+extern volatile bool router_running;
 
 
 /**********************************
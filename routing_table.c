@@ -1,88 +1,210 @@
 #include <arpa/inet.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <immintrin.h>
 
 #include <rte_ether.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_atomic.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_hash.h>
+#include <rte_hash_crc.h>
+#include <rte_launch.h>
 
 #include "routing_table.h"
 #include "routing_table_additional.h"
+#include "fib_engines.h"
 #include "global.h"
+#include "log.h"
 
 /**********************************
  *    Global field definitions    *
  **********************************/
-tmp_route_t *tmp_route_list = NULL;
-tbl24_entry_t *tbl24 = NULL;
-tbllong_entry_t *tbllong = NULL;
-uint no_tbllong_entries = 0;
-rt_entry_t *nxt_hops_map = NULL;
-uint curr_size_nxt_hops_tab = 0;
-uint no_nxt_hops = 0; // Number of valid entries
+// Tables used by the lookups of every socket. Replaced by
+// update_routing_table() while the workers keep forwarding
+dir24_8_t *volatile fibs[RTE_MAX_NUMA_NODES];
+fib_reader_t fib_readers[RTE_MAX_LCORE];
+
+// The published tables located on fib_socket -> Used by the print functions
+static dir24_8_t *primary_fib = NULL;
+// Socket the primary tables are allocated on and if every socket with lcores
+// shall get its own replica of the tables
+static int fib_socket = SOCKET_ID_ANY;
+static bool replicate_fib = false;
+// Lookup engine of new tables. NULL: Dir-24-8
+static const fib_engine_t *fib_engine = NULL;
+static const fib_engine_t *const engines[] = {
+    &dxr_engine, &poptrie_engine, &lpm_engine
+};
+
+// All routes indexed by network and prefix -> route_key_t to tmp_route_t*
+static struct rte_hash *route_hash = NULL;
+static uint32_t route_hash_size = 0;
+static uint no_routes = 0;
+
+/*
+ * Routes from /8 to /24 of different /8 networks never update the same
+ * TBL24 entries. Thus, we fill the Dir-24-8 structure with one slice per
+ * /8 network in parallel.
+ */
+#define FILL_MIN_PRF 8
+#define NO_FILL_SLICES 256
+#define FILL_SLICE_PRFS (24 - FILL_MIN_PRF + 1)
+#define NO_SORT_KEYS (FILL_MIN_PRF + NO_FILL_SLICES * FILL_SLICE_PRFS + 8)
+
+typedef struct fill_job {
+    dir24_8_t *fib;
+    tmp_route_t **routes; // Routes sorted by sort_routes()
+    uint slices[NO_FILL_SLICES + 1]; // First route of every slice
+    rte_atomic32_t nxt_slice;
+} fill_job_t;
 
 
 /**********************************
  *  Static funciton decalarations *
  **********************************/
-static int alloc_hop_ids(void);
+static tmp_route_t *store_route(uint32_t dst_net, uint8_t prf,
+                                struct ether_addr *mac, uint8_t intf);
+static tmp_route_t *find_route(uint32_t dst_net, uint8_t prf);
+static void get_route_key(route_key_t *key, uint32_t dst_net, uint8_t prf);
+static struct rte_hash *create_hash(const char *type, uint32_t entries,
+                                    uint32_t key_len, int socket);
+static int grow_route_hash(void);
+static uint get_sort_key(const tmp_route_t *route);
+static tmp_route_t **sort_routes(uint *slices);
+static int fill_fib_slices(void *arg);
+static const tmp_route_t *find_covering_route(uint32_t dst_net, uint8_t prf);
+static uint32_t prf_to_netmask(uint8_t prf);
+static int alloc_hop_ids(dir24_8_t *fib);
+static adj_t *alloc_adjs(const dir24_8_t *fib, uint32_t size);
+static int get_hop_id(dir24_8_t *fib, uint8_t intf,
+                        const struct ether_addr *mac);
+static void get_nxt_hop_key(nxt_hop_key_t *key, uint8_t intf,
+                            const struct ether_addr *mac);
+static int rebuild_hop_hash(dir24_8_t *fib, uint32_t entries);
+static bool is_published(const dir24_8_t *fib);
+static uint get_published_fibs(dir24_8_t **out);
+static int reserve_tbllong_group(dir24_8_t *fib);
+static int grow_tbllong(dir24_8_t *fib);
+static int alloc_tbllong_group(dir24_8_t *fib);
+static void recycle_tbllong_group(dir24_8_t *fib, uint32_t tbl24_idx);
+static int insert_route(dir24_8_t *fib, uint32_t dst_net, uint8_t prf,
+                        uint32_t hop_id);
+static void remove_route(dir24_8_t *fib, uint32_t dst_net, uint8_t prf,
+                            uint32_t cover_hop_id, uint8_t cover_prf);
+static dir24_8_t *create_fib(int socket, uint tbllong_groups);
+static dir24_8_t *create_engine_fib(const fib_engine_t *engine, int socket);
+static void free_fib(dir24_8_t *fib);
+static int fill_fib(dir24_8_t *fib);
+static int fill_engine_fib(dir24_8_t *fib);
+static int update_engine_route(uint32_t dst_net, uint8_t prf,
+                                struct ether_addr *mac, uint8_t intf);
+static dir24_8_t *replicate_fib_on(const dir24_8_t *src, int socket);
+static int install_fib(dir24_8_t *primary, int primary_socket);
+static int write_section(FILE *file, const void *data, size_t size,
+                            uint32_t *crc);
+static int read_section(FILE *file, void *data, size_t size, uint32_t *crc);
+static int check_snapshot_fib(const dir24_8_t *fib);
+static int adopt_snapshot_routes(const fib_snapshot_route_t *routes,
+                                    uint32_t n, uint32_t no_nxt_hops);
+static void publish_fibs(dir24_8_t **new_fibs);
+static void lookup_x4(const dir24_8_t *fib, const uint32_t *ips,
+                        uint32_t *hop_ids);
+static void lookup_x8(const dir24_8_t *fib, const uint32_t *ips,
+                        uint32_t *hop_ids);
 
 /**********************************
  *      Function definitions      *
  **********************************/
 /**
- * /brief Add a new route to the temporary list of routes.
- * 
- * This function adds a new route to the temporary list of routes.
- * Sorting is handled by this function to simplify the construction of the
- * Dir-24-8 routing tables.
+ * /brief Add a new route to the list of routes.
  * 
- * The entries are sorted from shortest to longest prefixes.
+ * This function adds a new route to the list of routes in O(1).
+ * The routes are sorted when we build the Dir-24-8 routing tables.
+ * If there is already a route for this network and prefix, we replace its
+ * next hop.
  * 
- * !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
- * As we have to fulfill the interface given in the 'routing_table.h' file
- * we cannot return any error value. Therefore, we simply do not add the route
- * if any error occurs.
- * !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+ * The change gets visible to the lookups with the next
+ * build_routing_table() or update_routing_table() call.
  * 
  * /param dst_net The IP address of the destination in little endian format.
  * /param prf The CIDR prefix of the destination.
  * /param intf The interface where we can reach the next hop.
  * /param mac The MAC of the next hop.
  * 
- * /return void
+ * /return 0 on success. The route is not added on any error.
+ *          Errors: ERR_FORMAT: Invalid prefix.
+ *                  ERR_MEM: Not enough memory.
  */
-void add_route(uint32_t dst_net, uint8_t prf,
+int add_route(uint32_t dst_net, uint8_t prf,
                     struct ether_addr* mac, uint8_t intf) {
-        tmp_route_t **iterator = &tmp_route_list;
+        if(prf > 32)
+            return ERR_FORMAT;
+        if(store_route(dst_net, prf, mac, intf) == NULL)
+            return ERR_MEM;
+        return 0;
+}
+
+/**
+ * /brief Insert a route into the list of routes.
+ * 
+ * See add_route(). The prefix must not be longer than 32 bits.
+ * 
+ * /return The entry of the route or NULL if we are out of memory.
+ */
+static tmp_route_t *store_route(uint32_t dst_net, uint8_t prf,
+                                struct ether_addr *mac, uint8_t intf) {
         tmp_route_t *new_line = NULL;
+        route_key_t key;
+        int ret = 0;
 
         // Strip away a possible host part from the dst network.
-        uint32_t netmask_cpu_bo = 0;
-        // The expression below cannot handle prefixes of 0 nicely
-        // (without casting to 64 bits and then back to 32)
-        if(prf != 0) {
-            netmask_cpu_bo = ~((1 << (32 - prf)) - 1);
-        }
+        uint32_t netmask_cpu_bo = prf_to_netmask(prf);
         dst_net &= netmask_cpu_bo;
 
-        while(*iterator != NULL && (*iterator)->netmask_cpu_bo < netmask_cpu_bo)
-            iterator = &(*iterator)->nxt;
+        // Replace the next hop of an existing route for this network
+        if((new_line = find_route(dst_net, prf)) != NULL) {
+            new_line->intf = intf;
+            ether_addr_copy(mac, &new_line->dst_mac);
+            return new_line;
+        }
 
-        if((new_line = malloc(sizeof(tmp_route_t))) == NULL)
-        {
+        if(
+            (route_hash == NULL && grow_route_hash() < 0)
+            || (new_line = malloc(sizeof(tmp_route_t))) == NULL
+        ) {
             printf("Cannot add the route as the system does not have"
                     "enough memory!\n");
-            return; // Can no longer return our error value
+            return NULL;
         }
 
-        // iterator is either NULL or there is a valid next entry
-        // => The next pointer is always in a clean state
-        new_line->nxt = *iterator;
         new_line->dst_net_cpu_bo = dst_net;
         new_line->netmask_cpu_bo = netmask_cpu_bo;
         new_line->prf = prf;
         new_line->intf = intf;
+        new_line->hop_id = 0;
         memcpy(&new_line->dst_mac, mac, sizeof(struct ether_addr));
 
-        #ifdef VERBOSE
-        printf("Added route for destination network %d.%d.%d.%d"
+        get_route_key(&key, dst_net, prf);
+        while(
+            (ret = rte_hash_add_key_data(route_hash, &key, new_line))
+            == -ENOSPC
+        ) {
+            if(grow_route_hash() < 0)
+                break;
+        }
+        if(ret < 0) {
+            printf("Cannot add the route as the system does not have"
+                    "enough memory!\n");
+            free(new_line);
+            return NULL;
+        }
+        ++no_routes;
+
+        LOG_DEBUG("Added route for destination network %d.%d.%d.%d"
                     " with netmask %d.%d.%d.%d to temporary routing table.\n",
                     // dst_net is little endian
                     (uint8_t)(dst_net >> 24),
@@ -96,56 +218,166 @@ void add_route(uint32_t dst_net, uint8_t prf,
                     (uint8_t)(netmask_cpu_bo >> 8),
                     (uint8_t)(netmask_cpu_bo)
         );
-        #endif
 
-        *iterator = new_line;
+        return new_line;
+}
+
+/**
+ * /brief Delete a route from the list of routes.
+ * 
+ * The change gets visible to the lookups with the next
+ * update_routing_table() call.
+ * 
+ * /param dst_net The IP address of the destination in little endian format.
+ * /param prf The CIDR prefix of the destination.
+ * 
+ * /return 0 on success.
+ *          Errors: ERR_NO_ROUTE: There is no route for this network.
+ */
+int del_route(uint32_t dst_net, uint8_t prf)
+{
+    tmp_route_t *route = find_route(dst_net, prf);
+    route_key_t key;
+
+    if(route == NULL)
+        return ERR_NO_ROUTE;
+
+    get_route_key(&key, route->dst_net_cpu_bo, prf);
+    rte_hash_del_key(route_hash, &key);
+    free(route);
+    --no_routes;
+    return 0;
 }
 
 /**
- * \brief Clear all temporary routing table entries.
+ * \brief Clear all routing table entries.
  * 
- * The function is used to clear all temporary routing table entries.
+ * The function is used to clear the list of routes the routing table is
+ * built from.
  */
 void clean_tmp_routing_table(void)
 {
-    tmp_route_t *it = tmp_route_list, *nxt;
+    const void *key = NULL;
+    void *route = NULL;
+    uint32_t it = 0;
 
-    while(it != NULL) {
-        nxt = it->nxt;
-        free(it);
-        it = nxt;
-    }
+    if(route_hash == NULL)
+        return;
+
+    while(rte_hash_iterate(route_hash, &key, &route, &it) >= 0)
+        free(route);
+    rte_hash_free(route_hash);
+
+    route_hash = NULL;
+    route_hash_size = 0;
+    no_routes = 0;
+}
+
+/**
+ * \brief Get the number of routes in the list of routes.
+ */
+uint get_no_routes(void)
+{
+    return no_routes;
+}
 
-    tmp_route_list = NULL;
+/**
+ * \brief Get the networks of the routes in the list of routes.
+ *
+ * \param nets The network addresses in little endian format.
+ * \param prfs The prefix lengths.
+ * \param max Size of both arrays.
+ *
+ * \return Number of networks written.
+ */
+uint get_route_nets(uint32_t *nets, uint8_t *prfs, uint max)
+{
+    const void *key = NULL;
+    void *data = NULL;
+    const tmp_route_t *route = NULL;
+    uint32_t it = 0;
+    uint n = 0;
+
+    while(
+        route_hash != NULL && n < max
+        && rte_hash_iterate(route_hash, &key, &data, &it) >= 0
+    ) {
+        route = (const tmp_route_t *)data;
+        nets[n] = route->dst_net_cpu_bo;
+        prfs[n++] = route->prf;
+    }
+    return n;
 }
 
 /**
  * \brief Clear the Dir-24-8 routing structure.
  * 
  * The function is used to cleanup the Dir-24-8 routing structure and the list
- * of next hops on a shutdown.
+ * of next hops on a shutdown. Lookups started afterwards find no routes.
  */
 void clean_routing_table(void)
 {
-    if(tbl24 != NULL)
-        free(tbl24);
+    dir24_8_t *no_fibs[RTE_MAX_NUMA_NODES] = { NULL };
+
+    publish_fibs(no_fibs);
+}
+
+/**
+ * \brief Set the memory placement of the Dir-24-8 structure.
+ * 
+ * Must be called before build_routing_table().
+ * The tables are allocated from DPDK (hugepage) memory on the given socket.
+ * If we shall replicate them, every other socket with enabled lcores gets
+ * its own copy. Thus, lookups never read the memory of a remote socket.
+ * 
+ * \param socket The socket of the primary tables. SOCKET_ID_ANY to use the
+ *              socket of the calling lcore.
+ * \param replicate Create a replica of the tables for every socket with
+ *              enabled lcores.
+ */
+void set_routing_table_placement(int socket, bool replicate)
+{
+    fib_socket = socket;
+    replicate_fib = replicate;
+}
+
+/**
+ * \brief Select the lookup engine of the routing table.
+ * 
+ * The engine is used by every structure built afterwards, i.e. by the next
+ * update_routing_table(). All engines except Dir-24-8 are rebuilt on every
+ * route update. See fib_engine_t.
+ * 
+ * \param name The name of the engine: dir24-8, dxr, poptrie or lpm.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_FORMAT: Unknown engine.
+ */
+int set_fib_engine(const char *name)
+{
+    uint i = 0;
 
-    if(tbllong != NULL)
-        free(tbllong);
+    if(name == NULL)
+        return ERR_FORMAT;
+    if(strcmp(name, "dir24-8") == 0) {
+        fib_engine = NULL;
+        return 0;
+    }
 
-    if(nxt_hops_map != NULL)
-        free(nxt_hops_map);
+    for(i = 0; i < RTE_DIM(engines); ++i) {
+        if(strcmp(name, engines[i]->name) == 0) {
+            fib_engine = engines[i];
+            return 0;
+        }
+    }
+    return ERR_FORMAT;
 }
 
 /**
  * /brief Build the Dir-24-8 routing table structure.
  * 
- * This function allocates memory for the TBL24 and TBLlong.
- * In addition, we build the hop_id->forwarding information map used by the
- * routing structure.
- * Afterwards, the routing structure is filled with the routing information
- * recieved as command line arguments. Therefore, we use the list of temporary
- * routing entries. This list is removed afterwards.
+ * This function builds the Dir-24-8 structure from the routes recieved as
+ * command line arguments. See update_routing_table().
  * 
  * !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
  * As we have to fulfill the interface given in the 'routing_table.h' file
@@ -155,217 +387,448 @@ void clean_routing_table(void)
  */
 void build_routing_table(void)
 {
-    tmp_route_t *route_it = tmp_route_list;
-    uint32_t index = 0, dst_net_cpu_bo = 0, netmask_cpu_bo = 0;
-    uint8_t tmp = 0;
-    tbl24_entry_t *tbl24_ent;
+    if(update_routing_table() < 0)
+        printf("Cannot build the routing table!\n");
+}
 
-    uint ret = 0;
+/**
+ * /brief Rebuild the Dir-24-8 structure and replace the one in use.
+ * 
+ * This function builds a new Dir-24-8 structure (and its replicas) from the
+ * list of routes while the lcores keep forwarding with the current one.
+ * Afterwards, the new tables are published with an atomic pointer swap.
+ * The old tables are freed as soon as every registered reader passed a
+ * quiescent state, i.e. no lcore can still use them.
+ * 
+ * Must only be called by a single thread at a time.
+ * 
+ * \return 0 on success. The tables in use are not modified on any error.
+ *          Errors: ERR_MEM: Not enough memory for the new tables.
+ *                  ERR_GEN: The routes cannot be stored in the Dir-24-8
+ *                           structure.
+ */
+int update_routing_table(void)
+{
+    dir24_8_t *primary = NULL;
+    int primary_socket = fib_socket == SOCKET_ID_ANY ?
+                            (int)rte_socket_id() : fib_socket;
+    uint no_groups = 0;
+    const void *key = NULL;
+    void *route = NULL;
+    uint32_t it = 0;
+    int ret = 0;
 
-    if(tbl24 != NULL) {
-        printf("TBL24 was built before. Abort rebuild!\n");
-        // There was more sense in this type of error handle as we could return
-        // an error message.. However, we also have to clean the state
-        goto ERR; 
+    if(fib_engine != NULL) {
+        if((primary = create_engine_fib(fib_engine, primary_socket)) == NULL) {
+            printf("Cannot allocate memory for the routing table!\n");
+            return ERR_MEM;
+        }
+        if((ret = fill_engine_fib(primary)) < 0) {
+            free_fib(primary);
+            return ret;
+        }
+        return install_fib(primary, primary_socket);
     }
 
-    // Allocate memory for TBL24
-    if((tbl24 = malloc(TBL24_SIZE)) == NULL) {
-        printf("Cannot allocate memory for TBL24!\n");
-        // There was more sense in this type of error handle as we could return
-        // an error message.. However, we also have to clean the state
-        goto ERR; 
+    // Every route longer than /24 requires at most one TBLlong group
+    // -> Do not grow TBLlong while we fill it
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &route, &it) >= 0
+    ) {
+        if(((tmp_route_t *)route)->prf > 24)
+            ++no_groups;
     }
+    no_groups = RTE_MIN(RTE_MAX(no_groups, (uint)TBLlong_INIT_ENTRIES),
+                        (uint)TBLlong_MAX_ENTRIES);
 
-    // Allocate memory for TBLlong
-    if((tbllong = malloc(TBLlong_SIZE)) == NULL) {
-        printf("Cannot allocate memory for TBLlong!\n");
-        // There was more sense in this type of error handle as we could return
-        // an error message.. However, we also have to clean the state
-        goto ERR; 
+    if((primary = create_fib(primary_socket, no_groups)) == NULL) {
+        printf("Cannot allocate memory for the Dir-24-8 tables!\n");
+        return ERR_MEM;
     }
 
-    // build next hops table
-    if((ret = alloc_hop_ids()) != 0) {
-        printf("Cannot build next hops table!\n");
-        // There was more sense in this type of error handle as we could return
-        // an error message.. However, we also have to clean the state
-        goto ERR; 
-    }
-
-    // Check if we have a default route -> Yes: We do not have to fill the 
-    // TBL24 with zeros
-    if(route_it != NULL && route_it->netmask_cpu_bo != 0) { // No default route
-        // We treat the entry [0|000000000000000] (TBL24 valid and
-        // next hop ID 0) as the 'no route to host' entry
-        memset(tbl24, 0, TBL24_SIZE);
-    }
-
-    for(; route_it != NULL; route_it = route_it->nxt) {
-        dst_net_cpu_bo = route_it->dst_net_cpu_bo;
-        netmask_cpu_bo = route_it->netmask_cpu_bo;
-
-        if(route_it->prf < 25) {
-            for(
-                index = dst_net_cpu_bo >> 8;
-                index <= 
-                    ((0xFFFFFFFF & ~netmask_cpu_bo) + dst_net_cpu_bo) >> 8;
-                ++index
-            ) {
-                // We can simply override the entry here as this entry is more
-                // specific than the ones before -> Sorting ;)
-                tbl24[index].indicator = 0;
-                tbl24[index].index = route_it->hop_id;
-            }
-        } else { // Prefix is longer than 24
-            if(no_tbllong_entries >= TBLlong_MAX_ENTRIES) { // Enough space?
-                printf("Not enough space in TBLlong!\n");
-                // There was more sense in this type of error handle as we
-                // could return an error message..
-                // However, we also have to clean the state
-                goto ERR; 
-            }
+    if((ret = fill_fib(primary)) < 0) {
+        free_fib(primary);
+        return ret;
+    }
 
-            // Get the corresponding TBL24 entry
-            tbl24_ent = tbl24 + (dst_net_cpu_bo >> 8);
-
-            // Check if we are the first one creating a TBLlong entry for this
-            // TBL24 entry. If the indicator is already 1, there is already
-            // an entry in the TBLlong correspoinding to this TBL24 entry.
-            if(tbl24_ent->indicator == 0)
-            {
-                // Either the entries in the TBL24 are valid 
-                // -> Take this entry and override the ones this new route is a
-                // more specific one
-                // If the entry is not valid, we set all new entries to invalid
-                // (hop_id == 0), too
-                memset(
-                    tbllong + (no_tbllong_entries * 256),
-                    tbl24_ent->index,
-                    256 * sizeof(tbllong_entry_t)
-                );
-                // Update the TBL24 entry to point to tbllong
-                tbl24_ent->indicator = 1;
-                tbl24_ent->index = no_tbllong_entries++;
-            }
+    return install_fib(primary, primary_socket);
+}
 
-            // Update the entries in TBLlong correspoing to this more
-            // specific route
-            tmp = (uint8_t)dst_net_cpu_bo;
-            for(
-                index = (tbl24_ent->index * 256) + tmp;
-                index <= (tbl24_ent->index * 256)
-                        + (0xFF & ~netmask_cpu_bo)
-                        + tmp;
-                ++index
-            ) {
-                // Override the entries we now know a more specific route
-                tbllong[index].index = route_it->hop_id;
-            }
+/**
+ * /brief Add a route and install it in the tables in use.
+ * 
+ * In contrast to add_route() and update_routing_table(), we only update the
+ * entries covered by the new route. Every entry is replaced with a single
+ * store -> The lcores keep forwarding while we update the tables.
+ * If there is already a route for this network and prefix, we replace its
+ * next hop.
+ * If the routing table is not built yet, the route is only added to the
+ * list of routes.
+ * The tables of other lookup engines are rebuilt with update_routing_table().
+ * 
+ * Must only be called by a single thread at a time. Do not mix it with
+ * add_route() after the routing table is built.
+ * 
+ * /param dst_net The IP address of the destination in little endian format.
+ * /param prf The CIDR prefix of the destination.
+ * /param mac The MAC of the next hop.
+ * /param intf The interface where we can reach the next hop.
+ * 
+ * /return 0 on success. The tables in use are not modified on any error.
+ *          Errors: ERR_FORMAT: Invalid prefix.
+ *                  ERR_MEM: Not enough memory.
+ *                  ERR_GEN: Too many next hops or TBLlong is full.
+ */
+int fib_add_route(uint32_t dst_net, uint8_t prf,
+                    struct ether_addr *mac, uint8_t intf)
+{
+    dir24_8_t *published[RTE_MAX_NUMA_NODES];
+    uint no_published = get_published_fibs(published), i = 0;
+    tmp_route_t *route = NULL;
+    int hop_id = 0, ret = 0;
+
+    if(prf > 32)
+        return ERR_FORMAT;
+    dst_net &= prf_to_netmask(prf);
+
+    if(fib_engine != NULL || (no_published > 0 && published[0]->engine))
+        return update_engine_route(dst_net, prf, mac, intf);
+
+    // Allocate everything we need before we touch the list or the tables
+    for(i = 0; i < no_published; ++i) {
+        if((hop_id = get_hop_id(published[i], intf, mac)) < 0)
+            return hop_id;
+        if(
+            prf > 24
+            && published[i]->tbl24[dst_net >> 8].indicator == 0
+            && (ret = reserve_tbllong_group(published[i])) < 0
+        ) {
+            printf("Not enough space in TBLlong!\n");
+            return ret;
         }
     }
 
-    // We do not need those entries now -> Delete them and free the used memory
-    clean_tmp_routing_table();
-    return; // Avoid the error case
+    if((route = store_route(dst_net, prf, mac, intf)) == NULL)
+        return ERR_MEM;
+
+    // All published structures assign the same IDs
+    route->hop_id = hop_id;
+    for(i = 0; i < no_published; ++i)
+        insert_route(published[i], dst_net, prf, route->hop_id);
 
-    ERR:
-    if(tbl24 != NULL) {
-        free(tbl24);
-        tbl24 = NULL;
-    }
+    return 0;
+}
+
+/**
+ * /brief Delete a route and remove it from the tables in use.
+ * 
+ * The entries covered by the route are restored to the longest route
+ * containing the deleted one. See fib_add_route().
+ * 
+ * /param dst_net The IP address of the destination in little endian format.
+ * /param prf The CIDR prefix of the destination.
+ * 
+ * /return 0 on success.
+ *          Errors: ERR_NO_ROUTE: There is no route for this network.
+ *                  ERR_MEM, ERR_GEN: The tables of another lookup engine
+ *                                    cannot be rebuilt.
+ */
+int fib_del_route(uint32_t dst_net, uint8_t prf)
+{
+    dir24_8_t *published[RTE_MAX_NUMA_NODES];
+    uint no_published = get_published_fibs(published), i = 0;
+    const tmp_route_t *cover = NULL;
+    uint32_t cover_hop_id = 0;
+    uint8_t cover_prf = 0;
+
+    if(prf > 32 || find_route(dst_net, prf) == NULL)
+        return ERR_NO_ROUTE;
+    dst_net &= prf_to_netmask(prf);
 
-    if(tbllong != NULL) {
-        free(tbllong);
-        tbllong = NULL;
+    if(fib_engine != NULL || (no_published > 0 && published[0]->engine))
+        return update_engine_route(dst_net, prf, NULL, 0);
+
+    if((cover = find_covering_route(dst_net, prf)) != NULL) {
+        cover_hop_id = cover->hop_id;
+        cover_prf = cover->prf;
     }
+
+    del_route(dst_net, prf);
+    for(i = 0; i < no_published; ++i)
+        remove_route(published[i], dst_net, prf, cover_hop_id, cover_prf);
+
+    return 0;
 }
 
+/**
+ * /brief Save the routing table in use to a snapshot file.
+ * 
+ * The snapshot contains the tables of the primary Dir-24-8 structure and the
+ * list of routes they were built from. See fib_snapshot_hdr_t.
+ * The file is replaced atomically.
+ * 
+ * /param path The path of the snapshot file.
+ * 
+ * /return 0 on success.
+ *          Errors: ERR_GEN: The routing table is not built, does not use
+ *                           the Dir-24-8 engine or we cannot write the file.
+ *                  ERR_MEM: Not enough memory.
+ */
+int save_routing_table(const char *path)
+{
+    const dir24_8_t *fib = primary_fib;
+    fib_snapshot_hdr_t hdr;
+    fib_snapshot_route_t *routes = NULL;
+    uint32_t *free_groups = NULL, it = 0, i = 0;
+    const void *key = NULL;
+    void *data = NULL;
+    const tmp_route_t *route = NULL;
+    char tmp_path[PATH_MAX];
+    FILE *file = NULL;
+    int ret = ERR_GEN;
+
+    if(fib == NULL) {
+        printf("Cannot save the routing table as it is not built!\n");
+        return ERR_GEN;
+    }
+    if(fib->engine != NULL) {
+        printf("Snapshots require the Dir-24-8 engine!\n");
+        return ERR_GEN;
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, FIB_SNAPSHOT_MAGIC, sizeof(hdr.magic));
+    hdr.version = FIB_SNAPSHOT_VERSION;
+    hdr.no_tbllong_entries = fib->no_tbllong_entries;
+    hdr.no_free_groups = fib->no_tbllong_free + fib->no_tbllong_retired;
+    hdr.no_nxt_hops = fib->no_nxt_hops;
+    hdr.no_routes = no_routes;
+
+    if(
+        (routes = malloc((no_routes + 1) * sizeof(fib_snapshot_route_t)))
+            == NULL
+        || (free_groups = malloc((hdr.no_free_groups + 1) * sizeof(uint32_t)))
+            == NULL
+    ) {
+        ret = ERR_MEM;
+        goto out;
+    }
+
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &data, &it) >= 0
+    ) {
+        route = data;
+        routes[i].dst_net_cpu_bo = route->dst_net_cpu_bo;
+        routes[i].hop_id = route->hop_id;
+        routes[i].prf = route->prf;
+        routes[i].intf = route->intf;
+        ether_addr_copy(&route->dst_mac, &routes[i].dst_mac);
+        ++i;
+    }
+    // Nobody reads the groups anymore when the snapshot is loaded
+    memcpy(free_groups, fib->tbllong_free,
+            fib->no_tbllong_free * sizeof(uint32_t));
+    memcpy(free_groups + fib->no_tbllong_free, fib->tbllong_retired,
+            fib->no_tbllong_retired * sizeof(uint32_t));
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if((file = fopen(tmp_path, "wb")) == NULL) {
+        printf("Cannot create the snapshot file %s!\n", tmp_path);
+        goto out;
+    }
+
+    // The header is written again as soon as we know the checksum
+    if(
+        fwrite(&hdr, sizeof(hdr), 1, file) != 1
+        || write_section(file, fib->tbl24, TBL24_SIZE, &hdr.crc) < 0
+        || write_section(file, fib->tbl24_depth, TBL24_NO_ENTRIES, &hdr.crc) < 0
+        || write_section(file, fib->tbllong,
+                        hdr.no_tbllong_entries * TBLlong_GROUP_SIZE,
+                        &hdr.crc) < 0
+        || write_section(file, fib->tbllong_depth,
+                        hdr.no_tbllong_entries * 256, &hdr.crc) < 0
+        || write_section(file, free_groups,
+                        hdr.no_free_groups * sizeof(uint32_t), &hdr.crc) < 0
+        || write_section(file, fib->nxt_hops_map,
+                        hdr.no_nxt_hops * sizeof(rt_entry_t), &hdr.crc) < 0
+        || write_section(file, routes,
+                        hdr.no_routes * sizeof(fib_snapshot_route_t),
+                        &hdr.crc) < 0
+        || fseek(file, 0, SEEK_SET) != 0
+        || fwrite(&hdr, sizeof(hdr), 1, file) != 1
+    ) {
+        printf("Cannot write the snapshot file %s!\n", tmp_path);
+        fclose(file);
+        remove(tmp_path);
+        goto out;
+    }
+
+    if(fclose(file) != 0 || rename(tmp_path, path) != 0) {
+        printf("Cannot write the snapshot file %s!\n", path);
+        remove(tmp_path);
+        goto out;
+    }
+    ret = 0;
+
+out:
+    free(routes);
+    free(free_groups);
+    return ret;
+}
 
 /**
- * /brief Allocate the next hops specified in all routes to next hop IDs used
- *          in the DIR-24-8 structure.
+ * /brief Load a snapshot file and replace the routing table in use.
  * 
- * This function iterates over all route definitions and assigns every next hop
- * specified in the route a next hop ID. The mapping from next hop ID
- * to the outgoing interface and destination MAC (rt_entry_t) is stored in the 
- * nxt_hops_map array.
+ * The tables are read directly into the memory of the new Dir-24-8 structure
+ * (and replicated as configured). Thus, we do not have to build the routing
+ * table.
+ * If there are routes configured, they must be exactly the routes of the
+ * snapshot. Otherwise, the routes of the snapshot are added to the list of
+ * routes.
  * 
- * If two routes have the same egress interface and the same destination MAC
- * specified, we will assign them the sme next hop ID.
+ * /param path The path of the snapshot file.
  * 
- * \return 0 on success.
- *          Errors: ERR_MEM: Could not (re-)allocate memory for the
- *                              nxt_hops_map.
- *                  ERR_GEN: If there are more than 255 next hops.
+ * /return 0 on success. The routing table in use is not modified on any
+ *          error.
+ *          Errors: ERR_GEN: Cannot read the file or another lookup engine
+ *                           is selected.
+ *                  ERR_FORMAT: The file is no valid snapshot or corrupted.
+ *                  ERR_MISMATCH: The configured routes do not match the
+ *                                routes of the snapshot.
+ *                  ERR_MEM: Not enough memory.
  */
-static int alloc_hop_ids(void)
+int load_routing_table(const char *path)
 {
-    tmp_route_t *it = tmp_route_list, *prf_it = tmp_route_list;
-    rt_entry_t *tmp_ptr = NULL;
+    int primary_socket = fib_socket == SOCKET_ID_ANY ?
+                            (int)rte_socket_id() : fib_socket;
+    fib_snapshot_hdr_t hdr;
+    fib_snapshot_route_t *routes = NULL;
+    dir24_8_t *fib = NULL;
+    uint32_t crc = 0;
+    FILE *file = NULL;
+    int ret = ERR_FORMAT;
+
+    if(fib_engine != NULL) {
+        printf("Snapshots require the Dir-24-8 engine!\n");
+        return ERR_GEN;
+    }
 
-    no_nxt_hops = 1; // 0 is used as special 'no next hop' value
+    if((file = fopen(path, "rb")) == NULL) {
+        printf("Cannot open the snapshot file %s!\n", path);
+        return ERR_GEN;
+    }
+
+    if(
+        fread(&hdr, sizeof(hdr), 1, file) != 1
+        || memcmp(hdr.magic, FIB_SNAPSHOT_MAGIC, sizeof(hdr.magic)) != 0
+        || hdr.version != FIB_SNAPSHOT_VERSION
+        || hdr.no_tbllong_entries > TBLlong_MAX_ENTRIES
+        || hdr.no_free_groups > hdr.no_tbllong_entries
+        || hdr.no_nxt_hops == 0
+        || hdr.no_nxt_hops > MAX_NO_NXT_HOPS
+    ) {
+        printf("%s is no valid routing table snapshot!\n", path);
+        goto out;
+    }
 
-    // Allocate memory for the nxt_hops_map array
-    curr_size_nxt_hops_tab = INIT_NO_NXT_HOPS;
     if(
-            (nxt_hops_map = malloc(curr_size_nxt_hops_tab * sizeof(rt_entry_t))) 
+        (fib = create_fib(primary_socket,
+                            RTE_MAX(hdr.no_tbllong_entries,
+                                    (uint32_t)TBLlong_INIT_ENTRIES))) == NULL
+        || (fib->nxt_hops_map = alloc_fib_mem("nxt_hops_map",
+                                hdr.no_nxt_hops * sizeof(rt_entry_t),
+                                primary_socket)) == NULL
+        || (routes = malloc((hdr.no_routes + 1) * sizeof(fib_snapshot_route_t)))
             == NULL
-        ) {
-        printf("Not enough memory for the next hops table!\n");
-        return ERR_MEM;
+    ) {
+        printf("Cannot allocate memory for the Dir-24-8 tables!\n");
+        ret = ERR_MEM;
+        goto out;
     }
-    memset(nxt_hops_map, 0, INIT_NO_NXT_HOPS * sizeof(rt_entry_t));
+    fib->no_tbllong_entries = hdr.no_tbllong_entries;
+    fib->no_tbllong_free = hdr.no_free_groups;
+    fib->no_nxt_hops = fib->curr_size_nxt_hops_tab = hdr.no_nxt_hops;
 
-    for(; it != NULL; it = it->nxt) {
-        for(
-            prf_it = tmp_route_list;
-            prf_it != NULL && it != prf_it;
-            prf_it = prf_it->nxt
-        ) {
-            if(
-                it->intf == prf_it->intf
-                && is_same_ether_addr(&it->dst_mac, &prf_it->dst_mac)
-            ) {
-                it->hop_id = prf_it->hop_id;
-                break;
-            }
-        }
+    if(
+        read_section(file, fib->tbl24, TBL24_SIZE, &crc) < 0
+        || read_section(file, fib->tbl24_depth, TBL24_NO_ENTRIES, &crc) < 0
+        || read_section(file, fib->tbllong,
+                        hdr.no_tbllong_entries * TBLlong_GROUP_SIZE, &crc) < 0
+        || read_section(file, fib->tbllong_depth,
+                        hdr.no_tbllong_entries * 256, &crc) < 0
+        || read_section(file, fib->tbllong_free,
+                        hdr.no_free_groups * sizeof(uint32_t), &crc) < 0
+        || read_section(file, fib->nxt_hops_map,
+                        hdr.no_nxt_hops * sizeof(rt_entry_t), &crc) < 0
+        || read_section(file, routes,
+                        hdr.no_routes * sizeof(fib_snapshot_route_t),
+                        &crc) < 0
+    ) {
+        printf("The snapshot %s is truncated!\n", path);
+        goto out;
+    }
 
-        // No next hop matched the one of the current route
-        if(it == prf_it) {
-            if(no_nxt_hops >= curr_size_nxt_hops_tab) {
-                curr_size_nxt_hops_tab += INIT_NO_NXT_HOPS;
-                if(curr_size_nxt_hops_tab > 255) {
-                    printf("To many next hops (>255) cannot be handled by "
-                    "DIR-24-8-BASIC. Aborting...\n");
-                    return ERR_GEN;
-                }
-                if(
-                    (tmp_ptr = 
-                        realloc(
-                                    nxt_hops_map,
-                                    INIT_NO_NXT_HOPS * sizeof(rt_entry_t)
-                                )
-                    ) == NULL
-                ) {
-                    printf("Cannot increase the size of the next hops table!\n");
-                    free(nxt_hops_map);
-                    return ERR_MEM;
-                }
-            }
-            
-            nxt_hops_map[no_nxt_hops].dst_port = it->intf;
-            ether_addr_copy(&it->dst_mac, &nxt_hops_map[no_nxt_hops].dst_mac);
-            it->hop_id = no_nxt_hops++;
-
-            #ifdef VERBOSE
-            printf("Added next hop with ID: %d\n", it->hop_id);
-            #endif
-        }
+    if(crc != hdr.crc || check_snapshot_fib(fib) < 0) {
+        printf("The snapshot %s is corrupted!\n", path);
+        goto out;
     }
 
-    return 0;
+    if((fib->adjs = alloc_adjs(fib, hdr.no_nxt_hops)) == NULL) {
+        printf("Cannot allocate memory for the adjacency table!\n");
+        ret = ERR_MEM;
+        goto out;
+    }
+
+    if((ret = adopt_snapshot_routes(routes, hdr.no_routes,
+                                    hdr.no_nxt_hops)) < 0) {
+        if(ret == ERR_MISMATCH)
+            printf("The snapshot %s does not match the configured routes!\n",
+                    path);
+        goto out;
+    }
+
+    if(rebuild_hop_hash(fib, RTE_MAX(2 * fib->no_nxt_hops,
+                                        (uint)INIT_NO_NXT_HOPS)) < 0) {
+        ret = ERR_MEM;
+        goto out;
+    }
+
+    ret = install_fib(fib, primary_socket);
+    fib = NULL; // Freed by install_fib() on any error
+
+out:
+    free_fib(fib);
+    free(routes);
+    fclose(file);
+    return ret;
+}
+
+/**
+ * \brief Register the calling lcore as reader of the routing table.
+ * 
+ * update_routing_table() waits until every registered reader reported a
+ * quiescent state using fib_quiescent() before it frees replaced tables.
+ * A registered lcore must report quiescent states regularly.
+ */
+void register_fib_reader(void)
+{
+    fib_reader_t *reader = &fib_readers[rte_lcore_id()];
+
+    reader->online = true;
+    rte_smp_mb(); // Be online before we read the first table pointer
+}
+
+/**
+ * \brief Unregister the calling lcore as reader of the routing table.
+ * 
+ * The lcore must not use any table pointer afterwards.
+ */
+void unregister_fib_reader(void)
+{
+    rte_smp_mb(); // Finish all reads of the tables before we go offline
+    fib_readers[rte_lcore_id()].online = false;
 }
 
 /**
@@ -375,6 +838,9 @@ static int alloc_hop_ids(void)
  * (little endian) and returns the matching rt_entry_t which contains the 
  * egress port and MAC address of the next hop.
  * 
+ * The returned entry belongs to the tables in use. A registered reader must
+ * not use it after reporting a quiescent state.
+ * 
  * \param dst_ip_cpu_bo The destination IP in CPU byte order (little endian)
  * 
  * \return The rt_entry_t* of the next hop or NULL if there is no routing table
@@ -383,108 +849,221 @@ static int alloc_hop_ids(void)
  */
 rt_entry_t *get_next_hop(uint32_t dst_ip_cpu_bo)
 {
+    const dir24_8_t *fib = get_local_fib();
     tbl24_entry_t *tbl24_entry=NULL;
     tbllong_entry_t *tbllong_entry=NULL;
     uint index = 0;
 
-    if(tbl24 == NULL && tbllong == NULL) {
+    if(fib == NULL) {
         printf("Cannot get any routing decision as the Dir-24-8 structure"
         "is not build. Call build_routing_table() before!");
         return NULL;
     }
 
-    tbl24_entry = &tbl24[dst_ip_cpu_bo >> 8];
+    if(fib->engine != NULL)
+        return get_hop_info(fib, get_next_hop_id(fib, dst_ip_cpu_bo));
+
+    tbl24_entry = &fib->tbl24[dst_ip_cpu_bo >> 8];
     if(tbl24_entry->indicator == 0) { // TBL24 valid
         // This entry is NULL if the index is '0' -> No route to host
         index = tbl24_entry->index;
 
-        #ifdef VERBOSE
         if(index != 0)
-                    printf(
-                        "Found routing table entry in TBL24. Index: %d\n",
-                        tbl24_entry->index
-                    );
-        #endif
+            LOG_DEBUG("Found routing table entry in TBL24. Index: %d\n",
+                        tbl24_entry->index);
     } else { // Lookup in TBLlong
-        tbllong_entry = tbllong +
+        tbllong_entry = fib->tbllong +
                         (tbl24_entry->index * 256) +
                         ((uint8_t)dst_ip_cpu_bo);
         index = tbllong_entry->index;
 
-        #ifdef VERBOSE
         if(index != 0)
-            printf(
-                        "Found routing table entry in TBLlong. Index: %d\n",
-                        tbllong_entry->index
-                    );
-        #endif
+            LOG_DEBUG("Found routing table entry in TBLlong. Index: %d\n",
+                        tbllong_entry->index);
     }
 
-    if(index == 0)
-        return NULL;
-    return nxt_hops_map + index;
+    return get_hop_info(fib, index);
 }
 
 /**
- * \brief Print the mapping of egress port to next hop MAC.
+ * \brief Get the next hop IDs of a vector of IPv4 addresses.
  * 
- * This fucntion prints the next hop information known to the router to the
- * command line in the form "Port: <egress_port> <--> Next hop MAC: <MAC>".
+ * Same as lookup_bulk() using the tables of the socket of the calling lcore.
+ * 
+ * \param ips The destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the n next hop IDs.
+ * \param n Number of addresses in ips.
  */
-void print_port_id_to_mac()
+void get_next_hop_bulk(const uint32_t *ips, uint32_t *hop_ids, uint32_t n)
 {
-    uint it = 1; // leave out our 'invalid' entry
-    rt_entry_t *entry = NULL;
-
-    if(nxt_hops_map == NULL)
-    {
-        printf("Currently there are no hops in the next hops map. Maybe you"
-                "Have to invoke build_routing_table() before\n");
-                return;
-    }
-
-    for(
-            entry = &nxt_hops_map[it];
-            it < no_nxt_hops;
-            entry = &nxt_hops_map[++it]
-        ) {
-            print_routing_table_entry(entry);
-    }
+    lookup_bulk(get_local_fib(), ips, hop_ids, n);
 }
 
 /**
- * \brief Print the mapping of next hop ID to the next hop information.
+ * \brief Get the next hop IDs of a vector of IPv4 addresses.
  * 
- * The function prints all known next hop IDs and the corresponding next hop
- * information (egresss port and MAC) to the command line.
+ * This function performs the lookup of n IPv4 addresses in cpu endianness.
+ * Groups of eight addresses are resolved with AVX2 gathers if the build
+ * targets AVX2 (e.g. -march=native on such a CPU). The path is chosen at
+ * compile time. Remaining addresses are resolved one by one.
+ * Structures of another lookup engine are searched by the engine.
+ * The forwarding information of a next hop ID is returned by get_hop_info()
+ * for the same tables.
+ * 
+ * \param fib The tables used for the lookup. See get_local_fib().
+ * \param ips The destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the n next hop IDs. The ID is 0 if there is no
+ *              routing table entry for an address or the Dir-24-8 structure
+ *              is not initialized.
+ * \param n Number of addresses in ips.
  */
-void print_next_hop_tab()
+void lookup_bulk(const dir24_8_t *fib, const uint32_t *ips,
+                    uint32_t *hop_ids, uint32_t n)
 {
-    uint it = 1; // Leave out the 'invalid' entry
-    rt_entry_t *entry = NULL;
+    uint32_t i = 0;
 
-    printf(
-            "Next hop ID 0: Invalid entry. We use this entry to differentate "
-            "between valid and invalid TBL24 entries for the indicator 0.\n"
-            );
+    if(fib == NULL) {
+        memset(hop_ids, 0, n * sizeof(uint32_t));
+        return;
+    }
 
-    for(
-            entry = &nxt_hops_map[it];
-            it < no_nxt_hops;
-            entry = &nxt_hops_map[++it]
-        ) {
-            printf("Next hop ID %d:\n\t", it);
-            print_routing_table_entry(entry);
+    if(fib->engine != NULL) {
+        fib->engine->lookup_bulk(fib->engine_tbl, ips, hop_ids, n);
+        return;
     }
+
+    #ifdef __AVX2__
+    for(; i + 8 <= n; i += 8)
+        lookup_x8(fib, ips + i, hop_ids + i);
+    #endif
+
+    for(; i < n; ++i)
+        hop_ids[i] = get_next_hop_id(fib, ips[i]);
 }
 
 /**
- * \brief Print the information contained in one routing table entry.
+ * \brief Get the next hop IDs of four IPv4 addresses.
  * 
- * This function prints the information from one routing table entry in the
- * format: "Port: <egress_port> <--> Next hop MAC: <MAC>\n".
+ * Same as get_next_hop_bulk() for exactly four addresses.
+ * The Dir-24-8 structure must be built before.
  * 
- * ! The final newline is already added by this function.
+ * \param ips The four destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the four next hop IDs.
+ */
+void get_next_hop_x4(const uint32_t *ips, uint32_t *hop_ids)
+{
+    const dir24_8_t *fib = get_local_fib();
+
+    if(fib->engine != NULL)
+        fib->engine->lookup_bulk(fib->engine_tbl, ips, hop_ids, 4);
+    else
+        lookup_x4(fib, ips, hop_ids);
+}
+
+/**
+ * \brief Get the next hop IDs of eight IPv4 addresses.
+ * 
+ * Same as get_next_hop_bulk() for exactly eight addresses.
+ * The Dir-24-8 structure must be built before.
+ * 
+ * \param ips The eight destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the eight next hop IDs.
+ */
+void get_next_hop_x8(const uint32_t *ips, uint32_t *hop_ids)
+{
+    const dir24_8_t *fib = get_local_fib();
+
+    if(fib->engine != NULL)
+        fib->engine->lookup_bulk(fib->engine_tbl, ips, hop_ids, 8);
+    else
+        lookup_x8(fib, ips, hop_ids);
+}
+
+/**
+ * \brief Get the memory used by a Dir-24-8 structure.
+ * 
+ * Only the tables read by the lookups are taken into account.
+ * 
+ * \param fib The structure.
+ * 
+ * \return The size of TBL24, the used TBLlong groups, the next hops table
+ *          and the adjacency table in bytes. The size of the structure of
+ *          the engine instead of TBL24 and TBLlong for other lookup engines.
+ */
+size_t get_fib_memory(const dir24_8_t *fib)
+{
+    if(fib->engine != NULL)
+        return fib->engine->memory(fib->engine_tbl)
+                + fib->no_nxt_hops * (sizeof(rt_entry_t) + sizeof(adj_t));
+
+    return TBL24_SIZE
+            + (size_t)fib->no_tbllong_entries * TBLlong_GROUP_SIZE
+            + fib->no_nxt_hops * (sizeof(rt_entry_t) + sizeof(adj_t));
+}
+
+/**
+ * \brief Print the mapping of egress port to next hop MAC.
+ * 
+ * This fucntion prints the next hop information known to the router to the
+ * command line in the form "Port: <egress_port> <--> Next hop MAC: <MAC>".
+ */
+void print_port_id_to_mac()
+{
+    uint it = 1; // leave out our 'invalid' entry
+    rt_entry_t *entry = NULL;
+
+    if(primary_fib == NULL)
+    {
+        printf("Currently there are no hops in the next hops map. Maybe you"
+                "Have to invoke build_routing_table() before\n");
+                return;
+    }
+
+    for(
+            entry = &primary_fib->nxt_hops_map[it];
+            it < primary_fib->no_nxt_hops;
+            entry = &primary_fib->nxt_hops_map[++it]
+        ) {
+            print_routing_table_entry(entry);
+    }
+}
+
+/**
+ * \brief Print the mapping of next hop ID to the next hop information.
+ * 
+ * The function prints all known next hop IDs and the corresponding next hop
+ * information (egresss port and MAC) to the command line.
+ */
+void print_next_hop_tab()
+{
+    uint it = 1; // Leave out the 'invalid' entry
+    rt_entry_t *entry = NULL;
+
+    printf(
+            "Next hop ID 0: Invalid entry. We use this entry to differentate "
+            "between valid and invalid TBL24 entries for the indicator 0.\n"
+            );
+
+    if(primary_fib == NULL)
+        return;
+
+    for(
+            entry = &primary_fib->nxt_hops_map[it];
+            it < primary_fib->no_nxt_hops;
+            entry = &primary_fib->nxt_hops_map[++it]
+        ) {
+            printf("Next hop ID %d:\n\t", it);
+            print_routing_table_entry(entry);
+    }
+}
+
+/**
+ * \brief Print the information contained in one routing table entry.
+ * 
+ * This function prints the information from one routing table entry in the
+ * format: "Port: <egress_port> <--> Next hop MAC: <MAC>\n".
+ * 
+ * ! The final newline is already added by this function.
  */
 void print_routing_table_entry(rt_entry_t* info)
 {
@@ -501,4 +1080,1500 @@ void print_routing_table_entry(rt_entry_t* info)
         info->dst_mac.addr_bytes[4],
         info->dst_mac.addr_bytes[5]
     );
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Build the adjacency of a next hop.
+ * 
+ * The source MAC is the MAC of the egress interface. It stays zero if DPDK
+ * does not know the interface: Its frames are dropped anyway.
+ * 
+ * \param adj The adjacency.
+ * \param entry The next hop.
+ */
+void set_adj(adj_t *adj, const rt_entry_t *entry)
+{
+    memset(adj, 0, sizeof(adj_t));
+    ether_addr_copy(&entry->dst_mac, (struct ether_addr *)adj->l2);
+    if(rte_eth_dev_is_valid_port(entry->dst_port))
+        rte_eth_macaddr_get(entry->dst_port,
+                            (struct ether_addr *)&adj->l2[ETHER_ADDR_LEN]);
+    adj->intf = entry->dst_port;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Allocate zeroed memory for the Dir-24-8 structure.
+ * 
+ * The memory is allocated from the DPDK heap of the given socket. If this
+ * socket has not enough memory left, we use the memory of any other socket.
+ * 
+ * \param type A string identifying the type of the allocation.
+ * \param size Size of the allocation in bytes.
+ * \param socket The preferred socket. SOCKET_ID_ANY for the current one.
+ * 
+ * \return Pointer to the memory or NULL if there is not enough memory.
+ */
+void *alloc_fib_mem(const char *type, size_t size, int socket)
+{
+    void *mem = rte_zmalloc_socket(type, size, RTE_CACHE_LINE_SIZE, socket);
+
+    if(mem == NULL && socket != SOCKET_ID_ANY) {
+        printf("Not enough memory for %s on socket %d. Using any socket.\n",
+                type, socket);
+        mem = rte_zmalloc_socket(type, size, RTE_CACHE_LINE_SIZE,
+                                    SOCKET_ID_ANY);
+    }
+    return mem;
+}
+
+/**
+ * \brief Allocate an empty Dir-24-8 structure.
+ * 
+ * All TBL24 entries of the new structure are 'no route to host' entries.
+ * 
+ * \param socket The socket the tables shall be allocated on.
+ * \param tbllong_groups The number of TBLlong groups we allocate.
+ * 
+ * \return The new structure or NULL if there is not enough memory.
+ */
+static dir24_8_t *create_fib(int socket, uint tbllong_groups)
+{
+    dir24_8_t *fib = NULL;
+
+    if((fib = alloc_fib_mem("dir24_8", sizeof(dir24_8_t), socket)) == NULL)
+        return NULL;
+    fib->socket = socket;
+
+    // Allocate memory for TBL24
+    // We treat the entry [0|000...000] (TBL24 valid and
+    // next hop ID 0) as the 'no route to host' entry -> zeroed memory
+    if((fib->tbl24 = alloc_fib_mem("tbl24", TBL24_SIZE, socket)) == NULL) {
+        printf("Cannot allocate memory for TBL24!\n");
+        free_fib(fib);
+        return NULL;
+    }
+
+    // Allocate memory for TBLlong
+    fib->tbllong_capacity = tbllong_groups;
+    if((fib->tbllong = alloc_fib_mem("tbllong",
+                                    tbllong_groups * TBLlong_GROUP_SIZE,
+                                    socket)) == NULL) {
+        printf("Cannot allocate memory for TBLlong!\n");
+        free_fib(fib);
+        return NULL;
+    }
+
+    // Allocate the bookkeeping used by route updates
+    if(
+        (fib->tbl24_depth = alloc_fib_mem("tbl24_depth", TBL24_NO_ENTRIES,
+                                            socket)) == NULL
+        || (fib->tbllong_depth = alloc_fib_mem("tbllong_depth",
+                                            tbllong_groups * 256,
+                                            socket)) == NULL
+        || (fib->tbllong_free = alloc_fib_mem("tbllong_free",
+                                tbllong_groups * sizeof(uint32_t),
+                                socket)) == NULL
+        || (fib->tbllong_retired = alloc_fib_mem("tbllong_retired",
+                                tbllong_groups * sizeof(uint32_t),
+                                socket)) == NULL
+    ) {
+        printf("Cannot allocate memory for the route update state!\n");
+        free_fib(fib);
+        return NULL;
+    }
+
+    return fib;
+}
+
+/**
+ * \brief Allocate an empty structure of another lookup engine.
+ * 
+ * Only the structure itself is allocated. See fill_engine_fib().
+ * 
+ * \param engine The lookup engine.
+ * \param socket The socket the tables shall be allocated on.
+ * 
+ * \return The new structure or NULL if there is not enough memory.
+ */
+static dir24_8_t *create_engine_fib(const fib_engine_t *engine, int socket)
+{
+    dir24_8_t *fib = NULL;
+
+    if((fib = alloc_fib_mem("dir24_8", sizeof(dir24_8_t), socket)) == NULL)
+        return NULL;
+    fib->socket = socket;
+    fib->engine = engine;
+    return fib;
+}
+
+/**
+ * \brief Free a Dir-24-8 structure.
+ * 
+ * The structure must no longer be published.
+ * 
+ * \param fib The structure. May be NULL.
+ */
+static void free_fib(dir24_8_t *fib)
+{
+    if(fib == NULL)
+        return;
+
+    if(fib->engine != NULL && fib->engine_tbl != NULL)
+        fib->engine->free(fib->engine_tbl);
+    rte_free(fib->tbl24);
+    rte_free(fib->tbllong);
+    rte_free(fib->tbl24_depth);
+    rte_free(fib->tbllong_depth);
+    rte_free(fib->tbllong_free);
+    rte_free(fib->tbllong_retired);
+    rte_free(fib->nxt_hops_map);
+    rte_free(fib->adjs);
+    rte_hash_free(fib->nxt_hops_hash);
+    rte_free(fib);
+}
+
+/**
+ * /brief Fill an empty Dir-24-8 structure with the list of routes.
+ * 
+ * We build the hop_id->forwarding information map used by the
+ * routing structure.
+ * Afterwards, the routing structure is filled with the routing information
+ * of the list of routes. The routes from /8 to /24 are installed in
+ * parallel by all idle lcores if we are called by the master lcore.
+ * 
+ * \param fib An empty structure created by create_fib().
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory for the next hops table.
+ *                  ERR_GEN: Too many next hops or not enough space in
+ *                           TBLlong.
+ */
+static int fill_fib(dir24_8_t *fib)
+{
+    bool launched[RTE_MAX_LCORE] = { false };
+    fill_job_t job;
+    uint i = 0, lcore = 0;
+    int ret = 0;
+
+    // build next hops table
+    if((ret = alloc_hop_ids(fib)) != 0) {
+        printf("Cannot build next hops table!\n");
+        return ret;
+    }
+
+    if((job.routes = sort_routes(job.slices)) == NULL) {
+        printf("Not enough memory to sort the routes!\n");
+        return ERR_MEM;
+    }
+    job.fib = fib;
+    rte_atomic32_set(&job.nxt_slice, 0);
+
+    // Routes shorter than /8 span several slices
+    for(i = 0; i < job.slices[0]; ++i)
+        insert_route(fib, job.routes[i]->dst_net_cpu_bo, job.routes[i]->prf,
+                        job.routes[i]->hop_id);
+
+    if(rte_lcore_id() == rte_get_master_lcore()) {
+        RTE_LCORE_FOREACH_SLAVE(lcore) {
+            launched[lcore] =
+                rte_eal_get_lcore_state(lcore) == WAIT
+                && rte_eal_remote_launch(fill_fib_slices, &job, lcore) == 0;
+        }
+    }
+    fill_fib_slices(&job);
+    RTE_LCORE_FOREACH_SLAVE(lcore)
+        if(launched[lcore])
+            rte_eal_wait_lcore(lcore);
+
+    // Routes longer than /24 share the TBLlong groups
+    for(i = job.slices[NO_FILL_SLICES]; i < no_routes; ++i) {
+        if((ret = insert_route(fib, job.routes[i]->dst_net_cpu_bo,
+                                job.routes[i]->prf,
+                                job.routes[i]->hop_id)) < 0) {
+            printf("Not enough space in TBLlong!\n");
+            break;
+        }
+    }
+
+    free(job.routes);
+    return ret;
+}
+
+/**
+ * \brief Install the routes of the fill slices of a job.
+ * 
+ * Every lcore takes the next unfilled slice until all are filled.
+ * 
+ * \param arg The fill_job_t.
+ * 
+ * \return 0
+ */
+static int fill_fib_slices(void *arg)
+{
+    fill_job_t *job = arg;
+    const tmp_route_t *route = NULL;
+    int32_t slice = 0;
+    uint i = 0;
+
+    while(
+        (slice = rte_atomic32_add_return(&job->nxt_slice, 1) - 1)
+        < NO_FILL_SLICES
+    ) {
+        for(i = job->slices[slice]; i < job->slices[slice + 1]; ++i) {
+            route = job->routes[i];
+            // Routes up to /24 do not require TBLlong groups -> Cannot fail
+            insert_route(job->fib, route->dst_net_cpu_bo, route->prf,
+                            route->hop_id);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Build the tables of another lookup engine from the list of routes.
+ * 
+ * See fill_fib().
+ * 
+ * \param fib An empty structure created by create_engine_fib().
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_GEN: The engine cannot store the routes.
+ */
+static int fill_engine_fib(dir24_8_t *fib)
+{
+    uint slices[NO_FILL_SLICES + 1];
+    tmp_route_t **routes = NULL;
+    int ret = 0;
+
+    if((ret = alloc_hop_ids(fib)) != 0) {
+        printf("Cannot build next hops table!\n");
+        return ret;
+    }
+
+    // The engines do not care about the order
+    if((routes = sort_routes(slices)) == NULL) {
+        printf("Not enough memory to sort the routes!\n");
+        return ERR_MEM;
+    }
+
+    if((ret = fib->engine->build(fib, routes, no_routes)) < 0)
+        printf("Cannot build the %s structure!\n", fib->engine->name);
+
+    free(routes);
+    return ret;
+}
+
+/**
+ * \brief Add or delete a route and rebuild the tables of another lookup
+ *          engine.
+ * 
+ * The engines cannot be updated in place. Thus, we update the list of routes
+ * and rebuild the tables with update_routing_table() if they are built.
+ * On any error, the list of routes is restored.
+ * 
+ * \param dst_net The IP address of the destination in little endian format.
+ * \param prf The CIDR prefix of the destination.
+ * \param mac The MAC of the next hop. NULL to delete the route.
+ * \param intf The interface where we can reach the next hop.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_GEN: The engine cannot store the routes.
+ */
+static int update_engine_route(uint32_t dst_net, uint8_t prf,
+                                struct ether_addr *mac, uint8_t intf)
+{
+    dir24_8_t *published[RTE_MAX_NUMA_NODES];
+    tmp_route_t *route = find_route(dst_net, prf), old;
+    int ret = 0;
+
+    if(route != NULL)
+        old = *route;
+
+    if(mac == NULL)
+        del_route(dst_net, prf);
+    else if(store_route(dst_net, prf, mac, intf) == NULL)
+        return ERR_MEM;
+
+    if(
+        get_published_fibs(published) == 0
+        || (ret = update_routing_table()) == 0
+    )
+        return 0;
+
+    if(route == NULL)
+        del_route(dst_net, prf);
+    else
+        store_route(dst_net, prf, &old.dst_mac, old.intf);
+    return ret;
+}
+
+/**
+ * \brief Get all routes in the order we install them.
+ * 
+ * We sort the routes with a single counting sort pass:
+ *  1. Routes shorter than /8.
+ *  2. Routes from /8 to /24 grouped by their /8 network (fill slice).
+ *  3. Routes longer than /24.
+ * Every group is sorted from the shortest to the longest prefix.
+ * 
+ * \param slices Buffer for the index of the first route of every fill slice
+ *              and of the first route longer than /24.
+ * 
+ * \return Array of all routes. Must be freed by the caller.
+ *          NULL if there is not enough memory.
+ */
+static tmp_route_t **sort_routes(uint *slices)
+{
+    tmp_route_t **routes = NULL;
+    uint *starts = NULL, key_it = 0, sum = 0, tmp = 0;
+    const void *key = NULL;
+    void *route = NULL;
+    uint32_t it = 0;
+
+    if(
+        (routes = malloc((no_routes + 1) * sizeof(tmp_route_t *))) == NULL
+        || (starts = calloc(NO_SORT_KEYS, sizeof(uint))) == NULL
+    ) {
+        free(routes);
+        return NULL;
+    }
+
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &route, &it) >= 0
+    )
+        ++starts[get_sort_key(route)];
+
+    for(key_it = 0; key_it < NO_SORT_KEYS; ++key_it) {
+        tmp = starts[key_it];
+        starts[key_it] = sum;
+        sum += tmp;
+    }
+    for(key_it = 0; key_it <= NO_FILL_SLICES; ++key_it)
+        slices[key_it] = starts[FILL_MIN_PRF + key_it * FILL_SLICE_PRFS];
+
+    it = 0;
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &route, &it) >= 0
+    )
+        routes[starts[get_sort_key(route)]++] = route;
+
+    free(starts);
+    return routes;
+}
+
+/**
+ * \brief Get the position of a route in the order of sort_routes().
+ */
+static uint get_sort_key(const tmp_route_t *route)
+{
+    if(route->prf < FILL_MIN_PRF)
+        return route->prf;
+    if(route->prf <= 24)
+        return FILL_MIN_PRF
+                + (route->dst_net_cpu_bo >> 24) * FILL_SLICE_PRFS
+                + route->prf - FILL_MIN_PRF;
+    return FILL_MIN_PRF + NO_FILL_SLICES * FILL_SLICE_PRFS + route->prf - 25;
+}
+
+/**
+ * /brief Allocate the next hops specified in all routes to next hop IDs used
+ *          in the DIR-24-8 structure.
+ * 
+ * This function iterates over all route definitions and assigns every next hop
+ * specified in the route a next hop ID. The mapping from next hop ID
+ * to the outgoing interface and destination MAC (rt_entry_t) is stored in the 
+ * nxt_hops_map array of the structure.
+ * 
+ * If two routes have the same egress interface and the same destination MAC
+ * specified, we will assign them the sme next hop ID. See get_hop_id().
+ * 
+ * \param fib The structure the next hops table belongs to.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Could not (re-)allocate memory for the
+ *                              nxt_hops_map.
+ *                  ERR_GEN: If there are more than MAX_NO_NXT_HOPS next hops.
+ */
+static int alloc_hop_ids(dir24_8_t *fib)
+{
+    const void *key = NULL;
+    void *data = NULL;
+    tmp_route_t *route = NULL;
+    uint32_t it = 0;
+    int hop_id = 0;
+
+    fib->no_nxt_hops = 1; // 0 is used as special 'no next hop' value
+
+    // Allocate memory for the nxt_hops_map array
+    fib->curr_size_nxt_hops_tab = INIT_NO_NXT_HOPS;
+    if(
+            (fib->nxt_hops_map = alloc_fib_mem(
+                            "nxt_hops_map",
+                            fib->curr_size_nxt_hops_tab * sizeof(rt_entry_t),
+                            fib->socket
+                            )) 
+            == NULL
+            || (fib->adjs = alloc_adjs(fib, fib->curr_size_nxt_hops_tab))
+                == NULL
+        ) {
+        printf("Not enough memory for the next hops table!\n");
+        return ERR_MEM;
+    }
+
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &data, &it) >= 0
+    ) {
+        route = data;
+        if((hop_id = get_hop_id(fib, route->intf, &route->dst_mac)) < 0)
+            return hop_id;
+        route->hop_id = hop_id;
+    }
+
+    return 0;
+}
+
+/**
+ * /brief Get the next hop ID of an egress interface and next hop MAC.
+ * 
+ * The known next hops are found with a hash table lookup.
+ * If the structure does not know this next hop yet, we assign it a new ID.
+ * A new next hop gets its adjacency as well. A grown next hops table and
+ * adjacency table replace the old ones with a single store each. If the
+ * structure is in use, we free the old tables after every reader passed
+ * a quiescent state.
+ * 
+ * \param fib The structure the next hops table belongs to.
+ * \param intf The egress interface of the next hop.
+ * \param mac The MAC of the next hop.
+ * 
+ * \return The next hop ID.
+ *          Errors: ERR_MEM: Could not grow the nxt_hops_map.
+ *                  ERR_GEN: If there are more than MAX_NO_NXT_HOPS next hops.
+ */
+static int get_hop_id(dir24_8_t *fib, uint8_t intf,
+                        const struct ether_addr *mac)
+{
+    rt_entry_t *tmp_ptr = NULL, *old = NULL;
+    adj_t *adjs = NULL, *old_adjs = NULL;
+    uint32_t hop_id = 0, new_size = 0;
+    nxt_hop_key_t key;
+    void *data = NULL;
+
+    get_nxt_hop_key(&key, intf, mac);
+    if(
+        fib->nxt_hops_hash != NULL
+        && rte_hash_lookup_data(fib->nxt_hops_hash, &key, &data) >= 0
+    )
+        return (uintptr_t)data;
+
+    // No next hop matched -> Use a new ID
+    if(fib->no_nxt_hops >= fib->curr_size_nxt_hops_tab) {
+        if(fib->no_nxt_hops >= MAX_NO_NXT_HOPS) {
+            printf("To many next hops cannot be handled by "
+            "DIR-24-8-BASIC. Aborting...\n");
+            return ERR_GEN;
+        }
+        // Double the size -> Every next hop is copied O(1) times on average
+        new_size = RTE_MIN(
+                        RTE_MAX(fib->curr_size_nxt_hops_tab * 2,
+                                (uint32_t)INIT_NO_NXT_HOPS),
+                        MAX_NO_NXT_HOPS
+                    );
+        if(
+            (tmp_ptr = alloc_fib_mem(
+                        "nxt_hops_map",
+                        new_size * sizeof(rt_entry_t),
+                        fib->socket
+                    )
+            ) == NULL
+        ) {
+            printf("Cannot increase the size of the next hops table!\n");
+            return ERR_MEM;
+        }
+        if((adjs = alloc_adjs(fib, new_size)) == NULL) {
+            printf("Cannot increase the size of the adjacency table!\n");
+            rte_free(tmp_ptr);
+            return ERR_MEM;
+        }
+        memcpy(tmp_ptr, fib->nxt_hops_map,
+                fib->no_nxt_hops * sizeof(rt_entry_t));
+
+        old = fib->nxt_hops_map;
+        old_adjs = fib->adjs;
+        rte_smp_wmb(); // The copy must be complete before lookups can see it
+        fib->nxt_hops_map = tmp_ptr;
+        fib->adjs = adjs;
+        fib->curr_size_nxt_hops_tab = new_size;
+        if(is_published(fib))
+            wait_for_fib_readers();
+        rte_free(old);
+        rte_free(old_adjs);
+    }
+
+    hop_id = fib->no_nxt_hops++;
+    fib->nxt_hops_map[hop_id].dst_port = intf;
+    ether_addr_copy(mac, &fib->nxt_hops_map[hop_id].dst_mac);
+    set_adj(&fib->adjs[hop_id], &fib->nxt_hops_map[hop_id]);
+
+    // A full hash table is replaced by a larger one containing all next hops
+    if(
+        fib->nxt_hops_hash == NULL
+        || rte_hash_add_key_data(fib->nxt_hops_hash, &key,
+                                    (void *)(uintptr_t)hop_id) < 0
+    ) {
+        if(rebuild_hop_hash(fib, 2 * fib->curr_size_nxt_hops_tab) < 0) {
+            printf("Cannot increase the size of the next hops hash table!\n");
+            --fib->no_nxt_hops;
+            return ERR_MEM;
+        }
+    }
+
+    LOG_DEBUG("Added next hop with ID: %d\n", hop_id);
+
+    return hop_id;
+}
+
+/**
+ * \brief Allocate the adjacency table of a structure.
+ * 
+ * The adjacencies of all next hops of the next hops table are built.
+ * 
+ * \param fib The structure.
+ * \param size The number of adjacencies the table can hold.
+ * 
+ * \return The table or NULL if there is not enough memory.
+ */
+static adj_t *alloc_adjs(const dir24_8_t *fib, uint32_t size)
+{
+    adj_t *adjs = NULL;
+
+    if((adjs = alloc_fib_mem("adjs", size * sizeof(adj_t), fib->socket))
+        == NULL)
+        return NULL;
+
+    for(uint32_t hop_id = 1; hop_id < fib->no_nxt_hops; ++hop_id)
+        set_adj(&adjs[hop_id], &fib->nxt_hops_map[hop_id]);
+    return adjs;
+}
+
+/**
+ * \brief Replace the next hops hash table of a structure.
+ * 
+ * The new hash table contains all next hops of the next hops table.
+ * 
+ * \param fib The structure.
+ * \param entries The size of the new hash table.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int rebuild_hop_hash(dir24_8_t *fib, uint32_t entries)
+{
+    struct rte_hash *hash = NULL;
+    nxt_hop_key_t key;
+    uint32_t hop_id = 1;
+
+    if((hash = create_hash("nxt_hops", entries, sizeof(nxt_hop_key_t),
+                            fib->socket)) == NULL)
+        return ERR_MEM;
+
+    for(; hop_id < fib->no_nxt_hops; ++hop_id) {
+        get_nxt_hop_key(&key, fib->nxt_hops_map[hop_id].dst_port,
+                        &fib->nxt_hops_map[hop_id].dst_mac);
+        if(rte_hash_add_key_data(hash, &key, (void *)(uintptr_t)hop_id) < 0) {
+            rte_hash_free(hash);
+            return ERR_MEM;
+        }
+    }
+
+    rte_hash_free(fib->nxt_hops_hash);
+    fib->nxt_hops_hash = hash;
+    return 0;
+}
+
+/**
+ * \brief Get the hash key of a next hop.
+ */
+static void get_nxt_hop_key(nxt_hop_key_t *key, uint8_t intf,
+                            const struct ether_addr *mac)
+{
+    memset(key, 0, sizeof(nxt_hop_key_t));
+    ether_addr_copy(mac, &key->dst_mac);
+    key->intf = intf;
+}
+
+/**
+ * \brief Install a route in a Dir-24-8 structure.
+ * 
+ * Only the entries covered by the route are updated. Entries set by more
+ * specific routes are left untouched.
+ * Every entry is replaced with a single store. Thus, the structure may be
+ * in use by the lookups.
+ * 
+ * \param fib The structure.
+ * \param dst_net The network of the route in CPU byte order.
+ * \param prf The CIDR prefix of the route.
+ * \param hop_id The next hop ID of the route in this structure.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_GEN: Not enough space in TBLlong.
+ */
+static int insert_route(dir24_8_t *fib, uint32_t dst_net, uint8_t prf,
+                        uint32_t hop_id)
+{
+    const uint32_t host_mask = ~prf_to_netmask(prf);
+    tbl24_entry_t entry = { .indicator = 0, .index = hop_id };
+    uint32_t index = 0, last = 0, group = 0, i = 0;
+    int ret = 0;
+
+    // The next hop must be visible before any entry refers to it
+    rte_smp_wmb();
+
+    if(prf <= 24) {
+        last = (dst_net | host_mask) >> 8;
+        for(index = dst_net >> 8; index <= last; ++index) {
+            if(fib->tbl24[index].indicator == 0) {
+                if(fib->tbl24_depth[index] <= prf) {
+                    fib->tbl24[index] = entry;
+                    fib->tbl24_depth[index] = prf;
+                }
+                continue;
+            }
+
+            // Only the entries not set by a route longer than /24 are ours
+            group = fib->tbl24[index].index * 256;
+            for(i = group; i < group + 256; ++i) {
+                if(fib->tbllong_depth[i] <= prf) {
+                    fib->tbllong[i].index = hop_id;
+                    fib->tbllong_depth[i] = prf;
+                }
+            }
+        }
+        return 0;
+    }
+
+    // Prefix is longer than 24
+    index = dst_net >> 8;
+    if(fib->tbl24[index].indicator == 0) {
+        if((ret = alloc_tbllong_group(fib)) < 0)
+            return ret;
+
+        // Start with the route of the TBL24 entry (or no route at all) and
+        // override the entries this new route is a more specific one
+        group = (uint32_t)ret * 256;
+        for(i = group; i < group + 256; ++i)
+            fib->tbllong[i].index = fib->tbl24[index].index;
+        memset(fib->tbllong_depth + group, fib->tbl24_depth[index], 256);
+
+        // The group must be complete before the TBL24 entry points to it
+        rte_smp_wmb();
+        entry.indicator = 1;
+        entry.index = ret;
+        fib->tbl24[index] = entry;
+    }
+
+    group = fib->tbl24[index].index * 256;
+    last = group + (uint8_t)(dst_net | host_mask);
+    for(i = group + (uint8_t)dst_net; i <= last; ++i) {
+        if(fib->tbllong_depth[i] <= prf) {
+            fib->tbllong[i].index = hop_id;
+            fib->tbllong_depth[i] = prf;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Remove a route from a Dir-24-8 structure.
+ * 
+ * The entries set by the route are restored to the longest route containing
+ * it. A TBLlong group without routes longer than /24 is released.
+ * See insert_route().
+ * 
+ * \param fib The structure.
+ * \param dst_net The network of the route in CPU byte order.
+ * \param prf The CIDR prefix of the route.
+ * \param cover_hop_id The next hop ID of the longest route containing the
+ *              deleted one. 0 if there is none.
+ * \param cover_prf The prefix of this route. 0 if there is none.
+ */
+static void remove_route(dir24_8_t *fib, uint32_t dst_net, uint8_t prf,
+                            uint32_t cover_hop_id, uint8_t cover_prf)
+{
+    const uint32_t host_mask = ~prf_to_netmask(prf);
+    tbl24_entry_t entry = { .indicator = 0, .index = cover_hop_id };
+    uint32_t index = 0, last = 0, group = 0, i = 0;
+
+    if(prf <= 24) {
+        last = (dst_net | host_mask) >> 8;
+        for(index = dst_net >> 8; index <= last; ++index) {
+            if(fib->tbl24[index].indicator == 0) {
+                if(fib->tbl24_depth[index] == prf) {
+                    fib->tbl24[index] = entry;
+                    fib->tbl24_depth[index] = cover_prf;
+                }
+                continue;
+            }
+
+            group = fib->tbl24[index].index * 256;
+            for(i = group; i < group + 256; ++i) {
+                if(fib->tbllong_depth[i] == prf) {
+                    fib->tbllong[i].index = cover_hop_id;
+                    fib->tbllong_depth[i] = cover_prf;
+                }
+            }
+        }
+        return;
+    }
+
+    // Prefix is longer than 24
+    index = dst_net >> 8;
+    if(fib->tbl24[index].indicator == 0) // Route was never installed
+        return;
+
+    group = fib->tbl24[index].index * 256;
+    last = group + (uint8_t)(dst_net | host_mask);
+    for(i = group + (uint8_t)dst_net; i <= last; ++i) {
+        if(fib->tbllong_depth[i] == prf) {
+            fib->tbllong[i].index = cover_hop_id;
+            fib->tbllong_depth[i] = cover_prf;
+        }
+    }
+
+    recycle_tbllong_group(fib, index);
+}
+
+/**
+ * \brief Make sure there is a TBLlong group left for a new route.
+ * 
+ * We grow TBLlong if required. Afterwards, the next alloc_tbllong_group()
+ * call cannot fail.
+ * 
+ * \param fib The structure.
+ * 
+ * \return 0 on success.
+ *          Errors: See grow_tbllong().
+ */
+static int reserve_tbllong_group(dir24_8_t *fib)
+{
+    if(
+        fib->no_tbllong_free > 0
+        || fib->no_tbllong_retired > 0
+        || fib->no_tbllong_entries < fib->tbllong_capacity
+    )
+        return 0;
+    return grow_tbllong(fib);
+}
+
+/**
+ * \brief Double the number of TBLlong groups.
+ * 
+ * The grown TBLlong replaces the old one with a single store. If the
+ * structure is in use, we free the old TBLlong after every reader passed a
+ * quiescent state. Thus, no lookup can read a new group from the old TBLlong.
+ * 
+ * \param fib The structure.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_GEN: TBLlong has its maximum size.
+ */
+static int grow_tbllong(dir24_8_t *fib)
+{
+    const uint capacity = RTE_MIN(fib->tbllong_capacity * 2,
+                                    (uint)TBLlong_MAX_ENTRIES);
+    tbllong_entry_t *tbllong = NULL, *old_tbllong = fib->tbllong;
+    uint8_t *depth = NULL;
+    uint32_t *free_groups = NULL, *retired = NULL;
+
+    if(capacity <= fib->tbllong_capacity)
+        return ERR_GEN;
+
+    if(
+        (tbllong = alloc_fib_mem("tbllong", capacity * TBLlong_GROUP_SIZE,
+                                    fib->socket)) == NULL
+        || (depth = alloc_fib_mem("tbllong_depth", capacity * 256,
+                                    fib->socket)) == NULL
+        || (free_groups = alloc_fib_mem("tbllong_free",
+                                    capacity * sizeof(uint32_t),
+                                    fib->socket)) == NULL
+        || (retired = alloc_fib_mem("tbllong_retired",
+                                    capacity * sizeof(uint32_t),
+                                    fib->socket)) == NULL
+    ) {
+        printf("Cannot increase the size of TBLlong!\n");
+        rte_free(tbllong);
+        rte_free(depth);
+        rte_free(free_groups);
+        return ERR_MEM;
+    }
+
+    memcpy(tbllong, fib->tbllong,
+            fib->no_tbllong_entries * TBLlong_GROUP_SIZE);
+    memcpy(depth, fib->tbllong_depth, fib->no_tbllong_entries * 256);
+    memcpy(free_groups, fib->tbllong_free,
+            fib->no_tbllong_free * sizeof(uint32_t));
+    memcpy(retired, fib->tbllong_retired,
+            fib->no_tbllong_retired * sizeof(uint32_t));
+
+    rte_smp_wmb(); // The copy must be complete before lookups can see it
+    fib->tbllong = tbllong;
+    rte_free(fib->tbllong_depth);
+    rte_free(fib->tbllong_free);
+    rte_free(fib->tbllong_retired);
+    fib->tbllong_depth = depth;
+    fib->tbllong_free = free_groups;
+    fib->tbllong_retired = retired;
+    fib->tbllong_capacity = capacity;
+
+    if(is_published(fib))
+        wait_for_fib_readers();
+    rte_free(old_tbllong);
+
+    LOG_INFO("Increased the size of TBLlong to %u groups\n", capacity);
+
+    return 0;
+}
+
+/**
+ * \brief Get an unused TBLlong group.
+ * 
+ * We prefer released groups and allocated groups never used before.
+ * Retired groups are reused after every reader passed a quiescent state.
+ * If there are none, we grow TBLlong.
+ * 
+ * \param fib The structure.
+ * 
+ * \return The index of the group.
+ *          Errors: ERR_MEM: Not enough memory to grow TBLlong.
+ *                  ERR_GEN: Not enough space in TBLlong.
+ */
+static int alloc_tbllong_group(dir24_8_t *fib)
+{
+    int ret = 0;
+
+    if(fib->no_tbllong_free > 0)
+        return fib->tbllong_free[--fib->no_tbllong_free];
+    if(fib->no_tbllong_entries < fib->tbllong_capacity)
+        return fib->no_tbllong_entries++;
+    if(fib->no_tbllong_retired == 0) {
+        if((ret = grow_tbllong(fib)) < 0)
+            return ret;
+        return fib->no_tbllong_entries++;
+    }
+
+    // Lookups started before the groups were released may still read them
+    if(is_published(fib))
+        wait_for_fib_readers();
+    memcpy(fib->tbllong_free, fib->tbllong_retired,
+            fib->no_tbllong_retired * sizeof(uint32_t));
+    fib->no_tbllong_free = fib->no_tbllong_retired;
+    fib->no_tbllong_retired = 0;
+
+    return fib->tbllong_free[--fib->no_tbllong_free];
+}
+
+/**
+ * \brief Release the TBLlong group of a TBL24 entry if it is no longer needed.
+ * 
+ * If no entry of the group is set by a route longer than /24, all entries
+ * belong to the same route (or no route at all). We store this route in the
+ * TBL24 entry and retire the group.
+ * 
+ * \param fib The structure.
+ * \param tbl24_idx The TBL24 entry pointing to the group.
+ */
+static void recycle_tbllong_group(dir24_8_t *fib, uint32_t tbl24_idx)
+{
+    tbl24_entry_t entry = fib->tbl24[tbl24_idx];
+    const uint32_t group = entry.index;
+    uint32_t i = 0;
+
+    for(i = group * 256; i < (group + 1) * 256; ++i)
+        if(fib->tbllong_depth[i] > 24)
+            return;
+
+    entry.indicator = 0;
+    entry.index = fib->tbllong[group * 256].index;
+    fib->tbl24_depth[tbl24_idx] = fib->tbllong_depth[group * 256];
+    fib->tbl24[tbl24_idx] = entry;
+
+    fib->tbllong_retired[fib->no_tbllong_retired++] = group;
+}
+
+/**
+ * \brief Find the entry of a route in the list of routes.
+ * 
+ * \param dst_net The IP address of the destination in little endian format.
+ * \param prf The CIDR prefix of the destination.
+ * 
+ * \return The route or NULL if there is no route for this network.
+ */
+static tmp_route_t *find_route(uint32_t dst_net, uint8_t prf)
+{
+    route_key_t key;
+    void *route = NULL;
+
+    if(route_hash == NULL)
+        return NULL;
+
+    get_route_key(&key, dst_net & prf_to_netmask(prf), prf);
+    if(rte_hash_lookup_data(route_hash, &key, &route) < 0)
+        return NULL;
+    return route;
+}
+
+/**
+ * \brief Find the longest route containing the given network.
+ * 
+ * We look up all shorter prefixes of the network from the longest to the
+ * shortest one.
+ * 
+ * \param dst_net The network in little endian format.
+ * \param prf The CIDR prefix of the network. Only shorter routes are
+ *              considered.
+ * 
+ * \return The route or NULL if there is none.
+ */
+static const tmp_route_t *find_covering_route(uint32_t dst_net, uint8_t prf)
+{
+    const tmp_route_t *cover = NULL;
+
+    while(prf-- > 0)
+        if((cover = find_route(dst_net, prf)) != NULL)
+            return cover;
+
+    return NULL;
+}
+
+/**
+ * \brief Get the hash key of a route.
+ */
+static void get_route_key(route_key_t *key, uint32_t dst_net, uint8_t prf)
+{
+    memset(key, 0, sizeof(route_key_t));
+    key->dst_net_cpu_bo = dst_net;
+    key->prf = prf;
+}
+
+/**
+ * \brief Double the size of the route hash table.
+ * 
+ * Creates the hash table if there is none.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ */
+static int grow_route_hash(void)
+{
+    const uint32_t size = route_hash == NULL ?
+                            INIT_NO_ROUTES : route_hash_size * 2;
+    struct rte_hash *hash = NULL;
+    const void *key = NULL;
+    void *route = NULL;
+    uint32_t it = 0;
+
+    if((hash = create_hash("routes", size, sizeof(route_key_t),
+                            SOCKET_ID_ANY)) == NULL)
+        return ERR_MEM;
+
+    while(
+        route_hash != NULL
+        && rte_hash_iterate(route_hash, &key, &route, &it) >= 0
+    ) {
+        if(rte_hash_add_key_data(hash, key, route) < 0) {
+            rte_hash_free(hash);
+            return ERR_MEM;
+        }
+    }
+
+    rte_hash_free(route_hash);
+    route_hash = hash;
+    route_hash_size = size;
+    return 0;
+}
+
+/**
+ * \brief Create a hash table with fixed size keys.
+ * 
+ * \param type A string identifying the hash table.
+ * \param entries The number of entries.
+ * \param key_len The size of a key in bytes.
+ * \param socket The socket of the memory of the table.
+ * 
+ * \return The hash table or NULL if there is not enough memory.
+ */
+static struct rte_hash *create_hash(const char *type, uint32_t entries,
+                                    uint32_t key_len, int socket)
+{
+    static uint no_hashes = 0; // Names of DPDK hash tables must be unique
+    char name[RTE_HASH_NAMESIZE];
+    struct rte_hash_parameters params = {
+        .name = name,
+        .entries = entries,
+        .key_len = key_len,
+        .hash_func = rte_hash_crc,
+        .socket_id = socket,
+    };
+
+    snprintf(name, sizeof(name), "%s_%u", type, no_hashes++);
+    return rte_hash_create(&params);
+}
+
+/**
+ * \brief Convert a CIDR prefix to a netmask in CPU byte order.
+ */
+static uint32_t prf_to_netmask(uint8_t prf)
+{
+    // The expression below cannot handle prefixes of 0 nicely
+    // (without casting to 64 bits and then back to 32)
+    if(prf == 0)
+        return 0;
+    return ~((UINT32_C(1) << (32 - prf)) - 1);
+}
+
+/**
+ * \brief Check if a structure is used by the lookups of any socket.
+ */
+static bool is_published(const dir24_8_t *fib)
+{
+    uint socket = 0;
+
+    for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket)
+        if(fibs[socket] == fib)
+            return true;
+    return false;
+}
+
+/**
+ * \brief Get every structure used by the lookups.
+ * 
+ * \param out Buffer for up to RTE_MAX_NUMA_NODES structures.
+ * 
+ * \return The number of distinct structures in out.
+ */
+static uint get_published_fibs(dir24_8_t **out)
+{
+    uint socket = 0, i = 0, no_fibs = 0;
+
+    for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket) {
+        if(fibs[socket] == NULL)
+            continue;
+        for(i = 0; i < no_fibs && out[i] != fibs[socket]; ++i)
+            ;
+        if(i == no_fibs)
+            out[no_fibs++] = fibs[socket];
+    }
+
+    return no_fibs;
+}
+
+/**
+ * \brief Replicate a new primary structure and replace the ones in use.
+ * 
+ * See update_routing_table().
+ * 
+ * \param primary The new primary structure. We take over its ownership, i.e.
+ *              it is freed on any error.
+ * \param primary_socket The socket of the primary structure.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory for the replicas.
+ */
+static int install_fib(dir24_8_t *primary, int primary_socket)
+{
+    dir24_8_t *new_fibs[RTE_MAX_NUMA_NODES] = { NULL };
+    uint lcore = 0, socket = 0;
+    int ret = 0;
+
+    for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket)
+        new_fibs[socket] = primary;
+
+    if(replicate_fib) {
+        RTE_LCORE_FOREACH(lcore) {
+            socket = rte_lcore_to_socket_id(lcore);
+            if(
+                (int)socket == primary_socket
+                || new_fibs[socket] != primary // Already replicated
+            )
+                continue;
+
+            if((new_fibs[socket] = replicate_fib_on(primary, socket)) == NULL) {
+                printf("Cannot replicate the routing table on socket %u!\n",
+                        socket);
+                new_fibs[socket] = primary;
+                ret = ERR_MEM;
+                break;
+            }
+
+            LOG_INFO("Replicated the routing table on socket %u\n", socket);
+        }
+
+        if(ret < 0) { // Nobody uses the new tables -> Free them directly
+            for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket)
+                if(new_fibs[socket] != primary)
+                    free_fib(new_fibs[socket]);
+            free_fib(primary);
+            return ret;
+        }
+    }
+
+    publish_fibs(new_fibs);
+    primary_fib = primary;
+    return 0;
+}
+
+/**
+ * \brief Copy a Dir-24-8 structure to the memory of another socket.
+ * 
+ * Structures of other lookup engines are rebuilt on this socket.
+ * 
+ * \param src The structure we copy.
+ * \param socket The socket of the copy.
+ * 
+ * \return The copy or NULL if there is not enough memory.
+ */
+static dir24_8_t *replicate_fib_on(const dir24_8_t *src, int socket)
+{
+    const size_t hops_size = src->no_nxt_hops * sizeof(rt_entry_t);
+    dir24_8_t *fib = NULL;
+
+    // The tables of other engines are built from the list of routes again.
+    // The next hops get the same IDs as in the source.
+    if(src->engine != NULL) {
+        if(
+            (fib = create_engine_fib(src->engine, socket)) == NULL
+            || fill_engine_fib(fib) < 0
+        ) {
+            free_fib(fib);
+            return NULL;
+        }
+        return fib;
+    }
+
+    if((fib = create_fib(socket, src->tbllong_capacity)) == NULL)
+        return NULL;
+
+    if((fib->nxt_hops_map = alloc_fib_mem("nxt_hops_map", hops_size,
+                                            socket)) == NULL) {
+        free_fib(fib);
+        return NULL;
+    }
+
+    memcpy(fib->tbl24, src->tbl24, TBL24_SIZE);
+    memcpy(fib->tbllong, src->tbllong,
+            src->no_tbllong_entries * TBLlong_GROUP_SIZE);
+    memcpy(fib->nxt_hops_map, src->nxt_hops_map, hops_size);
+    memcpy(fib->tbl24_depth, src->tbl24_depth, TBL24_NO_ENTRIES);
+    memcpy(fib->tbllong_depth, src->tbllong_depth,
+            src->no_tbllong_entries * 256);
+    memcpy(fib->tbllong_free, src->tbllong_free,
+            src->no_tbllong_free * sizeof(uint32_t));
+    memcpy(fib->tbllong_retired, src->tbllong_retired,
+            src->no_tbllong_retired * sizeof(uint32_t));
+    fib->no_tbllong_entries = src->no_tbllong_entries;
+    fib->no_tbllong_free = src->no_tbllong_free;
+    fib->no_tbllong_retired = src->no_tbllong_retired;
+    fib->no_nxt_hops = fib->curr_size_nxt_hops_tab = src->no_nxt_hops;
+
+    if(
+        (fib->adjs = alloc_adjs(fib, fib->no_nxt_hops)) == NULL
+        || rebuild_hop_hash(fib, RTE_MAX(2 * fib->no_nxt_hops,
+                                            (uint)INIT_NO_NXT_HOPS)) < 0
+    ) {
+        free_fib(fib);
+        return NULL;
+    }
+
+    return fib;
+}
+
+/**
+ * \brief Replace the tables used by the lookups of all sockets.
+ * 
+ * The new tables are published with one atomic pointer store per socket.
+ * Afterwards, we wait until no reader can use the replaced tables anymore
+ * and free them.
+ * 
+ * \param new_fibs The new tables of every socket. Sockets may share tables.
+ *              NULL entries remove the tables of a socket.
+ */
+static void publish_fibs(dir24_8_t **new_fibs)
+{
+    dir24_8_t *old_fibs[RTE_MAX_NUMA_NODES];
+    uint socket = 0, prev = 0;
+
+    // The new tables must be complete before a reader can see them
+    rte_smp_wmb();
+    for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket) {
+        old_fibs[socket] = fibs[socket];
+        fibs[socket] = new_fibs[socket];
+    }
+    primary_fib = NULL;
+
+    wait_for_fib_readers();
+
+    // Free every replaced structure exactly once
+    for(socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket) {
+        for(prev = 0; prev < socket; ++prev)
+            if(old_fibs[prev] == old_fibs[socket])
+                break;
+        if(prev == socket)
+            free_fib(old_fibs[socket]);
+    }
+}
+
+/**
+ * \brief Wait until every registered reader passed a quiescent state.
+ * 
+ * Readers that are not registered do not use any table pointer. Thus, we do
+ * not have to wait for them. Other tables read by the workers between two
+ * quiescent states (e.g. the neighbor table) use this as well.
+ */
+void wait_for_fib_readers(void)
+{
+    uint64_t qs_cnts[RTE_MAX_LCORE];
+    uint lcore = 0;
+
+    // Our pointer stores must be visible before we read the counters
+    rte_smp_mb();
+    for(lcore = 0; lcore < RTE_MAX_LCORE; ++lcore)
+        qs_cnts[lcore] = fib_readers[lcore].qs_cnt;
+
+    for(lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        if(lcore == rte_lcore_id()) // We do not wait for ourselves
+            continue;
+        while(
+            fib_readers[lcore].online
+            && fib_readers[lcore].qs_cnt == qs_cnts[lcore]
+        )
+            rte_pause();
+    }
+}
+
+/**
+ * \brief Write a section of a snapshot file.
+ * 
+ * \param file The snapshot file.
+ * \param data The section.
+ * \param size The size of the section in bytes.
+ * \param crc The checksum of the previous sections. Updated by this section.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_GEN: Cannot write the file.
+ */
+static int write_section(FILE *file, const void *data, size_t size,
+                            uint32_t *crc)
+{
+    if(size == 0)
+        return 0;
+
+    *crc = rte_hash_crc(data, size, *crc);
+    return fwrite(data, size, 1, file) == 1 ? 0 : ERR_GEN;
+}
+
+/**
+ * \brief Read a section of a snapshot file.
+ * 
+ * See write_section().
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_GEN: The file is too short.
+ */
+static int read_section(FILE *file, void *data, size_t size, uint32_t *crc)
+{
+    if(size == 0)
+        return 0;
+
+    if(fread(data, size, 1, file) != 1)
+        return ERR_GEN;
+    *crc = rte_hash_crc(data, size, *crc);
+    return 0;
+}
+
+/**
+ * \brief Check that a loaded structure only refers to loaded entries.
+ * 
+ * The lookups do not check the IDs they read. Thus, we must not publish
+ * tables pointing behind TBLlong or the next hops table.
+ * 
+ * \param fib The loaded structure.
+ * 
+ * \return 0 if the structure is consistent.
+ *          Errors: ERR_FORMAT
+ */
+static int check_snapshot_fib(const dir24_8_t *fib)
+{
+    uint32_t i = 0;
+
+    for(i = 0; i < TBL24_NO_ENTRIES; ++i) {
+        if(
+            fib->tbl24[i].index >= (fib->tbl24[i].indicator ?
+                                    fib->no_tbllong_entries : fib->no_nxt_hops)
+        )
+            return ERR_FORMAT;
+    }
+
+    for(i = 0; i < fib->no_tbllong_entries * 256; ++i)
+        if(fib->tbllong[i].index >= fib->no_nxt_hops)
+            return ERR_FORMAT;
+
+    for(i = 0; i < fib->no_tbllong_free; ++i)
+        if(fib->tbllong_free[i] >= fib->no_tbllong_entries)
+            return ERR_FORMAT;
+
+    return 0;
+}
+
+/**
+ * \brief Take over the next hop IDs of the routes of a snapshot.
+ * 
+ * If there are no routes configured, we add the routes of the snapshot to
+ * the list of routes. Otherwise, the configured routes must be exactly the
+ * routes of the snapshot.
+ * 
+ * \param routes The route manifest of the snapshot.
+ * \param n The number of routes in the manifest.
+ * \param no_nxt_hops The number of next hops of the snapshot.
+ * 
+ * \return 0 on success.
+ *          Errors: ERR_MISMATCH: The routes do not match.
+ *                  ERR_FORMAT: Invalid route in the manifest.
+ *                  ERR_MEM: Not enough memory.
+ */
+static int adopt_snapshot_routes(const fib_snapshot_route_t *routes,
+                                    uint32_t n, uint32_t no_nxt_hops)
+{
+    struct ether_addr mac;
+    tmp_route_t *route = NULL;
+    const bool configured = no_routes > 0;
+    uint32_t i = 0;
+
+    if(configured && n != no_routes)
+        return ERR_MISMATCH;
+
+    for(i = 0; i < n; ++i) {
+        if(routes[i].prf > 32 || routes[i].hop_id >= no_nxt_hops)
+            return ERR_FORMAT;
+        if(!configured)
+            continue;
+
+        route = find_route(routes[i].dst_net_cpu_bo, routes[i].prf);
+        if(
+            route == NULL
+            || route->intf != routes[i].intf
+            || !is_same_ether_addr(&route->dst_mac, &routes[i].dst_mac)
+        )
+            return ERR_MISMATCH;
+    }
+
+    for(i = 0; i < n; ++i) {
+        ether_addr_copy(&routes[i].dst_mac, &mac);
+        if((route = store_route(routes[i].dst_net_cpu_bo, routes[i].prf,
+                                &mac, routes[i].intf)) == NULL) {
+            if(!configured)
+                clean_tmp_routing_table();
+            return ERR_MEM;
+        }
+        route->hop_id = routes[i].hop_id;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Get the next hop IDs of four IPv4 addresses.
+ * 
+ * The given Dir-24-8 tables must be built.
+ * 
+ * \param fib The tables used for the lookup.
+ * \param ips The four destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the four next hop IDs.
+ */
+static void lookup_x4(const dir24_8_t *fib, const uint32_t *ips,
+                        uint32_t *hop_ids)
+{
+    #ifdef __AVX2__
+    __m128i ip = _mm_loadu_si128((const __m128i *)ips);
+    __m128i entry, is_long, hop, long_idx;
+
+    entry = _mm_i32gather_epi32(
+                (const int *)fib->tbl24, _mm_srli_epi32(ip, 8), 4
+            );
+    // The indicator is the lowest bit of an entry, the index the other 31
+    is_long = _mm_cmpeq_epi32(
+                    _mm_and_si128(entry, _mm_set1_epi32(1)),
+                    _mm_set1_epi32(1)
+                );
+    hop = _mm_srli_epi32(entry, 1);
+
+    // Only gather TBLlong entries of addresses that require them
+    if(!_mm_testz_si128(is_long, is_long)) {
+        long_idx = _mm_add_epi32(
+                        _mm_slli_epi32(hop, 8),
+                        _mm_and_si128(ip, _mm_set1_epi32(0xFF))
+                    );
+        hop = _mm_mask_i32gather_epi32(
+                    hop, (const int *)fib->tbllong, long_idx, is_long, 4
+                );
+    }
+
+    _mm_storeu_si128((__m128i *)hop_ids, hop);
+    #else
+    for(uint8_t i = 0; i < 4; ++i)
+        hop_ids[i] = get_next_hop_id(fib, ips[i]);
+    #endif
+}
+
+/**
+ * \brief Get the next hop IDs of eight IPv4 addresses.
+ * 
+ * The given Dir-24-8 tables must be built.
+ * 
+ * \param fib The tables used for the lookup.
+ * \param ips The eight destination IPs in CPU byte order (little endian)
+ * \param hop_ids Buffer for the eight next hop IDs.
+ */
+static void lookup_x8(const dir24_8_t *fib, const uint32_t *ips,
+                        uint32_t *hop_ids)
+{
+    #ifdef __AVX2__
+    __m256i ip = _mm256_loadu_si256((const __m256i *)ips);
+    __m256i entry, is_long, hop, long_idx;
+
+    // See lookup_x4() for the layout of the entries
+    entry = _mm256_i32gather_epi32(
+                (const int *)fib->tbl24, _mm256_srli_epi32(ip, 8), 4
+            );
+    is_long = _mm256_cmpeq_epi32(
+                    _mm256_and_si256(entry, _mm256_set1_epi32(1)),
+                    _mm256_set1_epi32(1)
+                );
+    hop = _mm256_srli_epi32(entry, 1);
+
+    if(!_mm256_testz_si256(is_long, is_long)) {
+        long_idx = _mm256_add_epi32(
+                        _mm256_slli_epi32(hop, 8),
+                        _mm256_and_si256(ip, _mm256_set1_epi32(0xFF))
+                    );
+        hop = _mm256_mask_i32gather_epi32(
+                    hop, (const int *)fib->tbllong, long_idx, is_long, 4
+                );
+    }
+
+    _mm256_storeu_si256((__m256i *)hop_ids, hop);
+    #else
+    lookup_x4(fib, ips, hop_ids);
+    lookup_x4(fib, ips + 4, hop_ids + 4);
+    #endif
+}
@@ -7,7 +7,7 @@
 #include <rte_ether.h>
 
 // build a new routing table
-void add_route(uint32_t ip_addr, uint8_t prefix, struct ether_addr* mac_addr, uint8_t port);
+int add_route(uint32_t ip_addr, uint8_t prefix, struct ether_addr* mac_addr, uint8_t port);
 void print_routes();
 void print_port_id_to_mac();
 void build_routing_table();
@@ -14,15 +14,28 @@
 
 #include <rte_config.h>
 #include <rte_ether.h>
+#include <rte_lcore.h>
+#include <rte_atomic.h>
+#include <rte_hash.h>
 
 #include "routing_table.h"
 
-#define TBL24_SIZE ((2 << 23) * sizeof(tbl24_entry_t))
-#define TBLlong_MAX_ENTRIES 4096
-// 4096 entries are possible -> If gcc uses the 8 bit as we said -> 1MB
-// In the paper about Dir-24-8 this value was recommended -> Use it
-#define TBLlong_SIZE (4096 * sizeof(tbllong_entry_t) * 256)
+#define TBL24_NO_ENTRIES (2 << 23)
+#define TBL24_SIZE (TBL24_NO_ENTRIES * sizeof(tbl24_entry_t))
+// TBLlong starts with the 4096 groups recommended in the paper about
+// Dir-24-8 and grows on demand. A TBL24 entry can address 2^31 groups,
+// but we stop at 2^20 groups (1GB) to not eat all hugepages
+#define TBLlong_INIT_ENTRIES 4096
+#define TBLlong_MAX_ENTRIES (1 << 20)
+#define TBLlong_GROUP_SIZE (256 * sizeof(tbllong_entry_t))
 #define INIT_NO_NXT_HOPS 20
+#define INIT_NO_ROUTES 1024
+#define FIB_SNAPSHOT_MAGIC "DIR-24-8"
+#define FIB_SNAPSHOT_VERSION 1
+// Next hop IDs are stored in the 31 bit index of the TBL24 entries
+#define MAX_NO_NXT_HOPS (UINT32_C(1) << 31)
+// Bytes of an ethernet header rewritten by an adjacency
+#define ADJ_L2_LEN (2 * ETHER_ADDR_LEN)
 
 /**********************************
  *     Structure definitions      *
@@ -30,47 +43,275 @@
 
 /*
  * We use this struct to store all routing table entries read from the command
- * line sorted.
- * This sorted list simplifies the building procedure.
+ * line. The routes are kept in a hash table indexed by network and prefix.
+ * They are sorted when we build the Dir-24-8 structure.
  */
 typedef struct tmp_route {
     uint32_t dst_net_cpu_bo; // network and netmask in cpu endianness
     uint32_t netmask_cpu_bo;
     uint8_t prf;
 	uint8_t intf;
-    // As we can only store 8 bits in the TBLlong anyway, we can use 8 bits here
-    uint8_t hop_id;
+    uint32_t hop_id;
 	struct ether_addr dst_mac; // next hop MAC
-    struct tmp_route *nxt;
 } tmp_route_t;
 
+/*
+ * Hash keys of the routes and next hops. Unused bytes must be zero.
+ */
+typedef struct route_key {
+    uint32_t dst_net_cpu_bo;
+    uint8_t prf;
+    uint8_t pad[3];
+} route_key_t;
+
+typedef struct nxt_hop_key {
+    struct ether_addr dst_mac;
+    uint8_t intf;
+    uint8_t pad;
+} nxt_hop_key_t;
+
+/*
+ * All entries are 32 bit wide. Thus, every entry is read and written with a
+ * single aligned access and the SIMD lookup gathers them without masking.
+ */
 typedef struct tbl24_entry {
-    uint16_t indicator:1; // Valid entry or lookup in TBLlong
-    uint16_t index:15; 
-}__attribute__((packed)) tbl24_entry_t;
+    uint32_t indicator:1; // Valid entry or lookup in TBLlong
+    uint32_t index:31; // Next hop ID or TBLlong group
+} tbl24_entry_t;
 
 typedef struct tbllong_entry {
-    uint8_t index;
-}__attribute__((packed)) tbllong_entry_t;
+    uint32_t index; // Next hop ID
+} tbllong_entry_t;
 
 typedef struct routing_table_entry rt_entry_t;
 
+/*
+ * The adjacency of a next hop: The ethernet addresses of every frame sent to
+ * the next hop, ready to be copied over the frame, and the egress interface.
+ * Built from the next hops table on the control path -> The datapath
+ * rewrites a frame with one copy of ADJ_L2_LEN bytes.
+ */
+typedef struct adjacency {
+    uint8_t l2[ADJ_L2_LEN]; // Destination MAC, source MAC
+    uint8_t intf;
+    uint8_t pad[3];
+} adj_t;
+
+struct dir24_8;
+
+/*
+ * A lookup engine that stores the routes in its own structure instead of the
+ * Dir-24-8 tables. The next hop IDs and the next hops table are shared by
+ * all engines -> get_hop_info() works for the IDs of every engine.
+ * The structures are built from scratch on every update. See fib_engines.c.
+ */
+typedef struct fib_engine {
+    const char *name;
+    // Build fib->engine_tbl from n routes in any order
+    int (*build)(struct dir24_8 *fib, tmp_route_t *const *routes, uint n);
+    void (*free)(void *tbl);
+    uint32_t (*lookup)(const void *tbl, uint32_t dst_ip_cpu_bo);
+    void (*lookup_bulk)(const void *tbl, const uint32_t *ips,
+                        uint32_t *hop_ids, uint32_t n);
+    size_t (*memory)(const void *tbl); // Bytes read by the lookups
+} fib_engine_t;
+
+/*
+ * A Dir-24-8 structure used by the lcores of one or more sockets.
+ * Every socket either uses the primary structure or a replica of it located
+ * in the memory of this socket.
+ * If another lookup engine is selected, the structure only holds the next
+ * hops and the structure of the engine. All Dir-24-8 tables are NULL.
+ */
+typedef struct dir24_8 {
+    tbl24_entry_t *tbl24;
+    tbllong_entry_t *tbllong;
+    uint no_tbllong_entries; // Number of TBLlong groups used so far
+    uint tbllong_capacity; // Number of TBLlong groups allocated
+    // Prefix length of the route each TBL24/TBLlong entry was set by.
+    // Only read by route updates -> Lookups never touch these arrays
+    uint8_t *tbl24_depth;
+    uint8_t *tbllong_depth;
+    // Released TBLlong groups. Lookups may still read retired groups until
+    // every reader passed a quiescent state -> Only free groups are reused
+    uint32_t *tbllong_free;
+    uint no_tbllong_free;
+    uint32_t *tbllong_retired;
+    uint no_tbllong_retired;
+    rt_entry_t *nxt_hops_map;
+    adj_t *adjs; // Adjacency of every next hop, indexed like nxt_hops_map
+    struct rte_hash *nxt_hops_hash; // (intf, MAC) -> next hop ID
+    uint curr_size_nxt_hops_tab;
+    uint no_nxt_hops; // Number of valid entries
+    int socket;
+    const fib_engine_t *engine; // NULL: Lookups use the Dir-24-8 tables
+    void *engine_tbl;
+} dir24_8_t;
+
+/*
+ * Header of a routing table snapshot file.
+ * The header is followed by these sections:
+ *  - TBL24 and the prefix lengths of its entries
+ *  - All used TBLlong groups and the prefix lengths of their entries
+ *  - The IDs of the unused TBLlong groups below no_tbllong_entries
+ *  - The next hops table (no_nxt_hops entries, including ID 0)
+ *  - The route manifest (no_routes fib_snapshot_route_t)
+ * All values are stored in the byte order of the host.
+ */
+typedef struct fib_snapshot_hdr {
+    char magic[8];
+    uint32_t version;
+    uint32_t crc; // CRC32-C of all sections
+    uint32_t no_tbllong_entries;
+    uint32_t no_free_groups;
+    uint32_t no_nxt_hops;
+    uint32_t no_routes;
+} fib_snapshot_hdr_t;
+
+typedef struct fib_snapshot_route {
+    uint32_t dst_net_cpu_bo;
+    uint32_t hop_id;
+    uint8_t prf;
+    uint8_t intf;
+    struct ether_addr dst_mac;
+} __attribute__((packed)) fib_snapshot_route_t;
+
+/*
+ * Quiescent state tracking of an lcore reading the routing table.
+ * Only the lcore itself writes its entry -> No atomics required.
+ */
+typedef struct fib_reader {
+    volatile uint64_t qs_cnt; // Number of reported quiescent states
+    volatile bool online;
+} __rte_cache_aligned fib_reader_t;
+
 
 /**********************************
  *     Function declarations      *
  **********************************/
 void clean_tmp_routing_table(void);
+uint get_no_routes(void);
+uint get_route_nets(uint32_t *nets, uint8_t *prfs, uint max);
 void clean_routing_table(void);
+void set_routing_table_placement(int socket, bool replicate);
+int set_fib_engine(const char *name);
+int del_route(uint32_t dst_net, uint8_t prf);
+int update_routing_table(void);
+int fib_add_route(uint32_t dst_net, uint8_t prf,
+                    struct ether_addr *mac, uint8_t intf);
+int fib_del_route(uint32_t dst_net, uint8_t prf);
+int save_routing_table(const char *path);
+int load_routing_table(const char *path);
+void register_fib_reader(void);
+void unregister_fib_reader(void);
+void wait_for_fib_readers(void);
+void lookup_bulk(const dir24_8_t *fib, const uint32_t *ips,
+                    uint32_t *hop_ids, uint32_t n);
+void get_next_hop_bulk(const uint32_t *ips, uint32_t *hop_ids, uint32_t n);
+void get_next_hop_x4(const uint32_t *ips, uint32_t *hop_ids);
+void get_next_hop_x8(const uint32_t *ips, uint32_t *hop_ids);
+size_t get_fib_memory(const dir24_8_t *fib);
+void *alloc_fib_mem(const char *type, size_t size, int socket);
+void set_adj(adj_t *adj, const rt_entry_t *entry);
 
 /**********************************
  *   Global field declarations    *
  **********************************/
-extern tmp_route_t *tmp_route_list;
-extern tbl24_entry_t *tbl24;
-extern tbllong_entry_t *tbllong;
-extern uint no_tbllong_entries;
-extern rt_entry_t *nxt_hops_map;
-extern uint curr_size_nxt_hops_tab_tab;
-extern uint no_nxt_hops;
-#endif
+extern dir24_8_t *volatile fibs[RTE_MAX_NUMA_NODES];
+extern fib_reader_t fib_readers[RTE_MAX_LCORE];
 
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Get the Dir-24-8 structure of the socket of the calling lcore.
+ * 
+ * Threads not managed by DPDK use the structure of socket 0.
+ * A registered reader may use the structure until it reports its next
+ * quiescent state.
+ * 
+ * \return The structure or NULL if the routing table is not built.
+ */
+static inline const dir24_8_t *get_local_fib(void)
+{
+    unsigned socket = rte_socket_id();
+
+    if(socket >= RTE_MAX_NUMA_NODES)
+        socket = 0;
+    return fibs[socket];
+}
+
+/**
+ * \brief Report a quiescent state of the calling lcore.
+ * 
+ * The lcore tells update_routing_table() that it does not use any
+ * pointer obtained from the routing table anymore.
+ */
+static inline void fib_quiescent(void)
+{
+    fib_readers[rte_lcore_id()].qs_cnt++;
+    // The next table pointer must not be read before the counter is visible
+    rte_smp_mb();
+}
+
+/**
+ * \brief Get the next hop ID of an IPv4 address from the Dir-24-8 structure.
+ * 
+ * This is the scalar lookup used by get_next_hop() and the bulk lookup for
+ * addresses that do not fill a SIMD vector. Structures of another lookup
+ * engine are searched by the engine.
+ * The Dir-24-8 structure must be built before.
+ * 
+ * \param fib The tables used for the lookup. See get_local_fib().
+ * \param dst_ip_cpu_bo The destination IP in CPU byte order (little endian)
+ * 
+ * \return The next hop ID. 0 if there is no route to this address.
+ */
+static inline uint32_t get_next_hop_id(const dir24_8_t *fib,
+                                        uint32_t dst_ip_cpu_bo)
+{
+    const tbl24_entry_t *tbl24_entry = NULL;
+
+    if(fib->engine != NULL)
+        return fib->engine->lookup(fib->engine_tbl, dst_ip_cpu_bo);
+
+    tbl24_entry = &fib->tbl24[dst_ip_cpu_bo >> 8];
+    if(tbl24_entry->indicator == 0) // TBL24 valid
+        return tbl24_entry->index;
+    return fib->tbllong[
+                    (tbl24_entry->index * 256) + ((uint8_t)dst_ip_cpu_bo)
+                ].index;
+}
+
+/**
+ * \brief Get the forwarding information of a next hop ID.
+ * 
+ * \param fib The tables the ID was looked up in.
+ * \param hop_id A next hop ID returned by one of the lookup functions.
+ * 
+ * \return The rt_entry_t* of the next hop or NULL if the ID is the
+ *          'no route to host' ID.
+ */
+static inline rt_entry_t *get_hop_info(const dir24_8_t *fib, uint32_t hop_id)
+{
+    if(hop_id == 0)
+        return NULL;
+    return fib->nxt_hops_map + hop_id;
+}
+
+/**
+ * \brief Get the adjacency of a next hop ID.
+ * 
+ * \param fib The tables the ID was looked up in.
+ * \param hop_id A next hop ID returned by one of the lookup functions.
+ * 
+ * \return The adjacency of the next hop or NULL if the ID is the
+ *          'no route to host' ID.
+ */
+static inline const adj_t *get_adj(const dir24_8_t *fib, uint32_t hop_id)
+{
+    if(hop_id == 0)
+        return NULL;
+    return fib->adjs + hop_id;
+}
+#endif
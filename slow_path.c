@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <netinet/ip_icmp.h>
+
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+
+#include "slow_path.h"
+#include "arp_stack.h"
+#include "icmp_stack.h"
+#include "ndp_stack.h"
+#include "neigh.h"
+#include "global.h"
+#include "log.h"
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static void handle_exception(struct rte_mbuf *mbuf, uint64_t now);
+static int handle_ipv4_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
+                                slow_class_t cls, uint64_t now);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+// One ring per lcore that may hand over packets
+struct rte_ring *slow_rings[RTE_MAX_LCORE];
+
+// TX state of the slow path for every interface
+static intf_cfg_t tx_cfg;
+// Configuration of every ingress interface. All share the TX state of tx_cfg.
+static intf_cfg_t *slow_cfgs[RTE_MAX_ETHPORTS];
+static uint64_t next_age = 0;
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Create the rings of all lcores and the ICMP rate limits.
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_CFG: See init_icmp_errors().
+ */
+int init_slow_path(void)
+{
+    char name[RTE_RING_NAMESIZE];
+    uint lcore = 0;
+
+    if(init_icmp_errors() < 0) {
+        printf("Invalid rate limits of the ICMP errors!\n");
+        return ERR_CFG;
+    }
+
+    // The worker is the only producer, the slow path the only consumer
+    RTE_LCORE_FOREACH(lcore) {
+        snprintf(name, sizeof(name), "slow_ring_%u", lcore);
+        if((slow_rings[lcore] = rte_ring_create(name, SLOW_RING_SIZE,
+                                    rte_lcore_to_socket_id(lcore),
+                                    RING_F_SP_ENQ | RING_F_SC_DEQ)) == NULL) {
+            printf("Cannot allocate the rings of the slow path!\n");
+            free_slow_path();
+            return ERR_MEM;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Create the state of the slow path.
+ *
+ * The slow path gets a copy of the configuration of every interface and a
+ * TX buffer for every interface that is known to DPDK.
+ *
+ * \param lcore The lcore of the slow path.
+ * \param tx_queue The TX queue of the slow path on every interface.
+ * \param retries See setup_tx_port().
+ *
+ * \return 0 on success.
+ *          Errors: ERR_MEM: Not enough memory.
+ *                  ERR_CFG: Interface ID not supported by DPDK.
+ */
+int setup_slow_path(unsigned lcore, uint16_t tx_queue, int retries)
+{
+    const intf_cfg_t *it = NULL;
+    intf_cfg_t *cfg = NULL;
+    int ret = 0;
+
+    memset(&tx_cfg, 0, sizeof(tx_cfg));
+    tx_cfg.lcore = lcore;
+    for(it = intf_cfgs; it != NULL; it = it->nxt) {
+        if(rte_eth_dev_is_valid_port(it->intf)
+            && (ret = setup_tx_port(&tx_cfg, it->intf, tx_queue,
+                                    retries)) < 0)
+            return ret;
+    }
+
+    for(it = intf_cfgs; it != NULL; it = it->nxt) {
+        if((cfg = malloc(sizeof(intf_cfg_t))) == NULL)
+            return ERR_MEM;
+        memcpy(cfg, &tx_cfg, sizeof(intf_cfg_t));
+        cfg->intf = it->intf;
+        cfg->ip_addr_be = it->ip_addr_be;
+        ether_addr_copy(&it->ether_addr, &cfg->ether_addr);
+        slow_cfgs[it->intf] = cfg;
+    }
+    return 0;
+}
+
+/**
+ * \brief Free the state and the rings of the slow path.
+ *
+ * Frames still queued are dropped. No lcore may use the slow path anymore.
+ */
+void free_slow_path(void)
+{
+    struct rte_mbuf *mbuf = NULL;
+
+    for(uint lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        while(slow_rings[lcore] != NULL
+            && rte_ring_sc_dequeue(slow_rings[lcore], (void **)&mbuf) == 0)
+            rte_pktmbuf_free(mbuf);
+        rte_ring_free(slow_rings[lcore]);
+        slow_rings[lcore] = NULL;
+    }
+
+    for(uint intf = 0; intf < RTE_MAX_ETHPORTS; ++intf) {
+        free(slow_cfgs[intf]);
+        slow_cfgs[intf] = NULL;
+    }
+    free_tx_ports(&tx_cfg);
+}
+
+/**
+ * \brief Handle the frames the workers handed over and maintain the
+ *      neighbor table.
+ *
+ * Every ring gives at most one burst per call -> A flooding worker cannot
+ * starve the others. All frames of a round, ICMP errors included, are sent
+ * in one flush at its end.
+ *
+ * \return The number of handled frames.
+ */
+uint serve_slow_path(void)
+{
+    struct rte_mbuf *mbufs[THREAD_BUFSIZE];
+    const uint64_t now = rte_rdtsc();
+    uint n = 0, total = 0;
+
+    for(uint lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        if(slow_rings[lcore] == NULL)
+            continue;
+
+        n = rte_ring_sc_dequeue_burst(slow_rings[lcore], (void **)mbufs,
+                                        THREAD_BUFSIZE, NULL);
+        for(uint i = 0; i < n; ++i)
+            handle_exception(mbufs[i], now);
+        total += n;
+    }
+
+    if(now >= next_age) {
+        age_neighs(&tx_cfg, now);
+        next_age = now + rte_get_tsc_hz() * SLOW_AGE_MS / MS_PER_S;
+    }
+
+    flush_frames(&tx_cfg);
+    return total;
+}
+
+/**
+ * \brief Serve the slow path on a dedicated lcore.
+ *
+ * We are no reader of the routing table: Removing neighbors waits for the
+ * quiescent states of the workers.
+ *
+ * \param arg Unused.
+ */
+int slow_path_thread(void *arg)
+{
+    const struct timespec ts = { .tv_nsec = SLOW_IDLE_US * 1000 };
+    lcore_stats_t *stats = &lcore_stats[rte_lcore_id()];
+    uint64_t start = 0;
+
+    while(router_running) {
+        start = rte_rdtsc();
+        if(serve_slow_path() > 0) {
+            stats->busy_cycles += rte_rdtsc() - start;
+            continue;
+        }
+        nanosleep(&ts, NULL);
+        stats->idle_cycles += rte_rdtsc() - start;
+    }
+    return 0;
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Handle a single frame handed over by a worker.
+ *
+ * See defer_to_slow() for the meaning of the metadata.
+ *
+ * \param mbuf The frame. We take ownership of the buffer.
+ * \param now The TSC at the start of the current round.
+ */
+static void handle_exception(struct rte_mbuf *mbuf, uint64_t now)
+{
+    const slow_class_t cls = (slow_class_t)((mbuf->udata64 >> 40) & 0xFF);
+    const uint8_t intf = (uint8_t)(mbuf->udata64 >> 32);
+    const uint32_t ip_cpu_bo = (uint32_t)mbuf->udata64;
+    lcore_stats_t *stats = &lcore_stats[tx_cfg.lcore];
+    intf_cfg_t *cfg = slow_cfgs[intf];
+    int err = 0;
+
+    if(cls == SLOW_NEIGH) {
+        resolve_neigh(&tx_cfg, mbuf, intf, ip_cpu_bo);
+        return;
+    }
+    if(cfg == NULL) { // Not received by this router
+        stats->drops[DROP_TX_NO_INTF]++;
+        rte_pktmbuf_free(mbuf);
+        return;
+    }
+
+    switch(cls) {
+    case SLOW_ARP:
+        err = handle_arp(cfg, mbuf,
+                        rte_pktmbuf_mtod_offset(mbuf, void *, ETHER_HDR_LEN),
+                        rte_pktmbuf_data_len(mbuf) - ETHER_HDR_LEN);
+        if(err < 0)
+            stats->drops[get_drop_reason(err, DROP_ARP_INV)]++;
+        break;
+    case SLOW_LOCAL:
+        if((err = handle_icmp(cfg, mbuf)) < 0)
+            stats->drops[get_drop_reason(err, DROP_IPV4_INV)]++;
+        break;
+    case SLOW_LOCAL6:
+        if((err = handle_ndp(cfg, mbuf)) < 0)
+            stats->drops[err == ERR_NOTFORME ? DROP_IPV6_NOTFORME
+                                            : DROP_IPV6_INV]++;
+        break;
+    case SLOW_TTL_EXP:
+        stats->drops[DROP_IPV4_TTL_EXP]++;
+        err = handle_ipv4_error(cfg, mbuf, cls, now);
+        break;
+    default:
+        stats->drops[DROP_IPV4_NO_ROUTE]++;
+        err = handle_ipv4_error(cfg, mbuf, cls, now);
+        break;
+    }
+
+    if(err < 0)
+        rte_pktmbuf_free(mbuf);
+}
+
+/**
+ * \brief Answer a packet that cannot be forwarded with an ICMP error.
+ *
+ * The worker already decremented the TTL. We undo this first -> The error
+ * quotes the header as received.
+ *
+ * \param cfg The configuration of the ingress interface.
+ * \param mbuf The frame. Reused for the error if it is sent.
+ * \param cls SLOW_TTL_EXP or SLOW_NO_ROUTE.
+ * \param now The current TSC.
+ *
+ * \return 0 if the error was sent. See send_icmp_error().
+ */
+static int handle_ipv4_error(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
+                                slow_class_t cls, uint64_t now)
+{
+    struct ipv4_hdr *ip = rte_pktmbuf_mtod_offset(mbuf, struct ipv4_hdr *,
+                                                    ETHER_HDR_LEN);
+
+    ip->time_to_live++;
+    if(cls == SLOW_TTL_EXP) // The checksum was not updated yet
+        return send_icmp_error(cfg, mbuf, ICMP_TIME_EXCEEDED, ICMP_EXC_TTL,
+                                now);
+
+    ip->hdr_checksum -= rte_cpu_to_be_16(0x0100); // See prepare_fwd()
+    return send_icmp_error(cfg, mbuf, ICMP_DEST_UNREACH, ICMP_NET_UNREACH,
+                            now);
+}
@@ -0,0 +1,90 @@
+/**
+ * This file provides the exception path of the router.
+ *
+ * The workers only forward. Everything else is handed to a dedicated slow
+ * path lcore through one single producer, single consumer ring per worker:
+ * ARP packets, packets addressed to the router, packets that need an ICMP
+ * error, packets to unresolved next hops and IPv6 neighbor discovery.
+ * A worker drops such a packet if its ring is full -> A flood of them cannot
+ * take cycles from forwarding.
+ * The slow path sends on its own TX queue of every interface.
+ */
+#ifndef SLOW_PATH_H__
+#define SLOW_PATH_H__
+
+#include <stdint.h>
+
+#include <rte_config.h>
+#include <rte_mbuf.h>
+#include <rte_ring.h>
+
+#include "router.h"
+#include "ethernet_stack.h"
+#include "stats.h"
+
+// Packets a worker may hand over before the slow path dequeues them
+#define SLOW_RING_SIZE 1024
+// Sleep of the slow path if no ring holds packets
+#define SLOW_IDLE_US 100
+// Interval of the neighbor table maintenance
+#define SLOW_AGE_MS 10
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+/*
+ * Why a worker handed a packet to the slow path.
+ */
+typedef enum slow_class {
+    SLOW_ARP, // ARP request or reply
+    SLOW_LOCAL, // IPv4 packet addressed to the router
+    SLOW_TTL_EXP, // TTL expired in transit
+    SLOW_NO_ROUTE, // No route to the destination
+    SLOW_NEIGH, // The MAC of the next hop is not known
+    SLOW_LOCAL6 // IPv6 packet to a link-local or multicast address
+} slow_class_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+int init_slow_path(void);
+int setup_slow_path(unsigned lcore, uint16_t tx_queue, int retries);
+void free_slow_path(void);
+uint serve_slow_path(void);
+int slow_path_thread(void *arg);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern struct rte_ring *slow_rings[RTE_MAX_LCORE];
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Hand a frame to the slow path.
+ *
+ * The frame is dropped if the ring of the calling lcore is full.
+ *
+ * \param cfg The state of the calling lcore.
+ * \param mbuf The frame. We take ownership of the buffer.
+ * \param cls Why the frame takes the slow path.
+ * \param intf SLOW_NEIGH: The egress interface. Otherwise: The ingress
+ *              interface.
+ * \param ip_cpu_bo SLOW_NEIGH: The next hop in little endian format.
+ *              Otherwise: Ignored.
+ */
+static inline void defer_to_slow(intf_cfg_t *cfg, struct rte_mbuf *mbuf,
+                                    slow_class_t cls, uint8_t intf,
+                                    uint32_t ip_cpu_bo)
+{
+    struct rte_ring *ring = slow_rings[cfg->lcore];
+
+    mbuf->udata64 = (uint64_t)cls << 40 | (uint64_t)intf << 32 | ip_cpu_bo;
+    if(ring == NULL || rte_ring_sp_enqueue(ring, mbuf) != 0) {
+        lcore_stats[cfg->lcore].drops[DROP_SLOW_FULL]++;
+        drop_frames(&mbuf, 1);
+    }
+}
+
+#endif
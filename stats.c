@@ -0,0 +1,279 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_lcore.h>
+
+#include "stats.h"
+#include "dpdk_init.h"
+
+/**********************************
+ *  Static function declarations  *
+ **********************************/
+static bool report_ports(FILE *out, const lcore_stats_t *sum, double secs);
+static bool report_drops(FILE *out, const lcore_stats_t *sum, double secs);
+static bool report_lcores(FILE *out);
+static void report_pools(FILE *out);
+
+/**********************************
+ *    Global field definitions    *
+ **********************************/
+lcore_stats_t lcore_stats[RTE_MAX_LCORE];
+
+static const char *const drop_names[NO_DROP_REASONS] = {
+    [DROP_ETH_SHORT] = "eth_short",
+    [DROP_ETH_NOTFORME] = "eth_not_for_me",
+    [DROP_ETH_TYPE] = "eth_unknown_type",
+    [DROP_ARP_INV] = "arp_invalid",
+    [DROP_ARP_NOT_IMPL] = "arp_not_impl",
+    [DROP_ARP_NOTFORME] = "arp_not_for_me",
+    [DROP_IPV4_INV] = "ipv4_invalid",
+    [DROP_IPV4_NOTFORME] = "ipv4_not_for_me",
+    [DROP_IPV4_TTL_EXP] = "ipv4_ttl_expired",
+    [DROP_IPV4_NO_ROUTE] = "ipv4_no_route",
+    [DROP_TX_NO_INTF] = "tx_no_intf",
+    [DROP_TX_FULL] = "tx_full",
+    [DROP_SLOW_FULL] = "slow_path_full",
+    [DROP_NEIGH_FULL] = "neigh_full",
+    [DROP_NEIGH_FAILED] = "neigh_failed",
+    [DROP_IPV6_INV] = "ipv6_invalid",
+    [DROP_IPV6_NOTFORME] = "ipv6_not_for_me",
+    [DROP_IPV6_HOP_EXP] = "ipv6_hop_limit_expired",
+    [DROP_IPV6_NO_ROUTE] = "ipv6_no_route"
+};
+
+// State of the last report
+static lcore_stats_t last_sum;
+static uint64_t last_imissed[RTE_MAX_ETHPORTS];
+static uint64_t last_nombuf[RTE_MAX_ETHPORTS];
+static uint64_t last_busy[RTE_MAX_LCORE], last_idle[RTE_MAX_LCORE];
+static uint64_t last_report = 0;
+
+/**********************************
+ *      Function definitions      *
+ **********************************/
+/**
+ * \brief Sum up the counters of all lcores.
+ *
+ * The lcores keep counting while we read -> The sum is not a consistent
+ * snapshot, but every counter itself is read completely.
+ *
+ * \param sum The sum of all counters.
+ */
+void sum_stats(lcore_stats_t *sum)
+{
+    const volatile lcore_stats_t *s = NULL;
+    unsigned lcore = 0, i = 0;
+
+    memset(sum, 0, sizeof(lcore_stats_t));
+    for(lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        s = &lcore_stats[lcore];
+
+        for(i = 0; i < NO_DROP_REASONS; ++i)
+            sum->drops[i] += s->drops[i];
+        sum->arp_replies += s->arp_replies;
+        sum->icmp_errors += s->icmp_errors;
+        sum->icmp_limited += s->icmp_limited;
+        sum->busy_cycles += s->busy_cycles;
+        sum->idle_cycles += s->idle_cycles;
+        for(i = 0; i < RTE_MAX_ETHPORTS; ++i) {
+            sum->ports[i].rx_pkts += s->ports[i].rx_pkts;
+            sum->ports[i].rx_bytes += s->ports[i].rx_bytes;
+            sum->ports[i].tx_pkts += s->ports[i].tx_pkts;
+            sum->ports[i].tx_bytes += s->ports[i].tx_bytes;
+        }
+    }
+}
+
+/**
+ * \brief Print the rates of all counters since the last report.
+ *
+ * Only interfaces and drop reasons with traffic are printed. If nothing
+ * happened since the last report, nothing is printed at all.
+ *
+ * \param out The stream the report is written to.
+ */
+void report_stats(FILE *out)
+{
+    lcore_stats_t sum;
+    const uint64_t now = rte_rdtsc();
+    double secs = 0;
+    bool active = false;
+
+    sum_stats(&sum);
+    if(last_report != 0) {
+        secs = (double)(now - last_report) / rte_get_tsc_hz();
+        active |= report_ports(out, &sum, secs);
+        active |= report_drops(out, &sum, secs);
+        if(sum.arp_replies != last_sum.arp_replies) {
+            fprintf(out, "ARP replies: %.1f/s\n",
+                    (sum.arp_replies - last_sum.arp_replies) / secs);
+            active = true;
+        }
+        if(sum.icmp_errors != last_sum.icmp_errors
+            || sum.icmp_limited != last_sum.icmp_limited) {
+            fprintf(out, "ICMP errors: %.1f/s, rate limited %.1f/s\n",
+                    (sum.icmp_errors - last_sum.icmp_errors) / secs,
+                    (sum.icmp_limited - last_sum.icmp_limited) / secs);
+            active = true;
+        }
+        active |= report_lcores(out);
+        if(active) {
+            report_pools(out);
+            fflush(out);
+        }
+    } else {
+        report_lcores(NULL); // Start of the first interval
+    }
+
+    last_sum = sum;
+    last_report = now;
+}
+
+/**
+ * \brief Get the name of a drop reason as used in the reports.
+ *
+ * \param reason The drop reason.
+ *
+ * \return The name or NULL if the reason is unknown.
+ */
+const char *get_drop_name(drop_reason_t reason)
+{
+    if(reason >= NO_DROP_REASONS)
+        return NULL;
+    return drop_names[reason];
+}
+
+/**********************************
+ *   Static function definitions  *
+ **********************************/
+/**
+ * \brief Print the packet and bit rates of all interfaces with traffic.
+ *
+ * Frames the NIC dropped because the RX queues were full (imissed) are
+ * reported as well as failed refills of the RX rings (rx_nombuf): The
+ * mempool was exhausted.
+ *
+ * \return true if something was printed.
+ */
+static bool report_ports(FILE *out, const lcore_stats_t *sum, double secs)
+{
+    const port_stats_t *cur = NULL, *last = NULL;
+    struct rte_eth_stats eth_stats;
+    uint64_t imissed = 0, nombuf = 0;
+    bool active = false;
+
+    for(uint8_t port = 0; port < RTE_MAX_ETHPORTS; ++port) {
+        cur = &sum->ports[port];
+        last = &last_sum.ports[port];
+
+        imissed = last_imissed[port];
+        nombuf = last_nombuf[port];
+        if(rte_eth_dev_is_valid_port(port)
+            && rte_eth_stats_get(port, &eth_stats) == 0) {
+            imissed = eth_stats.imissed;
+            nombuf = eth_stats.rx_nombuf;
+        }
+
+        if(cur->rx_pkts == last->rx_pkts && cur->tx_pkts == last->tx_pkts
+            && imissed == last_imissed[port] && nombuf == last_nombuf[port])
+            continue;
+
+        fprintf(out, "Interface %u: RX %.0f pps %.2f Mbit/s, "
+                        "TX %.0f pps %.2f Mbit/s, missed %.0f pps, "
+                        "no mbuf %.0f/s\n", port,
+                    (cur->rx_pkts - last->rx_pkts) / secs,
+                    (cur->rx_bytes - last->rx_bytes) * 8 / secs / 1e6,
+                    (cur->tx_pkts - last->tx_pkts) / secs,
+                    (cur->tx_bytes - last->tx_bytes) * 8 / secs / 1e6,
+                    (imissed - last_imissed[port]) / secs,
+                    (nombuf - last_nombuf[port]) / secs);
+        last_imissed[port] = imissed;
+        last_nombuf[port] = nombuf;
+        active = true;
+    }
+    return active;
+}
+
+/**
+ * \brief Print the rates of all drop reasons that occurred.
+ *
+ * \return true if something was printed.
+ */
+static bool report_drops(FILE *out, const lcore_stats_t *sum, double secs)
+{
+    bool active = false;
+
+    for(unsigned i = 0; i < NO_DROP_REASONS; ++i) {
+        if(sum->drops[i] == last_sum.drops[i])
+            continue;
+
+        fprintf(out, "%s %s: %.1f/s", active ? "," : "Drops", drop_names[i],
+                (sum->drops[i] - last_sum.drops[i]) / secs);
+        active = true;
+    }
+    if(active)
+        fputc('\n', out);
+    return active;
+}
+
+/**
+ * \brief Print the share of busy cycles of every lcore that received frames.
+ *
+ * A worker close to 100% needs busy polling or more workers. A worker that
+ * is mostly idle can sleep with the backoff or interrupt idle mode.
+ *
+ * \param out The stream of the report. NULL to only remember the counters.
+ *
+ * \return true if something was printed.
+ */
+static bool report_lcores(FILE *out)
+{
+    uint64_t busy = 0, idle = 0;
+    bool active = false;
+
+    for(unsigned lcore = 0; lcore < RTE_MAX_LCORE; ++lcore) {
+        busy = lcore_stats[lcore].busy_cycles - last_busy[lcore];
+        idle = lcore_stats[lcore].idle_cycles - last_idle[lcore];
+        last_busy[lcore] += busy;
+        last_idle[lcore] += idle;
+        if(out == NULL || busy == 0)
+            continue;
+
+        fprintf(out, "%s %u: %.1f%%", active ? "," : "Busy lcores", lcore,
+                100.0 * busy / (busy + idle));
+        active = true;
+    }
+    if(active)
+        fputc('\n', out);
+    return active;
+}
+
+/**
+ * \brief Print the fill level of the mempool of every socket.
+ *
+ * Free mbufs are either in the common pool or in the caches of the lcores.
+ * A high cached share means most allocations are served without touching
+ * the shared pool.
+ */
+static void report_pools(FILE *out)
+{
+    struct rte_mempool *pool = NULL;
+    unsigned avail = 0, cached = 0;
+
+    for(int socket = 0; socket < RTE_MAX_NUMA_NODES; ++socket) {
+        if((pool = get_socket_mempool(socket, false)) == NULL)
+            continue;
+
+        avail = rte_mempool_avail_count(pool);
+        cached = 0;
+        for(unsigned lcore = 0; pool->cache_size > 0 && lcore < RTE_MAX_LCORE;
+                ++lcore)
+            cached += pool->local_cache[lcore].len;
+
+        fprintf(out, "Mempool socket %d: %u of %u mbufs free, "
+                        "%.1f%% of them cached\n", socket, avail, pool->size,
+                    avail > 0 ? 100.0 * cached / avail : 0.0);
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * This file provides the counters of the datapath.
+ *
+ * Every lcore owns a cache line aligned set of counters and is the only
+ * writer -> No atomics. The master lcore sums them up and reports rates.
+ */
+#ifndef STATS_H__
+#define STATS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_config.h>
+#include <rte_memory.h>
+
+#include "global.h"
+
+// Default interval of the stats reports
+#define STATS_DEF_INTERVAL_S 1
+
+/**********************************
+ *     Structure definitions      *
+ **********************************/
+/*
+ * Reasons why the datapath dropped a frame. See drop_names in stats.c.
+ */
+typedef enum drop_reason {
+    DROP_ETH_SHORT, // Shorter than an ethernet header
+    DROP_ETH_NOTFORME, // Neither our MAC nor broadcast
+    DROP_ETH_TYPE, // No stack for the ethertype
+    DROP_ARP_INV, // ERR_INV_PKT of handle_arp()
+    DROP_ARP_NOT_IMPL, // ERR_NOT_IMPL of handle_arp()
+    DROP_ARP_NOTFORME, // ERR_NOTFORME of handle_arp()
+    DROP_IPV4_INV, // ERR_INV_PKT of the IPv4 stack
+    DROP_IPV4_NOTFORME, // ERR_NOTFORME of the IPv4 stack
+    DROP_IPV4_TTL_EXP, // ERR_TTL_EXP of the IPv4 stack
+    DROP_IPV4_NO_ROUTE, // ERR_NO_ROUTE: FIB miss
+    DROP_TX_NO_INTF, // Egress interface not handled by this router
+    DROP_TX_FULL, // TX queue stayed full after all retries
+    DROP_SLOW_FULL, // Ring to the slow path full
+    DROP_NEIGH_FULL, // Pending queue or neighbor table full
+    DROP_NEIGH_FAILED, // Next hop did not answer the ARP requests
+    DROP_IPV6_INV, // ERR_INV_PKT of the IPv6 stack or NDP
+    DROP_IPV6_NOTFORME, // ERR_NOTFORME of NDP
+    DROP_IPV6_HOP_EXP, // Hop limit expired
+    DROP_IPV6_NO_ROUTE, // IPv6 FIB miss
+    NO_DROP_REASONS
+} drop_reason_t;
+
+typedef struct port_stats {
+    uint64_t rx_pkts;
+    uint64_t rx_bytes;
+    uint64_t tx_pkts; // Frames handed to the NIC
+    uint64_t tx_bytes;
+} port_stats_t;
+
+typedef struct lcore_stats {
+    uint64_t drops[NO_DROP_REASONS];
+    uint64_t arp_replies;
+    uint64_t icmp_errors; // ICMP errors sent
+    uint64_t icmp_limited; // ICMP errors suppressed by the rate limits
+    uint64_t busy_cycles; // Polls that received frames
+    uint64_t idle_cycles; // Empty polls and sleeps
+    port_stats_t ports[RTE_MAX_ETHPORTS]; // Ingress and egress interfaces
+} __rte_cache_aligned lcore_stats_t;
+
+/**********************************
+ *     Function declarations      *
+ **********************************/
+void sum_stats(lcore_stats_t *sum);
+void report_stats(FILE *out);
+const char *get_drop_name(drop_reason_t reason);
+
+/**********************************
+ *   Global field declarations    *
+ **********************************/
+extern lcore_stats_t lcore_stats[RTE_MAX_LCORE];
+
+/**********************************
+ *  Inline function definitions   *
+ **********************************/
+/**
+ * \brief Get the drop reason of an error of a protocol stack.
+ *
+ * \param err The ERR_* code returned by the stack.
+ * \param inv The reason used for ERR_INV_PKT and unknown codes.
+ *              DROP_ARP_INV or DROP_IPV4_INV.
+ *
+ * \return The drop reason.
+ */
+static inline drop_reason_t get_drop_reason(int err, drop_reason_t inv)
+{
+    switch(err) {
+    case ERR_NOT_IMPL:
+        return DROP_ARP_NOT_IMPL;
+    case ERR_NOTFORME:
+        return inv == DROP_ARP_INV ? DROP_ARP_NOTFORME : DROP_IPV4_NOTFORME;
+    case ERR_TTL_EXP:
+        return DROP_IPV4_TTL_EXP;
+    case ERR_NO_ROUTE:
+        return DROP_IPV4_NO_ROUTE;
+    default:
+        return inv;
+    }
+}
+
+#endif
@@ -0,0 +1,328 @@
+/*
+ * Benchmark of the routing table: build time, memory and lookup throughput.
+ *
+ * Usage: table-test-bench [<EAL options> --] [-r <no_routes>] [-n <lookups>]
+ *                         [-e <engines>] [-d <distributions>] [-s <streams>]
+ *
+ * Without EAL options, DPDK runs without huge pages on two lcores.
+ * Every result is printed as one CSV line to stdout. Diagnostics of the
+ * routing table are printed as well -> Filter the lines starting with
+ * "bench,".
+ */
+extern "C" {
+#include "../global.h"
+#include "../router.h"
+#include "../routing_table.h"
+#include "../routing_table_additional.h"
+#include <rte_eal.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ZIPF_POOL_SIZE (1 << 16)
+#define ZIPF_EXPONENT 1.0
+
+enum lookup_mode { SCALAR, BULK };
+
+struct lookup_job {
+	const std::vector<uint32_t> *ips;
+	enum lookup_mode mode;
+	volatile bool start;
+	uint64_t cycles[RTE_MAX_LCORE];
+	uint32_t sink[RTE_MAX_LCORE];
+};
+
+static std::vector<std::string> split(const char *list) {
+	std::vector<std::string> items;
+	std::string s(list);
+	size_t pos = 0, next = 0;
+
+	while ((next = s.find(',', pos)) != std::string::npos) {
+		items.push_back(s.substr(pos, next - pos));
+		pos = next + 1;
+	}
+	items.push_back(s.substr(pos));
+	return items;
+}
+
+static uint32_t rand32(void) {
+	return (uint32_t) rand() << 16 ^ (uint32_t) rand();
+}
+
+/*
+ * Prefix length distributions:
+ *  - uniform: /8 to /32 with the same probability
+ *  - internet: mostly /24, a few shorter and longer prefixes (BGP table)
+ *  - long: mostly /25 to /32, e.g. a data center table with host routes
+ */
+static bool add_routes(const std::string &dist, uint32_t n,
+		std::vector<uint32_t> &nets) {
+	struct ether_addr mac;
+	uint8_t prf = 0;
+	int r = 0;
+
+	nets.clear();
+	for (uint32_t i = 0; i < n; ++i) {
+		r = rand() % 100;
+		if (dist == "uniform")
+			prf = 8 + rand() % 25;
+		else if (dist == "internet")
+			prf = r < 60 ? 24 : r < 98 ? 12 + rand() % 12 : r < 99 ? 8 + rand() % 4 : 25 + rand() % 8;
+		else if (dist == "long")
+			prf = r < 80 ? 25 + rand() % 8 : 16 + rand() % 9;
+		else
+			return false;
+
+		nets.push_back(rand32() & ~0U << (32 - prf));
+		memset(&mac, i % 250, sizeof(mac));
+		add_route(nets.back(), prf, &mac, i % 4);
+	}
+	return true;
+}
+
+/*
+ * Destination streams:
+ *  - random: uniformly distributed addresses
+ *  - sequential: consecutive addresses starting in a random route
+ *  - zipf: addresses in the routes with Zipf distributed popularity
+ */
+static bool make_stream(const std::string &stream, uint32_t n,
+		const std::vector<uint32_t> &nets, std::vector<uint32_t> &ips) {
+	ips.resize(n);
+
+	if (stream == "random") {
+		for (uint32_t i = 0; i < n; ++i)
+			ips[i] = rand32();
+	} else if (stream == "sequential") {
+		uint32_t base = nets[rand() % nets.size()];
+		for (uint32_t i = 0; i < n; ++i)
+			ips[i] = base + i;
+	} else if (stream == "zipf") {
+		std::vector<uint32_t> pool(ZIPF_POOL_SIZE);
+		std::vector<double> cdf(ZIPF_POOL_SIZE);
+		double sum = 0;
+
+		for (uint32_t i = 0; i < ZIPF_POOL_SIZE; ++i) {
+			pool[i] = nets[rand() % nets.size()] | (rand() & 0xFF);
+			sum += 1.0 / pow(i + 1, ZIPF_EXPONENT);
+			cdf[i] = sum;
+		}
+		for (uint32_t i = 0; i < n; ++i) {
+			double u = (double) rand() / RAND_MAX * sum;
+			ips[i] = pool[std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()];
+		}
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static int run_lookups(void *arg) {
+	struct lookup_job *job = (struct lookup_job *) arg;
+	const std::vector<uint32_t> &ips = *job->ips;
+	const uint32_t n = ips.size() / THREAD_BUFSIZE * THREAD_BUFSIZE;
+	const unsigned lcore = rte_lcore_id();
+	uint32_t hop_ids[THREAD_BUFSIZE], sink = 0;
+	const dir24_8_t *fib = get_local_fib();
+	uint64_t start = 0;
+
+	while (!job->start)
+		rte_pause();
+
+	start = rte_rdtsc();
+	if (job->mode == SCALAR) {
+		// get_next_hop() without its diagnostics
+		for (uint32_t i = 0; i < n; ++i) {
+			rt_entry_t *info = get_hop_info(fib, get_next_hop_id(fib, ips[i]));
+			sink += info == NULL ? 0 : info->dst_port;
+		}
+	} else {
+		// Bursts as read by the workers
+		for (uint32_t i = 0; i < n; i += THREAD_BUFSIZE) {
+			lookup_bulk(fib, &ips[i], hop_ids, THREAD_BUFSIZE);
+			sink += hop_ids[0];
+		}
+	}
+	job->cycles[lcore] = rte_rdtsc() - start;
+	job->sink[lcore] = sink;
+	return 0;
+}
+
+/*
+ * Run the lookups of a stream on the master lcore only or on all lcores.
+ * Prints a CSV line: ns per lookup of one lcore and lookups per second of
+ * all lcores together.
+ */
+static void bench_lookups(const std::string &prefix, const std::string &stream,
+		const std::vector<uint32_t> &ips, enum lookup_mode mode, bool all_lcores) {
+	static struct lookup_job job;
+	const uint32_t n = ips.size() / THREAD_BUFSIZE * THREAD_BUFSIZE;
+	uint64_t max_cycles = 0, sum_cycles = 0;
+	unsigned lcore = 0, no_lcores = 1;
+
+	memset(&job, 0, sizeof(job));
+	job.ips = &ips;
+	job.mode = mode;
+
+	if (all_lcores) {
+		RTE_LCORE_FOREACH_SLAVE(lcore) {
+			if (rte_eal_remote_launch(run_lookups, &job, lcore) == 0)
+				++no_lcores;
+		}
+	}
+	job.start = true;
+	run_lookups(&job);
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH(lcore) {
+		max_cycles = RTE_MAX(max_cycles, job.cycles[lcore]);
+		sum_cycles += job.cycles[lcore];
+	}
+
+	double hz = rte_get_tsc_hz();
+	printf("%s,%s,%s,%u,%.2f,%.0f\n", prefix.c_str(), stream.c_str(),
+		mode == SCALAR ? "scalar" : "bulk", no_lcores,
+		sum_cycles / hz * 1e9 / ((double) n * no_lcores),
+		(double) n * no_lcores / (max_cycles / hz));
+}
+
+static long get_rss(void) {
+	long pages = 0, rss = 0;
+	FILE *file = fopen("/proc/self/statm", "r");
+
+	if (file == NULL)
+		return -1;
+	if (fscanf(file, "%ld %ld", &pages, &rss) != 2)
+		rss = -1;
+	fclose(file);
+	return rss < 0 ? -1 : rss * sysconf(_SC_PAGESIZE);
+}
+
+static void print_usage(const char *prg) {
+	printf("Usage: %s [<EAL options> --] [-r <no_routes>] [-n <lookups>] "
+		"[-e <engines>] [-d <distributions>] [-s <streams>]\n"
+		"\t-r: Number of routes (default: 200000)\n"
+		"\t-n: Lookups per lcore and run (default: 4194304)\n"
+		"\t-e: Lookup engines (default: dir24-8,dxr,poptrie,lpm)\n"
+		"\t-d: Prefix length distributions (default: uniform,internet,long)\n"
+		"\t-s: Destination streams (default: random,sequential,zipf)\n"
+		"Output: bench,<distribution>,<engine>,<routes>,<build_ms>,"
+		"<fib_bytes>,<rss_bytes>,<stream>,<mode>,<lcores>,<ns_per_lookup>,"
+		"<lookups_per_s>\n", prg);
+}
+
+int main(int argc, char *argv[]) {
+	// Two lcores -> Single and multi-threaded lookups
+	char *eal_defaults[] = {argv[0], (char *) "--lcores=0@0,1@0", (char *) "-n1",
+		(char *) "--no-huge", (char *) "-m", (char *) "1024",
+		(char *) "--no-pci", NULL};
+	const char *engines = "dir24-8,dxr,poptrie,lpm";
+	const char *dists = "uniform,internet,long";
+	const char *streams = "random,sequential,zipf";
+	uint32_t no_routes = 200000, no_lookups = 1 << 22;
+	std::vector<uint32_t> nets, ips;
+	int ret = 0, opt = 0;
+
+	// EAL options are separated by "--"
+	bool eal_given = false;
+	for (int i = 1; i < argc; ++i)
+		eal_given |= strcmp(argv[i], "--") == 0;
+	if (eal_given) {
+		if ((ret = rte_eal_init(argc, argv)) < 0)
+			return 1;
+		argc -= ret;
+		argv += ret;
+	} else if (rte_eal_init(sizeof(eal_defaults) / sizeof(eal_defaults[0]) - 1,
+			eal_defaults) < 0) {
+		printf("Cannot initialize DPDK\n");
+		return 1;
+	}
+
+	optind = 1;
+	while ((opt = getopt(argc, argv, "r:n:e:d:s:h")) != -1) {
+		switch (opt) {
+		case 'r':
+			no_routes = strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			no_lookups = strtoul(optarg, NULL, 10);
+			break;
+		case 'e':
+			engines = optarg;
+			break;
+		case 'd':
+			dists = optarg;
+			break;
+		case 's':
+			streams = optarg;
+			break;
+		default:
+			print_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (no_routes == 0 || no_lookups < THREAD_BUFSIZE) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	printf("bench,distribution,engine,routes,build_ms,fib_bytes,rss_bytes,"
+		"stream,mode,lcores,ns_per_lookup,lookups_per_s\n");
+	for (const std::string &dist : split(dists)) {
+		srand(42);
+		clean_routing_table();
+		clean_tmp_routing_table();
+		if (!add_routes(dist, no_routes, nets)) {
+			printf("Unknown distribution %s!\n", dist.c_str());
+			return 1;
+		}
+
+		for (const std::string &engine : split(engines)) {
+			if (set_fib_engine(engine.c_str()) < 0) {
+				printf("Unknown engine %s!\n", engine.c_str());
+				return 1;
+			}
+			auto start = std::chrono::steady_clock::now();
+			if (update_routing_table() < 0) {
+				printf("Cannot build the %s routing table!\n", engine.c_str());
+				continue;
+			}
+			auto build = std::chrono::steady_clock::now() - start;
+
+			char prefix[256];
+			snprintf(prefix, sizeof(prefix), "bench,%s,%s,%u,%.1f,%zu,%ld",
+				dist.c_str(), engine.c_str(), get_no_routes(),
+				std::chrono::duration<double, std::milli>(build).count(),
+				get_fib_memory(get_local_fib()), get_rss());
+
+			for (const std::string &stream : split(streams)) {
+				if (!make_stream(stream, no_lookups, nets, ips)) {
+					printf("Unknown stream %s!\n", stream.c_str());
+					return 1;
+				}
+				for (enum lookup_mode mode : {SCALAR, BULK}) {
+					bench_lookups(prefix, stream, ips, mode, false);
+					if (rte_lcore_count() > 1)
+						bench_lookups(prefix, stream, ips, mode, true);
+				}
+			}
+		}
+	}
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	return 0;
+}
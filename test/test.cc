@@ -1,13 +1,39 @@
 #include <limits.h>
 #include <gtest/gtest.h>
 extern "C" {
+#include "../global.h"
 #include "../router.h"
 #include "../routing_table.h"
+#include "../routing_table_additional.h"
+#include "../log.h"
+#include "../stats.h"
+#include "../placement.h"
+#include "../neigh.h"
+#include "../slow_path.h"
+#include "../icmp_stack.h"
+#include "../fib6.h"
+#include "../ipv6_stack.h"
+#include "../ndp_stack.h"
+#include "../dpdk_init.h"
+#include "../bench.h"
+#include "../pcap_file.h"
+#include <rte_arp.h>
+#include <rte_icmp.h>
+#include <rte_ip.h>
+#include <netinet/ip_icmp.h>
+#include <netinet/icmp6.h>
+#include <rte_eal.h>
 }
 
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include <arpa/inet.h>
 #include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 struct ether_addr port_id_to_mac[4];
@@ -57,7 +83,1347 @@ TEST(VERY_SIMPLE_TEST, SIMPLE_ADDRESSES) {
 	EXPECT_EQ(NULL, get_next_hop(IPv4(10,0,11,0)));
 }
 
+TEST(BULK_LOOKUP, MATCHES_SCALAR) {
+	const uint32_t no_lookups = 1 << 22;
+	std::vector<uint32_t> ips(no_lookups);
+	std::vector<uint32_t> scalar_ids(no_lookups), bulk_ids(no_lookups);
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	srand(42);
+
+	// Mix of short prefixes and prefixes handled by TBLlong
+	std::vector<uint32_t> long_nets;
+	for (int i = 0; i < 2000; ++i) {
+		uint32_t net = (uint32_t) rand() << 1 ^ rand();
+		uint8_t prf = (i % 4 == 0) ? 25 + rand() % 8 : 8 + rand() % 17;
+		if (prf > 24)
+			long_nets.push_back(net);
+		memset(&mac, i % 100, sizeof(mac));
+		add_route(net, prf, &mac, i % 4);
+	}
+	build_routing_table();
+	ASSERT_TRUE(get_local_fib() != NULL);
+
+	// Half of the addresses hit /24s containing TBLlong routes
+	for (uint32_t i = 0; i < no_lookups; ++i) {
+		ips[i] = (uint32_t) rand() << 1 ^ rand();
+		if (i % 2)
+			ips[i] = (long_nets[rand() % long_nets.size()] & ~0xFF) | (ips[i] & 0xFF);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < no_lookups; ++i)
+		scalar_ids[i] = get_next_hop_id(get_local_fib(), ips[i]);
+	auto scalar = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	get_next_hop_bulk(ips.data(), bulk_ids.data(), no_lookups);
+	auto bulk = std::chrono::steady_clock::now() - start;
+
+	for (uint32_t i = 0; i < no_lookups; ++i)
+		ASSERT_EQ(scalar_ids[i], bulk_ids[i]) << "lookup of " << ips[i] << " failed";
+
+	// Groups and the scalar tail of get_next_hop_bulk
+	get_next_hop_x4(ips.data(), bulk_ids.data());
+	for (int i = 0; i < 4; ++i)
+		EXPECT_EQ(scalar_ids[i], bulk_ids[i]);
+	get_next_hop_bulk(ips.data(), bulk_ids.data(), 13);
+	for (int i = 0; i < 13; ++i)
+		EXPECT_EQ(scalar_ids[i], bulk_ids[i]);
+
+	printf("scalar lookup: %.2f ns/lookup, bulk lookup: %.2f ns/lookup\n",
+		std::chrono::duration<double, std::nano>(scalar).count() / no_lookups,
+		std::chrono::duration<double, std::nano>(bulk).count() / no_lookups);
+
+	// The 32 bit entries need twice (TBL24) and four times (TBLlong) the
+	// memory of the former 16/8 bit entries
+	const dir24_8_t *fib = get_local_fib();
+	printf("32 bit entries: %.1f MB, 16/8 bit entries would use: %.1f MB "
+		"(%u TBLlong groups)\n",
+		get_fib_memory(fib) / 1048576.0,
+		(TBL24_NO_ENTRIES * 2 + fib->no_tbllong_entries * 256
+			+ fib->no_nxt_hops * sizeof(rt_entry_t)) / 1048576.0,
+		fib->no_tbllong_entries);
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(RUNTIME_UPDATE, ADD_DEL_REPLACE) {
+	clean_routing_table();
+	clean_tmp_routing_table();
+	for (int i = 0; i < 4; ++i)
+		memset(&port_id_to_mac[i], i * 10, sizeof(struct ether_addr));
+
+	add_route(IPv4(10,0,0,0), 8, &port_id_to_mac[0], 0);
+	ASSERT_EQ(0, update_routing_table());
+	const dir24_8_t *old_fib = get_local_fib();
+	check_address(10, 1, 2, 3, 0);
+	EXPECT_EQ(NULL, get_next_hop(IPv4(11,0,0,1)));
+
+	// Add routes while the old table is still in place
+	add_route(IPv4(10,1,2,0), 24, &port_id_to_mac[1], 1);
+	add_route(IPv4(10,1,2,3), 32, &port_id_to_mac[2], 2);
+	check_address(10, 1, 2, 3, 0);
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_NE(old_fib, get_local_fib());
+	check_address(10, 1, 2, 3, 2);
+	check_address(10, 1, 2, 4, 1);
+	check_address(10, 1, 3, 4, 0);
+
+	// Same network and prefix -> Replace the next hop
+	add_route(IPv4(10,1,2,0), 24, &port_id_to_mac[3], 3);
+	ASSERT_EQ(0, update_routing_table());
+	check_address(10, 1, 2, 4, 3);
+
+	// Delete the more specific routes again
+	EXPECT_EQ(0, del_route(IPv4(10,1,2,3), 32));
+	EXPECT_EQ(0, del_route(IPv4(10,1,2,0), 24));
+	EXPECT_EQ(ERR_NO_ROUTE, del_route(IPv4(10,1,2,0), 24));
+	ASSERT_EQ(0, update_routing_table());
+	check_address(10, 1, 2, 3, 0);
+	check_address(10, 1, 2, 4, 0);
+
+	EXPECT_EQ(ERR_NO_ROUTE, del_route(IPv4(11,0,0,0), 8));
+
+	clean_routing_table();
+	EXPECT_EQ(NULL, get_local_fib());
+	EXPECT_EQ(NULL, get_next_hop(IPv4(10,1,2,3)));
+	clean_tmp_routing_table();
+}
+
+// Snapshot of the forwarding decisions for a set of addresses
+static std::vector<int> forwarding_decisions(const std::vector<uint32_t> &ips) {
+	std::vector<int> decisions(ips.size());
+	const dir24_8_t *fib = get_local_fib();
+
+	for (size_t i = 0; i < ips.size(); ++i) {
+		rt_entry_t *info = get_hop_info(fib, get_next_hop_id(fib, ips[i]));
+		decisions[i] = info == NULL ? -1 :
+			info->dst_port << 8 | info->dst_mac.addr_bytes[0];
+	}
+	return decisions;
+}
+
+// The adjacency of every next hop holds its MAC and interface
+static void expect_adjs_match(void) {
+	const dir24_8_t *fib = get_local_fib();
+	const struct ether_addr zero = {{0}};
+
+	ASSERT_NE((const dir24_8_t *) NULL, fib);
+	EXPECT_EQ(NULL, get_adj(fib, 0));
+	for (uint32_t hop_id = 1; hop_id < fib->no_nxt_hops; ++hop_id) {
+		const adj_t *adj = get_adj(fib, hop_id);
+		const rt_entry_t *entry = get_hop_info(fib, hop_id);
+
+		EXPECT_EQ(0, memcmp(&entry->dst_mac, adj->l2, ETHER_ADDR_LEN));
+		// No DPDK ports -> No source MAC
+		EXPECT_EQ(0, memcmp(&zero, adj->l2 + ETHER_ADDR_LEN, ETHER_ADDR_LEN));
+		EXPECT_EQ(entry->dst_port, adj->intf);
+	}
+}
+
+TEST(INCREMENTAL_UPDATE, MATCHES_REBUILD) {
+	const int no_routes = 4000;
+	std::vector<uint32_t> nets(no_routes), ips;
+	std::vector<uint8_t> prfs(no_routes);
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	ASSERT_EQ(0, update_routing_table());
+	srand(7);
+
+	// Nested prefixes of all lengths in a few /8s, inserted in random order
+	for (int i = 0; i < no_routes; ++i) {
+		nets[i] = (10 + rand() % 4) << 24 | (rand() % 8) << 16 | rand() % 0xFFFF;
+		prfs[i] = i % 50 == 0 ? rand() % 9 : 8 + rand() % 25;
+		for (int j = 0; j < 8; ++j)
+			ips.push_back(nets[i] ^ (rand() % 0x3FF));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < no_routes; ++i) {
+		memset(&mac, i % 50, sizeof(mac));
+		ASSERT_EQ(0, fib_add_route(nets[i], prfs[i], &mac, i % 4));
+	}
+	auto add = std::chrono::steady_clock::now() - start;
+
+	std::vector<int> incremental = forwarding_decisions(ips);
+	expect_adjs_match();
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_EQ(incremental, forwarding_decisions(ips));
+	expect_adjs_match();
+
+	// Delete every second route from the rebuilt table
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < no_routes; i += 2)
+		fib_del_route(nets[i], prfs[i]);
+	auto del = std::chrono::steady_clock::now() - start;
+
+	incremental = forwarding_decisions(ips);
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_EQ(incremental, forwarding_decisions(ips));
+
+	printf("incremental add: %.2f us/route, delete: %.2f us/route\n",
+		std::chrono::duration<double, std::micro>(add).count() / no_routes,
+		std::chrono::duration<double, std::micro>(del).count() * 2 / no_routes);
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(INCREMENTAL_UPDATE, RECYCLES_TBLLONG) {
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	memset(&mac, 1, sizeof(mac));
+	add_route(IPv4(10,0,0,0), 8, &mac, 1);
+	ASSERT_EQ(0, update_routing_table());
+
+	// Every /32 requires its own TBLlong group -> More than TBLlong can hold
+	// without recycling the groups
+	memset(&mac, 2, sizeof(mac));
+	for (uint32_t i = 0; i < 2 * TBLlong_INIT_ENTRIES; ++i) {
+		uint32_t ip = IPv4(10,0,0,1) + (i << 8);
+		ASSERT_EQ(0, fib_add_route(ip, 32, &mac, 2)) << i;
+		EXPECT_EQ(2, get_next_hop(ip)->dst_port);
+		EXPECT_EQ(1, get_next_hop(ip + 1)->dst_port);
+		ASSERT_EQ(0, fib_del_route(ip, 32));
+		EXPECT_EQ(1, get_next_hop(ip)->dst_port);
+		EXPECT_EQ(0, get_local_fib()->tbl24[ip >> 8].indicator);
+	}
+	EXPECT_EQ(ERR_NO_ROUTE, fib_del_route(IPv4(10,0,0,1), 32));
+	EXPECT_EQ((uint) TBLlong_INIT_ENTRIES, get_local_fib()->tbllong_capacity);
+
+	// Removing the covering route leaves no route behind
+	ASSERT_EQ(0, fib_del_route(IPv4(10,0,0,0), 8));
+	EXPECT_EQ(NULL, get_next_hop(IPv4(10,1,2,3)));
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(FIB_FORMAT, WIDE_ENTRIES) {
+	const uint32_t no_hops = 1000, no_groups = 65536 + 1000;
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	ASSERT_EQ(0, update_routing_table());
+
+	// More next hops than 8 bit IDs can address
+	memset(&mac, 0, sizeof(mac));
+	for (uint32_t i = 0; i < no_hops; ++i) {
+		mac.addr_bytes[0] = i >> 8;
+		mac.addr_bytes[1] = i;
+		ASSERT_EQ(0, fib_add_route(IPv4(10,0,0,0) + (i << 8), 24, &mac, i % 4));
+	}
+
+	// More TBLlong groups than 15 bit indices can address
+	memset(&mac, 0xFF, sizeof(mac));
+	for (uint32_t i = 0; i < no_groups; ++i)
+		ASSERT_EQ(0, fib_add_route(IPv4(20,0,0,1) + (i << 8), 32, &mac, 1)) << i;
+	EXPECT_EQ(no_groups, get_local_fib()->no_tbllong_entries);
+	EXPECT_EQ(no_hops + 2, get_local_fib()->no_nxt_hops);
+
+	for (uint32_t i = 0; i < no_hops; ++i) {
+		rt_entry_t *info = get_next_hop(IPv4(10,0,0,7) + (i << 8));
+		ASSERT_TRUE(info != NULL);
+		EXPECT_EQ(i % 4, info->dst_port);
+		EXPECT_EQ((uint8_t) i, info->dst_mac.addr_bytes[1]);
+	}
+	for (uint32_t i = 0; i < no_groups; i += 97) {
+		ASSERT_TRUE(get_next_hop(IPv4(20,0,0,1) + (i << 8)) != NULL) << i;
+		EXPECT_EQ(NULL, get_next_hop(IPv4(20,0,0,2) + (i << 8)));
+	}
+
+	// The rebuilt table must look the same
+	std::vector<uint32_t> ips;
+	for (uint32_t i = 0; i < no_groups; i += 13)
+		ips.push_back(IPv4(20,0,0,1) + (i << 8));
+	for (uint32_t i = 0; i < no_hops; ++i)
+		ips.push_back(IPv4(10,0,0,1) + (i << 8));
+	std::vector<int> incremental = forwarding_decisions(ips);
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_EQ(incremental, forwarding_decisions(ips));
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(LOADER, FULL_TABLE) {
+	const uint32_t no_routes = 300000, no_lookups = 20000;
+	std::map<std::pair<uint32_t, int>, int> routes;
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	srand(11);
+
+	// Prefix length distribution of a BGP table: mostly /24, a few longer
+	std::vector<uint32_t> nets(no_routes);
+	std::vector<uint8_t> prfs(no_routes);
+	for (uint32_t i = 0; i < no_routes; ++i) {
+		int r = rand() % 100;
+		prfs[i] = r < 60 ? 24 : r < 98 ? 12 + rand() % 12 : r < 99 ? rand() % 12 : 25 + rand() % 8;
+		nets[i] = ((uint32_t) rand() << 1 ^ rand()) & (prfs[i] ? ~0U << (32 - prfs[i]) : 0);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < no_routes; ++i) {
+		memset(&mac, 0, sizeof(mac));
+		mac.addr_bytes[0] = i % 3000 >> 8;
+		mac.addr_bytes[1] = i % 3000;
+		add_route(nets[i], prfs[i], &mac, i % 4);
+	}
+	auto load = std::chrono::steady_clock::now() - start;
+	for (uint32_t i = 0; i < no_routes; ++i)
+		routes[std::make_pair(nets[i], (int) prfs[i])] = i % 3000 << 8 | i % 4;
+	EXPECT_EQ(routes.size(), get_no_routes());
+
+	start = std::chrono::steady_clock::now();
+	build_routing_table();
+	auto build = std::chrono::steady_clock::now() - start;
+	ASSERT_TRUE(get_local_fib() != NULL);
+
+	printf("%u routes: load %.1f ms, build %.1f ms on %u lcores\n",
+		get_no_routes(),
+		std::chrono::duration<double, std::milli>(load).count(),
+		std::chrono::duration<double, std::milli>(build).count(),
+		rte_lcore_count());
+
+	// Compare with the longest matching route
+	for (uint32_t i = 0; i < no_lookups; ++i) {
+		uint32_t ip = i % 2 ? (uint32_t) rand() << 1 ^ rand() : nets[rand() % no_routes] | rand() % 64;
+		int expected = -1;
+		for (int prf = 32; prf >= 0 && expected < 0; --prf) {
+			auto it = routes.find(std::make_pair(prf ? ip & ~0U << (32 - prf) : 0, prf));
+			if (it != routes.end())
+				expected = it->second;
+		}
+
+		rt_entry_t *info = get_next_hop(ip);
+		ASSERT_EQ(expected < 0, info == NULL) << ip;
+		if (info != NULL) {
+			ASSERT_EQ(expected, info->dst_mac.addr_bytes[0] << 16
+				| info->dst_mac.addr_bytes[1] << 8 | info->dst_port) << ip;
+		}
+	}
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(LOADER, REJECTS_LONG_PREFIX) {
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	memset(&mac, 0, sizeof(mac));
+
+	// Longer prefixes would index past the counting sort of the build
+	EXPECT_EQ(ERR_FORMAT, add_route(IPv4(10,0,0,0), 33, &mac, 0));
+	EXPECT_EQ(ERR_FORMAT, add_route(IPv4(10,0,0,0), 255, &mac, 0));
+	EXPECT_EQ(0u, get_no_routes());
+	EXPECT_EQ(0, add_route(IPv4(10,0,0,1), 32, &mac, 0));
+	EXPECT_EQ(1u, get_no_routes());
+
+	build_routing_table();
+	EXPECT_TRUE(get_next_hop(IPv4(10,0,0,1)) != NULL);
+	EXPECT_EQ(NULL, get_next_hop(IPv4(10,0,0,0)));
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(SNAPSHOT, SAVE_LOAD) {
+	const int no_routes = 20000;
+	const char *path = "/tmp/table-test.snapshot";
+	std::vector<uint32_t> nets(no_routes), ips;
+	std::vector<uint8_t> prfs(no_routes);
+	struct ether_addr mac;
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+	srand(13);
+
+	for (int i = 0; i < no_routes; ++i) {
+		prfs[i] = i % 20 == 0 ? 25 + rand() % 8 : 8 + rand() % 17;
+		nets[i] = ((uint32_t) rand() << 1 ^ rand()) & ~0U << (32 - prfs[i]);
+		memset(&mac, i % 200, sizeof(mac));
+		add_route(nets[i], prfs[i], &mac, i % 4);
+		for (int j = 0; j < 4; ++j)
+			ips.push_back(nets[i] | rand() % 0x3FF);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(0, update_routing_table());
+	auto build = std::chrono::steady_clock::now() - start;
+	std::vector<int> built = forwarding_decisions(ips);
+	ASSERT_EQ(0, save_routing_table(path));
+	unsigned int routes = get_no_routes();
+
+	// Restore the table and the routes from the snapshot alone
+	clean_routing_table();
+	clean_tmp_routing_table();
+	start = std::chrono::steady_clock::now();
+	ASSERT_EQ(0, load_routing_table(path));
+	auto load = std::chrono::steady_clock::now() - start;
+	EXPECT_EQ(built, forwarding_decisions(ips));
+	EXPECT_EQ(routes, get_no_routes());
+
+	printf("%u routes: build %.1f ms, load snapshot %.1f ms\n", routes,
+		std::chrono::duration<double, std::milli>(build).count(),
+		std::chrono::duration<double, std::milli>(load).count());
+
+	// The restored table accepts incremental updates
+	EXPECT_EQ(0, fib_del_route(nets[1], prfs[1]));
+	EXPECT_EQ(routes - 1, get_no_routes());
+	memset(&mac, 1, sizeof(mac));
+	EXPECT_EQ(0, fib_add_route(nets[1], prfs[1], &mac, 1));
+
+	// Configured routes must match the snapshot
+	clean_routing_table();
+	ASSERT_EQ(0, load_routing_table(path));
+	EXPECT_EQ(built, forwarding_decisions(ips));
+	clean_routing_table();
+	add_route(IPv4(1,2,3,0), 24, &mac, 1);
+	EXPECT_EQ(ERR_MISMATCH, load_routing_table(path));
+	EXPECT_EQ(NULL, get_local_fib());
+	clean_tmp_routing_table();
+
+	// Corrupted and truncated snapshots are refused
+	FILE *f = fopen(path, "r+b");
+	ASSERT_TRUE(f != NULL);
+	fseek(f, 4096, SEEK_SET);
+	int c = fgetc(f);
+	fseek(f, 4096, SEEK_SET);
+	fputc(c ^ 0xFF, f);
+	fclose(f);
+	EXPECT_EQ(ERR_FORMAT, load_routing_table(path));
+
+	ASSERT_EQ(0, truncate(path, 1000));
+	EXPECT_EQ(ERR_FORMAT, load_routing_table(path));
+	EXPECT_EQ(NULL, get_local_fib());
+	EXPECT_EQ(ERR_GEN, load_routing_table("/nonexistent/table.snapshot"));
+
+	unlink(path);
+	clean_tmp_routing_table();
+}
+
+// Prefixes of a routing table dump, one a.b.c.d/prf per line
+static void read_prefixes(const char *path, std::vector<uint32_t> &nets,
+		std::vector<uint8_t> &prfs) {
+	unsigned int a, b, c, d, prf;
+	char line[128];
+	FILE *file = fopen(path, "r");
+
+	ASSERT_TRUE(file != NULL) << path;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (sscanf(line, "%u.%u.%u.%u/%u", &a, &b, &c, &d, &prf) != 5 || prf > 32)
+			continue;
+		nets.push_back(IPv4(a, b, c, d) & (prf ? ~0U << (32 - prf) : 0));
+		prfs.push_back(prf);
+	}
+	fclose(file);
+}
+
+TEST(FIB_ENGINES, MATCH_DIR24_8) {
+	const uint32_t no_routes = 100000, no_lookups = 1 << 20, burst = 64;
+	const char *engines[] = { "dir24-8", "dxr", "poptrie", "lpm" };
+	const char *prefix_file = getenv("FIB_PREFIXES");
+	std::vector<uint32_t> nets, ips(no_lookups), hop_ids(no_lookups);
+	std::vector<uint8_t> prfs;
+	std::vector<int> expected;
+	struct ether_addr mac;
+
+	EXPECT_EQ(ERR_FORMAT, set_fib_engine("unknown"));
+	clean_routing_table();
+	clean_tmp_routing_table();
+	srand(17);
+
+	// A real prefix set if given, BGP-like prefixes otherwise
+	if (prefix_file != NULL) {
+		read_prefixes(prefix_file, nets, prfs);
+	} else {
+		for (uint32_t i = 0; i < no_routes; ++i) {
+			int r = rand() % 100;
+			uint8_t prf = r < 60 ? 24 : r < 97 ? 12 + rand() % 12 : r < 98 ? rand() % 12 : 25 + rand() % 8;
+			nets.push_back(((uint32_t) rand() << 1 ^ rand()) & (prf ? ~0U << (32 - prf) : 0));
+			prfs.push_back(prf);
+		}
+		nets.push_back(0);
+		prfs.push_back(0);
+	}
+	for (size_t i = 0; i < nets.size(); ++i) {
+		memset(&mac, i % 250, sizeof(mac));
+		add_route(nets[i], prfs[i], &mac, i % 4);
+	}
+
+	// Mixed destinations: half of them random, half of them in the routes
+	for (uint32_t i = 0; i < no_lookups; ++i)
+		ips[i] = i % 2 ? (uint32_t) rand() << 1 ^ rand() : nets[rand() % nets.size()] | rand() % 0x3FF;
+
+	for (const char *engine : engines) {
+		ASSERT_EQ(0, set_fib_engine(engine));
+		auto start = std::chrono::steady_clock::now();
+		ASSERT_EQ(0, update_routing_table()) << engine;
+		auto build = std::chrono::steady_clock::now() - start;
+		const dir24_8_t *fib = get_local_fib();
+
+		std::vector<int> decisions = forwarding_decisions(ips);
+		if (expected.empty())
+			expected = decisions;
+		EXPECT_EQ(expected, decisions) << engine;
+
+		// Bursts as read by the workers
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < no_lookups; i += burst)
+			lookup_bulk(fib, &ips[i], &hop_ids[i], burst);
+		auto lookup = std::chrono::steady_clock::now() - start;
+		for (uint32_t i = 0; i < no_lookups; ++i)
+			ASSERT_EQ(get_next_hop_id(fib, ips[i]), hop_ids[i]) << engine << " " << ips[i];
+
+		printf("%zu routes, %-8s build %7.1f ms, memory %9.1f KB, %6.1f Mlookups/s\n",
+			nets.size(), engine,
+			std::chrono::duration<double, std::milli>(build).count(),
+			get_fib_memory(fib) / 1024.0,
+			no_lookups / std::chrono::duration<double, std::micro>(lookup).count());
+	}
+
+	// Route updates rebuild the tables of the other engines
+	ASSERT_EQ(0, set_fib_engine("poptrie"));
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_EQ(ERR_GEN, save_routing_table("/tmp/table-test.snapshot"));
+	memset(&mac, 1, sizeof(mac));
+	EXPECT_EQ(0, fib_add_route(IPv4(10,1,2,0), 23, &mac, 1));
+	EXPECT_EQ(0, fib_del_route(nets[0], prfs[0]));
+	EXPECT_EQ(ERR_NO_ROUTE, fib_del_route(nets[0], prfs[0]));
+	std::vector<int> updated = forwarding_decisions(ips);
+	ASSERT_EQ(0, set_fib_engine("dir24-8"));
+	ASSERT_EQ(0, update_routing_table());
+	EXPECT_EQ(updated, forwarding_decisions(ips));
+
+	clean_routing_table();
+	clean_tmp_routing_table();
+}
+
+TEST(TRACE, RING_ORDER_AND_DROPS) {
+	FILE *out = tmpfile();
+	char line[256];
+	uint32_t i = 0;
+
+	ASSERT_NE((FILE *) NULL, out);
+	drain_traces(out);
+	rewind(out);
+
+	trace_event(TRC_IPV4_NO_ROUTE, IPv4(10,0,0,1), 0, 0);
+	trace_event(TRC_IPV4_TOTAL_LEN, 16, 20, 0);
+	ASSERT_EQ(2U, drain_traces(out));
+	rewind(out);
+	ASSERT_NE((char *) NULL, fgets(line, sizeof(line), out));
+	EXPECT_NE((char *) NULL, strstr(line, "ip address: 10.0.0.1"));
+	ASSERT_NE((char *) NULL, fgets(line, sizeof(line), out));
+	EXPECT_NE((char *) NULL, strstr(line, "Total length 16 is smaller than IHL 20"));
+
+	// A full ring drops the newest records
+	fclose(out);
+	out = tmpfile();
+	ASSERT_NE((FILE *) NULL, out);
+	for (i = 0; i < TRACE_RING_SIZE + 10; ++i)
+		trace_event(TRC_IPV4_SHORT, i, 0, 0);
+	EXPECT_EQ((uint32_t) TRACE_RING_SIZE, drain_traces(out));
+	fflush(out);
+	rewind(out);
+	for (i = 0; i < TRACE_RING_SIZE; ++i)
+		ASSERT_NE((char *) NULL, fgets(line, sizeof(line), out));
+	ASSERT_NE((char *) NULL, fgets(line, sizeof(line), out));
+	EXPECT_NE((char *) NULL, strstr(line, "Dropped 10 trace records"));
+	EXPECT_EQ(0U, drain_traces(out));
+
+	fclose(out);
+}
+
+TEST(STATS, SUM_AND_REPORT) {
+	lcore_stats_t sum;
+	FILE *out = tmpfile();
+	char report[1024];
+	size_t len = 0;
+
+	ASSERT_NE((FILE *) NULL, out);
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	report_stats(out); // Start of the interval
+
+	lcore_stats[1].ports[3].rx_pkts = 10;
+	lcore_stats[1].ports[3].rx_bytes = 640;
+	lcore_stats[2].ports[3].rx_pkts = 5;
+	lcore_stats[2].ports[0].tx_pkts = 7;
+	lcore_stats[1].drops[DROP_IPV4_NO_ROUTE] = 3;
+	lcore_stats[2].drops[DROP_IPV4_NO_ROUTE] = 4;
+	lcore_stats[2].drops[DROP_TX_FULL] = 1;
+	lcore_stats[1].busy_cycles = 300;
+	lcore_stats[1].idle_cycles = 700;
+	lcore_stats[2].idle_cycles = 1000;
+	sum_stats(&sum);
+	EXPECT_EQ(15U, sum.ports[3].rx_pkts);
+	EXPECT_EQ(640U, sum.ports[3].rx_bytes);
+	EXPECT_EQ(7U, sum.ports[0].tx_pkts);
+	EXPECT_EQ(7U, sum.drops[DROP_IPV4_NO_ROUTE]);
+	EXPECT_EQ(1U, sum.drops[DROP_TX_FULL]);
+	EXPECT_STREQ("ipv4_no_route", get_drop_name(DROP_IPV4_NO_ROUTE));
+
+	// Only interfaces and drop reasons with traffic are reported
+	report_stats(out);
+	rewind(out);
+	len = fread(report, 1, sizeof(report) - 1, out);
+	report[len] = '\0';
+	EXPECT_NE((char *) NULL, strstr(report, "Interface 0:"));
+	EXPECT_NE((char *) NULL, strstr(report, "Interface 3:"));
+	EXPECT_EQ((char *) NULL, strstr(report, "Interface 1:"));
+	EXPECT_NE((char *) NULL, strstr(report, "ipv4_no_route"));
+	EXPECT_NE((char *) NULL, strstr(report, "tx_full"));
+	EXPECT_EQ((char *) NULL, strstr(report, "ipv4_ttl_expired"));
+	// Idle lcores are not reported
+	EXPECT_NE((char *) NULL, strstr(report, "Busy lcores 1: 30.0%\n"));
+
+	// Nothing happened -> Nothing is reported
+	report_stats(out);
+	EXPECT_EQ((long) len, ftell(out));
+
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	fclose(out);
+}
+
+TEST(PLACEMENT, CPU_SETS) {
+	uint16_t cpus[8];
+	char map[128];
+
+	ASSERT_EQ(4, parse_cpu_set("2,4-6", cpus, 8));
+	EXPECT_EQ(std::vector<uint16_t>({2, 4, 5, 6}), std::vector<uint16_t>(cpus, cpus + 4));
+	ASSERT_EQ(3, parse_cpu_set("0x31", cpus, 8));
+	EXPECT_EQ(std::vector<uint16_t>({0, 4, 5}), std::vector<uint16_t>(cpus, cpus + 3));
+	EXPECT_EQ(ERR_FORMAT, parse_cpu_set("3-1", cpus, 8));
+	EXPECT_EQ(ERR_FORMAT, parse_cpu_set("1,1", cpus, 8));
+	EXPECT_EQ(ERR_FORMAT, parse_cpu_set("1,", cpus, 8));
+	EXPECT_EQ(ERR_FORMAT, parse_cpu_set("0-8", cpus, 8));
+	EXPECT_EQ(ERR_FORMAT, parse_cpu_set("0xg", cpus, 8));
+
+	// The master gets the first CPU, the workers the others round robin
+	ASSERT_EQ(3, parse_cpu_set("2,4,5", cpus, 8));
+	ASSERT_EQ(0, build_lcore_map(map, sizeof(map), cpus, 3, 3));
+	EXPECT_STREQ("--lcores=0@2,1@4,2@5,3@4", map);
+	ASSERT_EQ(0, build_lcore_map(map, sizeof(map), cpus, 1, 2));
+	EXPECT_STREQ("--lcores=0@2,1@2,2@2", map);
+	EXPECT_EQ(ERR_MEM, build_lcore_map(map, 16, cpus, 3, 3));
+}
+
+static struct rte_mbuf *slow_test_arp(struct rte_mempool *pool, uint16_t op, uint32_t sip, uint32_t tip,
+		const struct ether_addr *sha) {
+	struct rte_mbuf *m = rte_pktmbuf_alloc(pool);
+	struct ether_hdr *eth = (struct ether_hdr *) rte_pktmbuf_append(m, ETHER_HDR_LEN + sizeof(struct arp_hdr));
+	struct arp_hdr *arp = (struct arp_hdr *) (eth + 1);
+
+	memset(eth, 0, ETHER_HDR_LEN + sizeof(struct arp_hdr));
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_ARP);
+	arp->arp_hrd = rte_cpu_to_be_16(ARP_HRD_ETHER);
+	arp->arp_pro = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	arp->arp_hln = ETHER_ADDR_LEN;
+	arp->arp_pln = 4;
+	arp->arp_op = rte_cpu_to_be_16(op);
+	arp->arp_data.arp_sip = rte_cpu_to_be_32(sip);
+	arp->arp_data.arp_tip = rte_cpu_to_be_32(tip);
+	ether_addr_copy(sha, &arp->arp_data.arp_sha);
+	return m;
+}
+
+TEST(SLOW_PATH, NEIGH_AND_ARP) {
+	const uint32_t ip = IPv4(10,0,0,1), own_ip = IPv4(10,0,0,254);
+	struct ether_addr mac, hop_mac, learned = {{0x52, 0x54, 0, 0xcb, 0xee, 0xf4}};
+	intf_cfg_t worker;
+	rt_entry_t entry;
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("slow_test", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct rte_mbuf *m = NULL;
+
+	// Next hops given by IP are stored as multicast MAC
+	get_neigh_hop_mac(&hop_mac, ip);
+	ether_addr_copy(&hop_mac, &entry.dst_mac);
+	EXPECT_TRUE(is_neigh_hop(&entry));
+	EXPECT_EQ(ip, get_neigh_hop_ip(&entry));
+	ether_addr_copy(&learned, &entry.dst_mac);
+	EXPECT_FALSE(is_neigh_hop(&entry));
+
+	// No DPDK ports -> The slow path has no TX queues and counts sent frames as tx_no_intf
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, add_intf_cfg(1, rte_cpu_to_be_32(own_ip)));
+	ASSERT_EQ(0, init_neigh());
+	ASSERT_EQ(0, init_slow_path());
+	ASSERT_EQ(0, setup_slow_path(rte_lcore_id(), 0, 0));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	memset(&worker, 0, sizeof(worker));
+	worker.lcore = rte_lcore_id();
+
+	// The first packets are queued, the others dropped
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(1, ip, &mac));
+	for (int i = 0; i < NEIGH_QUEUE_LEN + 2; ++i) {
+		m = rte_pktmbuf_alloc(pool);
+		rte_pktmbuf_append(m, ETHER_HDR_LEN);
+		defer_to_slow(&worker, m, SLOW_NEIGH, 1, ip);
+	}
+	serve_slow_path();
+	EXPECT_EQ(1U, get_no_neighs());
+	EXPECT_EQ(2U, lcore_stats[worker.lcore].drops[DROP_NEIGH_FULL]);
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(1, ip, &mac));
+
+	// Replies of unknown neighbors are ignored, requests for us are answered
+	defer_to_slow(&worker, slow_test_arp(pool, ARP_OP_REPLY, IPv4(10,0,0,2), own_ip, &learned), SLOW_ARP, 1, 0);
+	defer_to_slow(&worker, slow_test_arp(pool, ARP_OP_REQUEST, IPv4(10,0,0,3), own_ip, &learned), SLOW_ARP, 1, 0);
+	defer_to_slow(&worker, slow_test_arp(pool, ARP_OP_REQUEST, IPv4(10,0,0,3), IPv4(10,0,0,4), &learned), SLOW_ARP, 1, 0);
+	// The reply resolves the neighbor and sends the queued packets
+	defer_to_slow(&worker, slow_test_arp(pool, ARP_OP_REPLY, ip, own_ip, &learned), SLOW_ARP, 1, 0);
+	serve_slow_path();
+	EXPECT_EQ(1U, get_no_neighs());
+	EXPECT_EQ(1U, lcore_stats[worker.lcore].arp_replies);
+	EXPECT_EQ(1U, lcore_stats[worker.lcore].drops[DROP_ARP_NOTFORME]);
+	// Queued packets, the ARP request and the ARP reply
+	EXPECT_EQ((uint64_t) NEIGH_QUEUE_LEN + 2, lcore_stats[worker.lcore].drops[DROP_TX_NO_INTF]);
+	ASSERT_EQ(0, neigh_lookup(1, ip, &mac));
+	EXPECT_TRUE(is_same_ether_addr(&learned, &mac));
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(0, ip, &mac));
+
+	// A lookup racing with the removal may find the entry reused for another neighbor
+	neigh_key_t key = { .ip_cpu_bo = ip, .intf = 1, .pad = { 0 } };
+	int32_t pos = rte_hash_lookup(neigh_hash, &key);
+	ASSERT_LE(0, pos);
+	neighs[pos].key.ip_cpu_bo = ip + 1;
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(1, ip, &mac));
+	neighs[pos].key = key;
+	EXPECT_EQ(0, neigh_lookup(1, ip, &mac));
+
+	free_slow_path();
+	free_neigh();
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(1, ip, &mac));
+	// Every buffer is back in the pool
+	EXPECT_EQ(63U, rte_mempool_avail_count(pool));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	rte_mempool_free(pool);
+}
+
+TEST(SLOW_PATH, PADDED_ARP) {
+	const uint32_t ip = IPv4(10,5,0,1), own_ip = IPv4(10,5,0,254);
+	const uint16_t pad = ETHER_MIN_LEN - ETHER_CRC_LEN - ETHER_HDR_LEN - sizeof(struct arp_hdr);
+	struct ether_addr mac, learned = {{0x52, 0x54, 0, 0x12, 0x34, 0x56}};
+	intf_cfg_t worker;
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("padded_arp", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct rte_mbuf *m = NULL;
+
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, add_intf_cfg(5, rte_cpu_to_be_32(own_ip)));
+	ASSERT_EQ(0, init_neigh());
+	ASSERT_EQ(0, init_slow_path());
+	ASSERT_EQ(0, setup_slow_path(rte_lcore_id(), 0, 0));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	memset(&worker, 0, sizeof(worker));
+	worker.lcore = rte_lcore_id();
+
+	// A queued packet makes the neighbor pending
+	EXPECT_EQ(ERR_NO_ROUTE, neigh_lookup(5, ip, &mac));
+	m = rte_pktmbuf_alloc(pool);
+	rte_pktmbuf_append(m, ETHER_HDR_LEN);
+	defer_to_slow(&worker, m, SLOW_NEIGH, 5, ip);
+	serve_slow_path();
+
+	// Senders pad ARP to the minimum frame size of 60 bytes
+	m = slow_test_arp(pool, ARP_OP_REPLY, ip, own_ip, &learned);
+	memset(rte_pktmbuf_append(m, pad), 0, pad);
+	EXPECT_EQ(60U, rte_pktmbuf_data_len(m));
+	defer_to_slow(&worker, m, SLOW_ARP, 5, 0);
+	serve_slow_path();
+	EXPECT_EQ(0U, lcore_stats[worker.lcore].drops[DROP_ARP_INV]);
+	EXPECT_EQ(0, neigh_lookup(5, ip, &mac));
+	EXPECT_TRUE(is_same_ether_addr(&learned, &mac));
+
+	// A truncated packet is still invalid
+	m = slow_test_arp(pool, ARP_OP_REPLY, ip, own_ip, &learned);
+	rte_pktmbuf_trim(m, 1);
+	defer_to_slow(&worker, m, SLOW_ARP, 5, 0);
+	serve_slow_path();
+	EXPECT_EQ(1U, lcore_stats[worker.lcore].drops[DROP_ARP_INV]);
+
+	free_slow_path();
+	free_neigh();
+	EXPECT_EQ(63U, rte_mempool_avail_count(pool));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	rte_mempool_free(pool);
+}
+
+static struct rte_mbuf *slow_test_ipv4(struct rte_mempool *pool, uint32_t src, uint8_t proto, uint8_t type) {
+	struct rte_mbuf *m = rte_pktmbuf_alloc(pool);
+	struct ether_hdr *eth = (struct ether_hdr *) rte_pktmbuf_append(m, ETHER_HDR_LEN + 100);
+	struct ipv4_hdr *ip = (struct ipv4_hdr *) (eth + 1);
+
+	memset(eth, 0, ETHER_HDR_LEN + 100);
+	eth->d_addr.addr_bytes[5] = 1;
+	eth->s_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(100);
+	ip->time_to_live = 1;
+	ip->next_proto_id = proto;
+	ip->src_addr = rte_cpu_to_be_32(src);
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10,2,0,1));
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+	((uint8_t *) (ip + 1))[0] = type;
+	return m;
+}
+
+TEST(SLOW_PATH, ICMP_ERRORS) {
+	const uint32_t src = IPv4(10,1,0,1);
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("icmp_test", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct ether_addr d_ether;
+	struct ipv4_hdr orig;
+	intf_cfg_t cfg;
+	struct rte_mbuf *m = NULL;
+	int sent = 0;
+
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, init_icmp_errors());
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.lcore = rte_lcore_id();
+	cfg.ip_addr_be = rte_cpu_to_be_32(IPv4(10,0,0,254));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+
+	// The error quotes the IPv4 header and 8 bytes and goes back to the sender
+	m = slow_test_ipv4(pool, src, IPPROTO_UDP, 0);
+	memcpy(&orig, rte_pktmbuf_mtod_offset(m, void *, ETHER_HDR_LEN), sizeof(orig));
+	ASSERT_EQ(0, build_icmp_error(&cfg, m, ICMP_TIME_EXCEEDED, ICMP_EXC_TTL, &d_ether));
+	struct ipv4_hdr *ip = rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, ETHER_HDR_LEN);
+	struct icmp_hdr *icmp = (struct icmp_hdr *) (ip + 1);
+	EXPECT_EQ(2, d_ether.addr_bytes[5]);
+	EXPECT_EQ(ETHER_HDR_LEN + 2 * sizeof(struct ipv4_hdr) + 2 * 8U, rte_pktmbuf_data_len(m));
+	EXPECT_EQ(rte_cpu_to_be_16(56), ip->total_length);
+	EXPECT_EQ(cfg.ip_addr_be, ip->src_addr);
+	EXPECT_EQ(orig.src_addr, ip->dst_addr);
+	EXPECT_EQ(0xFFFF, rte_raw_cksum(ip, sizeof(*ip)));
+	EXPECT_EQ(0xFFFF, rte_raw_cksum(icmp, 36));
+	EXPECT_EQ(ICMP_TIME_EXCEEDED, icmp->icmp_type);
+	EXPECT_EQ(0, memcmp(&orig, icmp + 1, sizeof(orig)));
+	rte_pktmbuf_free(m);
+
+	// No errors about errors or link layer broadcasts
+	m = slow_test_ipv4(pool, src, IPPROTO_ICMP, ICMP_DEST_UNREACH);
+	EXPECT_EQ(ERR_NOTFORME, send_icmp_error(&cfg, m, ICMP_DEST_UNREACH, ICMP_NET_UNREACH, rte_rdtsc()));
+	rte_pktmbuf_free(m);
+	m = slow_test_ipv4(pool, src, IPPROTO_UDP, 0);
+	memset(rte_pktmbuf_mtod(m, void *), 0xFF, ETHER_ADDR_LEN);
+	EXPECT_EQ(ERR_NOTFORME, send_icmp_error(&cfg, m, ICMP_DEST_UNREACH, ICMP_NET_UNREACH, rte_rdtsc()));
+	rte_pktmbuf_free(m);
+
+	// A source gets its burst, then the others still get errors
+	for (int i = 0; i < ICMP_SRC_BURST + 5; ++i) {
+		m = slow_test_ipv4(pool, src, IPPROTO_UDP, 0);
+		if (send_icmp_error(&cfg, m, ICMP_TIME_EXCEEDED, ICMP_EXC_TTL, rte_rdtsc()) == 0)
+			sent++;
+		else
+			rte_pktmbuf_free(m);
+	}
+	EXPECT_EQ(ICMP_SRC_BURST, sent);
+	m = slow_test_ipv4(pool, IPv4(10,1,0,2), IPPROTO_UDP, 0);
+	EXPECT_EQ(0, send_icmp_error(&cfg, m, ICMP_TIME_EXCEEDED, ICMP_EXC_TTL, rte_rdtsc()));
+	EXPECT_EQ((uint64_t) ICMP_SRC_BURST + 1, lcore_stats[cfg.lcore].icmp_errors);
+	EXPECT_EQ(5U, lcore_stats[cfg.lcore].icmp_limited);
+
+	// No TX queues -> Every error was dropped
+	EXPECT_EQ(63U, rte_mempool_avail_count(pool));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	rte_mempool_free(pool);
+}
+
+TEST(IPV4, RX_OFFLOAD_FLAGS) {
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("offload_test", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct rte_mbuf *m[8];
+	struct ipv4_hdr *ip[8];
+	intf_cfg_t cfg;
+
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, init_slow_path());
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.lcore = rte_lcore_id();
+	cfg.ether_addr.addr_bytes[5] = 1;
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	for (int i = 0; i < 8; ++i) {
+		m[i] = slow_test_ipv4(pool, IPv4(10,1,0,1), IPPROTO_UDP, 0);
+		ip[i] = rte_pktmbuf_mtod_offset(m[i], struct ipv4_hdr *, ETHER_HDR_LEN);
+	}
+
+	// Checked in software: Bad checksum
+	ip[1]->hdr_checksum ^= 0xFFFF;
+	// Trusted verdicts of the NIC
+	ip[2]->hdr_checksum ^= 0xFFFF;
+	m[2]->ol_flags = PKT_RX_IP_CKSUM_GOOD;
+	m[3]->ol_flags = PKT_RX_IP_CKSUM_BAD;
+	// Classified by the NIC -> The ethertype is not read
+	rte_pktmbuf_mtod(m[4], struct ether_hdr *)->ether_type = 0;
+	m[4]->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4;
+	// The software checksum covers the options
+	ip[5]->version_ihl = 0x46;
+	ip[5]->hdr_checksum = 0;
+	ip[5]->hdr_checksum = ~rte_raw_cksum(ip[5], 24);
+	// Padded frames are accepted and trimmed, truncated packets are invalid
+	ip[6]->total_length = rte_cpu_to_be_16(40);
+	ip[7]->total_length = rte_cpu_to_be_16(101);
+	for (int i = 6; i < 8; ++i) {
+		ip[i]->hdr_checksum = 0;
+		ip[i]->hdr_checksum = rte_ipv4_cksum(ip[i]);
+	}
+
+	// All valid packets take the slow path because their TTL expires
+	handle_frames(&cfg, m, 8);
+	EXPECT_EQ(5U, rte_ring_count(slow_rings[cfg.lcore]));
+	EXPECT_EQ(3U, lcore_stats[cfg.lcore].drops[DROP_IPV4_INV]);
+	EXPECT_EQ(ETHER_HDR_LEN + 40, rte_pktmbuf_data_len(m[6]));
+	EXPECT_EQ(ETHER_HDR_LEN + 100, rte_pktmbuf_data_len(m[0]));
+
+	free_slow_path();
+	EXPECT_EQ(63U, rte_mempool_avail_count(pool));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	rte_mempool_free(pool);
+}
+
+// Prefixes of an IPv6 routing table dump, one address/prf per line
+static void read_prefixes6(const char *path, std::vector<std::vector<uint8_t> > &nets,
+		std::vector<uint8_t> &prfs) {
+	char line[128], *slash = NULL;
+	uint8_t net[IPV6_ADDR_LEN];
+	unsigned int prf;
+	FILE *file = fopen(path, "r");
+
+	ASSERT_TRUE(file != NULL) << path;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if ((slash = strchr(line, '/')) == NULL || sscanf(slash + 1, "%u", &prf) != 1 || prf > 128)
+			continue;
+		*slash = '\0';
+		if (inet_pton(AF_INET6, line, net) != 1)
+			continue;
+		nets.push_back(std::vector<uint8_t>(net, net + IPV6_ADDR_LEN));
+		prfs.push_back(prf);
+	}
+	fclose(file);
+}
+
+TEST(FIB6, MATCHES_SINGLE_LOOKUPS) {
+	const uint32_t no_routes = 20000, no_lookups = 1 << 20, burst = 64;
+	const char *prefix_file = getenv("FIB6_PREFIXES");
+	std::vector<std::vector<uint8_t> > nets;
+	std::vector<uint8_t> prfs;
+	std::vector<int32_t> hop_ids(no_lookups);
+	uint8_t (*ips)[IPV6_ADDR_LEN] = new uint8_t[no_lookups][IPV6_ADDR_LEN];
+	uint8_t net[IPV6_ADDR_LEN] = { 0 };
+	struct ether_addr mac = {{ 0x02, 0, 0, 0, 0, 0 }};
+	uint32_t hop_id = 0;
+
+	srand(23);
+	// No routes -> Every lookup misses
+	ASSERT_EQ(0, build_fib6(SOCKET_ID_ANY));
+	fib6_lookup_bulk(ips, &hop_ids[0], 1);
+	EXPECT_EQ(-1, hop_ids[0]);
+	EXPECT_EQ(ERR_FORMAT, fib6_add_route(net, 129, &mac, 0));
+
+	// A real prefix set if given, BGP-like prefixes in 2000::/3 otherwise:
+	// Mostly /48 of a few thousand /32 allocations
+	if (prefix_file != NULL) {
+		read_prefixes6(prefix_file, nets, prfs);
+	} else {
+		for (uint32_t i = 0; i < no_routes; ++i) {
+			int r = rand() % 100;
+			uint8_t prf = r < 70 ? 48 : r < 80 ? 32 : r < 90 ? 44 : 40;
+			uint32_t alloc = 0x20000000 | (rand() % 4000) << 8;
+			for (int b = 0; b < IPV6_ADDR_LEN; ++b)
+				net[b] = b < 4 ? alloc >> (24 - 8 * b) : rand();
+			nets.push_back(std::vector<uint8_t>(net, net + IPV6_ADDR_LEN));
+			prfs.push_back(prf);
+		}
+		nets.push_back(std::vector<uint8_t>(IPV6_ADDR_LEN, 0));
+		prfs.push_back(0);
+	}
+	for (size_t i = 0; i < nets.size(); ++i) {
+		mac.addr_bytes[5] = i % 250;
+		ASSERT_EQ(0, fib6_add_route(&nets[i][0], prfs[i], &mac, i % 4));
+	}
+	EXPECT_EQ(nets.size(), get_no_routes6());
+
+	auto start = std::chrono::steady_clock::now();
+	ASSERT_EQ(0, build_fib6(SOCKET_ID_ANY));
+	auto build = std::chrono::steady_clock::now() - start;
+	EXPECT_EQ(ERR_GEN, fib6_add_route(net, 64, &mac, 0));
+
+	// Mixed destinations: half of them random, half of them in the routes
+	for (uint32_t i = 0; i < no_lookups; ++i) {
+		if (i % 2 == 0)
+			memcpy(ips[i], &nets[rand() % nets.size()][0], IPV6_ADDR_LEN);
+		for (int b = i % 2 ? 0 : 8; b < IPV6_ADDR_LEN; ++b)
+			ips[i][b] = rand();
+	}
+
+	// Bursts as read by the workers
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < no_lookups; i += burst)
+		fib6_lookup_bulk(&ips[i], &hop_ids[i], burst);
+	auto lookup = std::chrono::steady_clock::now() - start;
+	for (uint32_t i = 0; i < no_lookups; ++i) {
+		ASSERT_EQ(0, rte_lpm6_lookup(lpm6, ips[i], &hop_id)) << i;
+		ASSERT_EQ((int32_t) hop_id, hop_ids[i]) << i;
+	}
+
+	// The adjacency of a route carries the next hop of its last definition
+	std::map<std::vector<uint8_t>, size_t> last;
+	for (size_t i = 0; i < nets.size(); ++i) {
+		std::vector<uint8_t> key(nets[i]);
+		for (int b = 0; b < IPV6_ADDR_LEN; ++b)
+			key[b] &= prfs[i] >= 8 * (b + 1) ? 0xFF : prfs[i] <= 8 * b ? 0 : 0xFF << (8 * (b + 1) - prfs[i]);
+		key.push_back(prfs[i]);
+		last[key] = i;
+	}
+	for (const auto &route : last) {
+		const adj_t *adj = NULL;
+		size_t i = route.second;
+		if (prfs[i] == 0)
+			continue;
+		ASSERT_EQ(1, rte_lpm6_is_rule_present(lpm6, &nets[i][0], prfs[i], &hop_id));
+		ASSERT_NE((const adj_t *) NULL, adj = get_adj6(hop_id));
+		EXPECT_EQ(i % 250, adj->l2[5]);
+		EXPECT_EQ(i % 4, adj->intf);
+	}
+
+	printf("%zu IPv6 routes, build %7.1f ms, %6.1f Mlookups/s\n", nets.size(),
+		std::chrono::duration<double, std::milli>(build).count(),
+		no_lookups / std::chrono::duration<double, std::micro>(lookup).count());
+
+	clean_fib6();
+	EXPECT_EQ(0U, get_no_routes6());
+	delete[] ips;
+}
+
+static struct rte_mbuf *test_ndp_ns(struct rte_mempool *pool, const struct ether_addr *own) {
+	struct rte_mbuf *m = rte_pktmbuf_alloc(pool);
+	struct ether_hdr *eth = (struct ether_hdr *) rte_pktmbuf_append(m,
+		ETHER_HDR_LEN + IPV6_HDR_LEN + sizeof(struct nd_neighbor_solicit));
+	struct ipv6_hdr *ip = (struct ipv6_hdr *) (eth + 1);
+	struct nd_neighbor_solicit *ns = (struct nd_neighbor_solicit *) (ip + 1);
+
+	memset(eth, 0, ETHER_HDR_LEN + IPV6_HDR_LEN + sizeof(*ns));
+	eth->d_addr = {{ 0x33, 0x33, 0xFF, own->addr_bytes[3], own->addr_bytes[4], own->addr_bytes[5] }};
+	eth->s_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv6);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(sizeof(*ns));
+	ip->proto = IPPROTO_ICMPV6;
+	ip->hop_limits = NDP_HOP_LIMIT;
+	ip->src_addr[0] = 0xFE;
+	ip->src_addr[1] = 0x80;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0xFF;
+	ip->dst_addr[1] = 0x02;
+	ns->nd_ns_type = ND_NEIGHBOR_SOLICIT;
+	get_link_local(own, (uint8_t *) &ns->nd_ns_target);
+	ns->nd_ns_cksum = rte_ipv6_udptcp_cksum(ip, ns);
+	return m;
+}
+
+TEST(IPV6, NDP_AND_FORWARDING) {
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("ipv6_test", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct rte_mbuf *m[3];
+	struct ipv6_hdr *ip = NULL;
+	struct nd_neighbor_advert *na = NULL;
+	intf_cfg_t cfg;
+
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, init_slow_path());
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.lcore = rte_lcore_id();
+	cfg.ether_addr = {{ 0x52, 0x54, 0, 0x12, 0x34, 0x56 }};
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+
+	// Solicitations reach the slow path, expired and unrouted packets are dropped
+	for (int i = 0; i < 3; ++i)
+		m[i] = test_ndp_ns(pool, &cfg.ether_addr);
+	ip = rte_pktmbuf_mtod_offset(m[1], struct ipv6_hdr *, ETHER_HDR_LEN);
+	ip->dst_addr[0] = 0x20;
+	ip->hop_limits = 1;
+	ip = rte_pktmbuf_mtod_offset(m[2], struct ipv6_hdr *, ETHER_HDR_LEN);
+	ip->dst_addr[0] = 0x20;
+	handle_frames(&cfg, m, 3);
+	EXPECT_EQ(1U, rte_ring_count(slow_rings[cfg.lcore]));
+	EXPECT_EQ(1U, lcore_stats[cfg.lcore].drops[DROP_IPV6_HOP_EXP]);
+	EXPECT_EQ(1U, lcore_stats[cfg.lcore].drops[DROP_IPV6_NO_ROUTE]);
+
+	// A packet without payload is padded to the minimum frame size. The
+	// padding is trimmed, a truncated packet is invalid.
+	for (int i = 0; i < 2; ++i) {
+		m[i] = test_ndp_ns(pool, &cfg.ether_addr);
+		rte_pktmbuf_trim(m[i], rte_pktmbuf_data_len(m[i]) - (ETHER_MIN_LEN - ETHER_CRC_LEN));
+		ip = rte_pktmbuf_mtod_offset(m[i], struct ipv6_hdr *, ETHER_HDR_LEN);
+		ip->dst_addr[0] = 0x20;
+		ip->proto = IPPROTO_NONE;
+		ip->payload_len = rte_cpu_to_be_16(i == 0 ? 0 : 7);
+	}
+	rte_mbuf_refcnt_update(m[0], 1);
+	handle_frames(&cfg, m, 2);
+	EXPECT_EQ(2U, lcore_stats[cfg.lcore].drops[DROP_IPV6_NO_ROUTE]);
+	EXPECT_EQ(1U, lcore_stats[cfg.lcore].drops[DROP_IPV6_INV]);
+	EXPECT_EQ(ETHER_HDR_LEN + IPV6_HDR_LEN, rte_pktmbuf_data_len(m[0]));
+	EXPECT_EQ(ETHER_HDR_LEN + IPV6_HDR_LEN, rte_pktmbuf_pkt_len(m[0]));
+	rte_pktmbuf_free(m[0]);
+	free_slow_path();
+
+	// The advertisement reuses the buffer. Keep it to inspect it after the drop.
+	m[0] = test_ndp_ns(pool, &cfg.ether_addr);
+	rte_mbuf_refcnt_update(m[0], 1);
+	ASSERT_EQ(0, handle_ndp(&cfg, m[0]));
+	EXPECT_EQ(1U, lcore_stats[cfg.lcore].drops[DROP_TX_NO_INTF]);
+	ip = rte_pktmbuf_mtod_offset(m[0], struct ipv6_hdr *, ETHER_HDR_LEN);
+	na = (struct nd_neighbor_advert *) (ip + 1);
+	EXPECT_EQ(ETHER_HDR_LEN + IPV6_HDR_LEN + sizeof(*na) + 8, rte_pktmbuf_data_len(m[0]));
+	EXPECT_EQ(ND_NEIGHBOR_ADVERT, na->nd_na_type);
+	EXPECT_EQ(0xFFFF, rte_ipv6_udptcp_cksum(ip, na));
+	EXPECT_EQ(1, ip->dst_addr[15]);
+	EXPECT_EQ(0, memcmp((uint8_t *) (na + 1) + 2, &cfg.ether_addr, ETHER_ADDR_LEN));
+	rte_pktmbuf_free(m[0]);
+
+	// Other targets are ignored, broken solicitations are invalid
+	m[0] = test_ndp_ns(pool, &cfg.ether_addr);
+	m[1] = test_ndp_ns(pool, &cfg.ether_addr);
+	m[2] = test_ndp_ns(pool, &cfg.ether_addr);
+	((struct nd_neighbor_solicit *) rte_pktmbuf_mtod_offset(m[0], struct ipv6_hdr *, ETHER_HDR_LEN + IPV6_HDR_LEN))->nd_ns_cksum ^= 1;
+	ip = rte_pktmbuf_mtod_offset(m[1], struct ipv6_hdr *, ETHER_HDR_LEN);
+	ip->hop_limits = 64;
+	ip = rte_pktmbuf_mtod_offset(m[2], struct ipv6_hdr *, ETHER_HDR_LEN);
+	ip->src_addr[15] = 2;
+	((struct nd_neighbor_solicit *) (ip + 1))->nd_ns_target.s6_addr[15] ^= 1;
+	((struct nd_neighbor_solicit *) (ip + 1))->nd_ns_cksum = 0;
+	((struct nd_neighbor_solicit *) (ip + 1))->nd_ns_cksum = rte_ipv6_udptcp_cksum(ip, ip + 1);
+	EXPECT_EQ(ERR_INV_PKT, handle_ndp(&cfg, m[0]));
+	EXPECT_EQ(ERR_INV_PKT, handle_ndp(&cfg, m[1]));
+	EXPECT_EQ(ERR_NOTFORME, handle_ndp(&cfg, m[2]));
+	for (int i = 0; i < 3; ++i)
+		rte_pktmbuf_free(m[i]);
+
+	EXPECT_EQ(63U, rte_mempool_avail_count(pool));
+	memset(lcore_stats, 0, sizeof(lcore_stats));
+	rte_mempool_free(pool);
+}
+
+TEST(MEMPOOL, SHARED_PER_SOCKET) {
+	struct rte_mempool *pool = NULL;
+	std::vector<struct rte_mbuf *> mbufs;
+	struct rte_mbuf *m = NULL;
+
+	EXPECT_EQ(-1, set_mempool_config(0, "unknown"));
+	ASSERT_EQ(0, set_mempool_config(0, "stack"));
+	EXPECT_EQ((struct rte_mempool *) NULL, get_socket_mempool(0, false));
+
+	// Sized by the reservations, rounded up to 2^n - 1
+	reserve_lcore_mbufs(5000);
+	ASSERT_NE((struct rte_mempool *) NULL, pool = get_socket_mempool(0, true));
+	EXPECT_EQ(pool, get_socket_mempool(0, false));
+	EXPECT_EQ(8191U, pool->size);
+	EXPECT_STREQ("stack", rte_mempool_get_ops(pool->ops_index)->name);
+
+	// Every mbuf can be allocated
+	while ((m = rte_pktmbuf_alloc(pool)) != NULL)
+		mbufs.push_back(m);
+	EXPECT_EQ(pool->size, mbufs.size());
+	EXPECT_EQ(0U, rte_mempool_avail_count(pool));
+	for (struct rte_mbuf *mbuf : mbufs)
+		rte_pktmbuf_free(mbuf);
+	EXPECT_EQ(pool->size, rte_mempool_avail_count(pool));
+
+	free_mempools();
+	EXPECT_EQ((struct rte_mempool *) NULL, get_socket_mempool(0, false));
+	// A fixed size replaces the reservations
+	ASSERT_EQ(0, set_mempool_config(3000, NULL));
+	ASSERT_NE((struct rte_mempool *) NULL, pool = get_socket_mempool(0, true));
+	EXPECT_EQ(4095U, pool->size);
+	EXPECT_STREQ(RTE_MBUF_DEFAULT_MEMPOOL_OPS, rte_mempool_get_ops(pool->ops_index)->name);
+	free_mempools();
+	set_mempool_config(0, NULL);
+}
+
+TEST(BENCH, GENERATE_AND_CHECK) {
+	char bad_pct[] = "invalid=60,arp=50", bad_size[] = "size=10", bad_key[] = "flows";
+	char def[] = "dst=routes,flows=64,size=128,invalid=20,arp=10";
+	const uint32_t own_ip = IPv4(10,0,2,1);
+	struct ether_addr own = {{0x02, 0, 0, 0, 0, 2}}, mac = {{0x52, 0x54, 0, 0, 0, 1}};
+	struct rte_mbuf *m[BENCH_BURST];
+	bench_gen_t gen, other;
+	bench_stats_t stats;
+	uint no_arp = 0, no_valid = 0, no_invalid = 0;
+	uint64_t bytes = 0;
+
+	EXPECT_EQ(ERR_FORMAT, parse_bench(bad_pct));
+	EXPECT_EQ(ERR_FORMAT, parse_bench(bad_size));
+	EXPECT_EQ(ERR_FORMAT, parse_bench(bad_key));
+	EXPECT_FALSE(bench_enabled());
+	ASSERT_EQ(0, parse_bench(def));
+	EXPECT_TRUE(bench_enabled());
+	EXPECT_EQ(4U, get_bench_lcores(2));
+
+	// The destinations are hosts of the routed networks
+	clean_tmp_routing_table();
+	add_route(IPv4(10,9,0,0), 16, &mac, 0);
+	ASSERT_EQ(0, add_intf_cfg(2, rte_cpu_to_be_32(own_ip)));
+	EXPECT_EQ(ERR_CFG, init_bench_gen(&other, 3, 1));
+	ASSERT_EQ(0, init_bench_gen(&gen, 2, 1));
+	ASSERT_NE((struct rte_mempool *) NULL, gen.pool);
+	ASSERT_EQ(BENCH_BURST, generate_frames(&gen, m, BENCH_BURST));
+
+	for (int i = 0; i < BENCH_BURST; ++i) {
+		struct ether_hdr *eth = rte_pktmbuf_mtod(m[i], struct ether_hdr *);
+		struct ipv4_hdr *ip = (struct ipv4_hdr *) (eth + 1);
+		bytes += rte_pktmbuf_data_len(m[i]) + ETHER_CRC_LEN;
+		if (eth->ether_type == rte_cpu_to_be_16(ETHER_TYPE_ARP)) {
+			struct arp_hdr *arp = (struct arp_hdr *) (eth + 1);
+			EXPECT_TRUE(is_broadcast_ether_addr(&eth->d_addr));
+			EXPECT_EQ(rte_cpu_to_be_16(ARP_OP_REQUEST), arp->arp_op);
+			EXPECT_EQ(rte_cpu_to_be_32(own_ip), arp->arp_data.arp_tip);
+			EXPECT_EQ(ETHER_MIN_LEN - ETHER_CRC_LEN, rte_pktmbuf_data_len(m[i]));
+			no_arp++;
+			continue;
+		}
+		ASSERT_EQ(rte_cpu_to_be_16(ETHER_TYPE_IPv4), eth->ether_type);
+		EXPECT_EQ(128 - ETHER_CRC_LEN, rte_pktmbuf_data_len(m[i]));
+		EXPECT_EQ(IPv4(10,9,0,0), rte_be_to_cpu_32(ip->dst_addr) & 0xFFFF0000);
+		EXPECT_EQ(IPv4(198,18,2,1), rte_be_to_cpu_32(ip->src_addr));
+		if (ip->version_ihl == 0x45 && rte_raw_cksum(ip, sizeof(*ip)) == 0xFFFF
+			&& rte_be_to_cpu_16(ip->total_length) == 128 - ETHER_CRC_LEN - ETHER_HDR_LEN) {
+			// Forward the packet like the router
+			ether_addr_copy(&own, &eth->s_addr);
+			ip->time_to_live--;
+			ip->hdr_checksum = 0;
+			ip->hdr_checksum = rte_ipv4_cksum(ip);
+			// The first one leaves with the wrong TTL
+			if (no_valid++ == 0) {
+				ip->time_to_live++;
+				ip->hdr_checksum = 0;
+				ip->hdr_checksum = rte_ipv4_cksum(ip);
+			}
+		} else {
+			no_invalid++;
+		}
+	}
+	EXPECT_GT(no_arp, 0U);
+	EXPECT_GT(no_invalid, 0U);
+	ASSERT_GT(no_valid, 0U);
+
+	// Frames the router did not forward are corrupt as well
+	memset(&stats, 0, sizeof(stats));
+	check_frames(&own, m, BENCH_BURST, &stats);
+	EXPECT_EQ((uint64_t) BENCH_BURST, stats.sink_pkts);
+	EXPECT_EQ(bytes, stats.sink_bytes);
+	EXPECT_EQ(no_valid - 1, stats.sink_valid);
+	EXPECT_EQ(no_invalid + 1, stats.sink_corrupt);
+	EXPECT_EQ(no_arp, stats.sink_other);
+
+	for (int i = 0; i < BENCH_BURST; ++i)
+		rte_pktmbuf_free(m[i]);
+	free_bench();
+	free_mempools();
+	clean_tmp_routing_table();
+}
+
+TEST(PCAP, WRITE_READ) {
+	const char *path = "/tmp/table-test.pcap";
+	struct rte_mempool *pool = rte_pktmbuf_pool_create("pcap_test", 63, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	struct rte_mbuf *m[3];
+	pcap_trace_t trace;
+	FILE *file = NULL;
+	long len = 0;
+
+	// Frames of 60, 100 and 1514 bytes with distinct contents
+	ASSERT_NE((struct rte_mempool *) NULL, pool);
+	ASSERT_EQ(0, rte_pktmbuf_alloc_bulk(pool, m, 3));
+	const uint16_t lens[3] = {60, 100, 1514};
+	for (int i = 0; i < 3; ++i) {
+		uint8_t *data = (uint8_t *) rte_pktmbuf_append(m[i], lens[i]);
+		ASSERT_NE((uint8_t *) NULL, data);
+		for (int j = 0; j < lens[i]; ++j)
+			data[j] = (uint8_t) (i * 7 + j);
+	}
+	ASSERT_NE((FILE *) NULL, file = create_pcap(path));
+	EXPECT_EQ(0, write_pcap(file, m, 3));
+	fclose(file);
+
+	ASSERT_EQ(0, read_pcap(path, 1514, &trace));
+	ASSERT_EQ(3U, trace.no_frames);
+	EXPECT_EQ(0U, trace.no_skipped);
+	EXPECT_EQ(60U + 100 + 1514, trace.bytes);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(lens[i], trace.lens[i]);
+		EXPECT_EQ(0, memcmp(rte_pktmbuf_mtod(m[i], void *), trace.data + trace.offs[i], lens[i]));
+	}
+	free_pcap(&trace);
+
+	// Frames longer than the buffers are skipped
+	ASSERT_EQ(0, read_pcap(path, 1500, &trace));
+	EXPECT_EQ(2U, trace.no_frames);
+	EXPECT_EQ(1U, trace.no_skipped);
+	free_pcap(&trace);
+
+	// Big endian files are read as well
+	file = fopen(path, "r+b");
+	ASSERT_NE((FILE *) NULL, file);
+	uint8_t buf[sizeof(pcap_file_hdr_t) + sizeof(pcap_rec_hdr_t)];
+	ASSERT_EQ(1U, fread(buf, sizeof(buf), 1, file));
+	uint32_t *words = (uint32_t *) buf;
+	for (unsigned i = 0; i < sizeof(buf) / 4; ++i) {
+		if (i != 1 && i != 2) // The 16 bit versions and thiszone
+			words[i] = rte_bswap32(words[i]);
+	}
+	rewind(file);
+	fwrite(buf, sizeof(buf), 1, file);
+	fclose(file);
+	ASSERT_EQ(0, truncate(path, sizeof(buf) + lens[0]));
+	ASSERT_EQ(0, read_pcap(path, 1514, &trace));
+	EXPECT_EQ(1U, trace.no_frames);
+	free_pcap(&trace);
+
+	// Truncated records are errors
+	file = fopen(path, "rb");
+	fseek(file, 0, SEEK_END);
+	len = ftell(file);
+	fclose(file);
+	ASSERT_EQ(0, truncate(path, len - 1));
+	EXPECT_EQ(ERR_FORMAT, read_pcap(path, 1514, &trace));
+	EXPECT_EQ((uint8_t *) NULL, trace.data);
+	EXPECT_EQ(ERR_GEN, read_pcap("/nonexistent/table-test.pcap", 1514, &trace));
+
+	for (int i = 0; i < 3; ++i)
+		rte_pktmbuf_free(m[i]);
+	rte_mempool_free(pool);
+	unlink(path);
+}
+
 int main(int argc, char* argv[]) {
+	// The routing table lives in DPDK memory -> Initialize DPDK without
+	// requiring huge pages or devices
+	// Two lcores -> The routing table is built in parallel
+	char *eal_args[] = {argv[0], (char *) "--lcores=0@0,1@0", (char *) "-n1",
+		(char *) "--no-huge", (char *) "-m", (char *) "512",
+		(char *) "--no-pci", NULL};
+	if (rte_eal_init(sizeof(eal_args) / sizeof(eal_args[0]) - 1, eal_args) < 0) {
+		printf("Cannot initialize DPDK\n");
+		return 1;
+	}
+
 	::testing::InitGoogleTest(&argc, argv);
 	return RUN_ALL_TESTS();
 